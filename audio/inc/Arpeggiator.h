@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    Arpeggiator.h
+
+  ==============================================================================
+*/
+
+#ifndef ARPEGGIATOR_H_INCLUDED
+#define ARPEGGIATOR_H_INCLUDED
+
+#include "JuceHeader.h"
+#include "SynthParams.h"
+#include <array>
+
+//! Arpeggiator Class: turns the held notes of a block into an arpeggio
+/*! While active, incoming note ons and offs only change the set of held notes, which is a
+    sorted array of fixed size, so nothing is allocated on the audio thread. The arpeggio
+    notes are placed on their exact samples, on the host grid while the host plays and
+    starting with the first pressed key otherwise. All other midi messages pass through, as
+    do the note offs of keys that are not held.
+*/
+class Arpeggiator {
+public:
+    static const int maxHeldNotes = 128;    //!< one per midi note
+
+    explicit Arpeggiator(SynthParams &p);
+
+    //! reserves the output buffer, call in prepareToPlay
+    void prepare();
+
+    //! replaces the note messages of the block by the arpeggio, audio thread.
+    /*!
+    @param midiMessages the midi of the block, changed in place
+    @param numSamples length of the block
+    @param sampleRate the current sample rate
+    */
+    void run(MidiBuffer &midiMessages, int numSamples, double sampleRate);
+
+    //! amount of held notes
+    int getNumHeldNotes() const { return numHeld; }
+
+private:
+    //! plays the note offs and arpeggio steps before endSample
+    void advance(MidiBuffer &out, double blockPpq, int endSample, double samplesPerPpq);
+    //! continues with the first step at or after ppq on the host grid
+    void relocate(double ppq);
+
+    void noteOn(int note, int velocity);
+    //! false if the note was not held
+    bool noteOff(int note);
+    void sendNoteOff(MidiBuffer &out, int sample);
+
+    //! note of the index-th step of the arpeggio, -1 if it lies above the midi range
+    /*!
+    @param velocity receives the velocity of the key the note belongs to
+    */
+    int getArpNote(int64 index, uint8 &velocity);
+
+    SynthParams &params;
+
+    std::array<uint8, maxHeldNotes> heldNotes;      //!< held notes in ascending order
+    std::array<uint8, maxHeldNotes> playedNotes;    //!< the same notes in the order they were pressed
+    std::array<uint8, maxHeldNotes> velocities;     //!< velocity per midi note
+    int numHeld;
+
+    MidiBuffer output;      //!< the block being built, copied to the input afterwards
+
+    // timing, all positions in quarter notes
+    double originPpq;       //!< position of step 0
+    double noteOffPpq;      //!< end of the playing note
+    double expectedPpq;     //!< end of the last block
+    float lastSpeed;        //!< note speed of the last block
+    int64 nextStepCount;    //!< steps from originPpq to the next step
+    int64 arpIndex;         //!< position in the arpeggio, restarts when all keys are released
+    int playingNote;        //!< sounding arpeggio note, -1 for none
+    int channel;            //!< midi channel of the last pressed key
+    bool wasActive;
+    bool wasHostPlaying;
+    Random random;
+
+    JUCE_DECLARE_NON_COPYABLE(Arpeggiator)
+};
+
+#endif  // ARPEGGIATOR_H_INCLUDED
@@ -0,0 +1,158 @@
+/*
+  ==============================================================================
+
+    Denormals.h
+
+  ==============================================================================
+*/
+
+#ifndef DENORMALS_H_INCLUDED
+#define DENORMALS_H_INCLUDED
+
+#include "JuceHeader.h"
+#include <atomic>
+#include <array>
+#include <cstring>
+
+#if JUCE_INTEL
+ #include <xmmintrin.h>
+#endif
+
+//! set very small values to zero
+/*! For filter and feedback states at block boundaries, the same threshold as in juce::IIRFilter.
+*/
+static inline void snapToZero(float& f)
+{
+    if (!(f < -1.0e-8f || f > 1.0e-8f)) f = 0.f;
+}
+
+//! ScopedFlushDenormals Class: enables flush-to-zero and denormals-are-zero for its lifetime
+/*! Create one at the beginning of every audio callback. Decaying feedback loops
+    (filters, delay, reverb) otherwise end up with denormal values, which are
+    extremely slow on most CPUs. The previous floating point mode is restored when
+    the object goes out of scope, so the host's own settings are not changed.
+*/
+class ScopedFlushDenormals {
+public:
+    ScopedFlushDenormals()
+    {
+#if JUCE_INTEL
+        previousMode = _mm_getcsr();
+        _mm_setcsr(previousMode | ftzBit | dazBit);
+#elif JUCE_ARM && defined (__aarch64__)
+        asm volatile("mrs %0, fpcr" : "=r"(previousMode));
+        asm volatile("msr fpcr, %0" : : "r"(previousMode | fzBit));
+#endif
+    }
+
+    ~ScopedFlushDenormals()
+    {
+#if JUCE_INTEL
+        _mm_setcsr(previousMode);
+#elif JUCE_ARM && defined (__aarch64__)
+        asm volatile("msr fpcr, %0" : : "r"(previousMode));
+#endif
+    }
+
+private:
+#if JUCE_INTEL
+    static const unsigned int ftzBit = 0x8000;  //!< MXCSR flush to zero
+    static const unsigned int dazBit = 0x0040;  //!< MXCSR denormals are zero
+    unsigned int previousMode;
+#elif JUCE_ARM && defined (__aarch64__)
+    static const uint64 fzBit = 1 << 24;        //!< FPCR flush to zero
+    uint64 previousMode;
+#endif
+
+    JUCE_DECLARE_NON_COPYABLE(ScopedFlushDenormals)
+};
+
+//! NonFiniteSentinel Class: counts NaN, inf and denormal samples per processing stage
+/*! Only active in debug builds, in release builds check() is empty.
+    The checks run inside ScopedFlushDenormals, so denormals found in a stage were written
+    by code the flush mode does not cover, e.g. on a platform without FTZ support.
+    The audio thread only increments atomic counters, the counts are written to the
+    debug log once per second from the message thread and reset afterwards.
+*/
+class NonFiniteSentinel
+#if JUCE_DEBUG
+    : private Timer
+#endif
+{
+public:
+    //! processing stages that are checked
+    enum eStage : int {
+        eVoices = 0,
+        eFx,
+        eMaster,
+        nStages
+    };
+
+    NonFiniteSentinel()
+    {
+#if JUCE_DEBUG
+        for (size_t i = 0; i < nStages; ++i) {
+            nonFinite[i].store(0);
+            denormal[i].store(0);
+        }
+        startTimer(1000);
+#endif
+    }
+
+    ~NonFiniteSentinel()
+    {
+#if JUCE_DEBUG
+        stopTimer();
+#endif
+    }
+
+    //! counts the non finite and the denormal samples in the given range of the buffer
+    void check(eStage stage, const AudioSampleBuffer& buffer, int startSample, int numSamples)
+    {
+#if JUCE_DEBUG
+        int numNonFinite = 0;
+        int numDenormal = 0;
+        for (int c = 0; c < buffer.getNumChannels(); ++c) {
+            const float* data = buffer.getReadPointer(c, startSample);
+            for (int s = 0; s < numSamples; ++s) {
+                // by bit pattern, float compares and fpclassify see denormals as zero under DAZ
+                uint32 bits;
+                std::memcpy(&bits, data + s, sizeof(bits));
+                const uint32 exponent = bits & 0x7f800000;
+                const uint32 mantissa = bits & 0x007fffff;
+                numNonFinite += (exponent == 0x7f800000) ? 1 : 0;
+                numDenormal += (exponent == 0 && mantissa != 0) ? 1 : 0;
+            }
+        }
+        nonFinite[stage].fetch_add(numNonFinite);
+        denormal[stage].fetch_add(numDenormal);
+#else
+        ignoreUnused(stage, buffer, startSample, numSamples);
+#endif
+    }
+
+private:
+#if JUCE_DEBUG
+    void timerCallback() override
+    {
+        static const char* stageNames[] = { "voices", "fx", "master" };
+        for (size_t i = 0; i < nStages; ++i) {
+            const int n = nonFinite[i].exchange(0);
+            if (n > 0) {
+                DBG("NonFiniteSentinel: " << stageNames[i] << ": " << n << " NaN/inf samples");
+            }
+            const int d = denormal[i].exchange(0);
+            if (d > 0) {
+                DBG("NonFiniteSentinel: " << stageNames[i] << ": " << d << " denormal samples");
+            }
+        }
+    }
+
+    std::array<std::atomic<int>, nStages> nonFinite;    //!< NaN or inf samples per stage since the last report
+    std::array<std::atomic<int>, nStages> denormal;     //!< denormal samples per stage since the last report
+#endif
+
+    JUCE_DECLARE_NON_COPYABLE(NonFiniteSentinel)
+};
+
+#endif  // DENORMALS_H_INCLUDED
@@ -50,6 +50,9 @@ public:
 
     float getNextEnvCoeff();
 
+    //! advances the envelope as numSamples calls of getNextEnvCoeff() would, without computing every value
+    void skipSamples(int numSamples);
+
     static float interpolateLog(int c, int t, float k, bool slow); //!< interpolates logarithmically from 1.0 to 0.0f in t samples (with shape control)
 
 private:
@@ -175,4 +178,20 @@ inline float Envelope::getNextEnvCoeff() {
     return envCoeff;
 }
 
+inline void Envelope::skipSamples(int numSamples)
+{
+    if (numSamples <= 0) {
+        return;
+    }
+    // jump to the last skipped sample and compute only that one, it sets the value a release starts from
+    if (releaseCounter > -1) {
+        releaseCounter += numSamples - 1;
+    }
+    else {
+        // the counter stops once the sustain level is reached
+        attackDecayCounter = jmin(attackDecayCounter + numSamples - 1, attackSamples + decaySamples + 1);
+    }
+    getNextEnvCoeff();
+}
+
 #endif  // ENVELOPE_H_INCLUDED
@@ -2,6 +2,7 @@
 
 #include "JuceHeader.h"
 #include "SynthParams.h"
+#include "Denormals.h"
 
 //! \brief multi-mode audio filter code
 class Filter {
@@ -40,19 +41,43 @@ public:
 
     //! \brief apply the filter to a single sample
     /** \param inputSignal audio sample to filter
+     *  \param lpCutoff smoothed lowpass cutoff in Hz
+     *  \param hpCutoff smoothed highpass cutoff in Hz
+     *  \param resonance smoothed resonance
      *  \param modValue cutoff modulation in abstract modulation range (i.e., [-1;1] per modulation source)
      *  \return filtered audio sample
      */
-    float run(float inputSignal, float lcModValue, float hcModValue, float resModValue) {
+    float run(float inputSignal, float lpCutoff, float hpCutoff, float resonance, float lcModValue, float hcModValue, float resModValue) {
         if (filter.passtype.getStep() == eBiquadFilters::eLadder) {
-            return ladderFilter(inputSignal, lcModValue, resModValue);
+            return ladderFilter(inputSignal, lpCutoff, resonance, lcModValue, resModValue);
         } else {
-            return biquadFilter(inputSignal, lcModValue, hcModValue, resModValue);
+            return biquadFilter(inputSignal, lpCutoff, hpCutoff, resonance, lcModValue, hcModValue, resModValue);
         }
     }
 
+    //! \brief set decayed internal states to zero
+    /** Call once per block, keeps the feedback paths out of the denormal range
+     *  on platforms without flush-to-zero.
+     */
+    void flushDenormals()
+    {
+        snapToZero(inputDelay1);
+        snapToZero(inputDelay2);
+        snapToZero(outputDelay1);
+        snapToZero(outputDelay2);
+
+        snapToZero(ladderOut);
+        snapToZero(ladderInDelay);
+        snapToZero(lpOut1);
+        snapToZero(lpOut2);
+        snapToZero(lpOut3);
+        snapToZero(lpOut1Delay);
+        snapToZero(lpOut2Delay);
+        snapToZero(lpOut3Delay);
+    }
+
 protected:
-    float biquadFilter(float inputSignal, float lcModValue, float hcModValue, float resModValue) {
+    float biquadFilter(float inputSignal, float lpCutoff, float hpCutoff, float resonance, float lcModValue, float hcModValue, float resModValue) {
 
         // get mod frequency from active filter type
         float cutoffFreq = 0.f;
@@ -61,16 +86,16 @@ protected:
 
         switch (filter.passtype.getStep()) {
         case eBiquadFilters::eLowpass:
-            cutoffFreq = filter.lpCutoff.get();
+            cutoffFreq = lpCutoff;
             cutoffFreq = Param::bipolarToFreq(lcModValue, cutoffFreq, filter.lpModAmount1.getMax());
             break;
         case eBiquadFilters::eHighpass:
-            cutoffFreq = filter.hpCutoff.get();
+            cutoffFreq = hpCutoff;
             cutoffFreq = Param::bipolarToFreq(hcModValue, cutoffFreq, filter.hpModAmount1.getMax());
             break;
         case eBiquadFilters::eBandpass:
-            lpFreq = Param::bipolarToFreq(lcModValue, filter.lpCutoff.get(), filter.lpModAmount1.getMax());
-            hpFreq = Param::bipolarToFreq(hcModValue, filter.hpCutoff.get(), filter.hpModAmount1.getMax());
+            lpFreq = Param::bipolarToFreq(lcModValue, lpCutoff, filter.lpModAmount1.getMax());
+            hpFreq = Param::bipolarToFreq(hcModValue, hpCutoff, filter.hpModAmount1.getMax());
 
             cutoffFreq = sqrt(lpFreq * hpFreq);
             if (lpFreq < hpFreq)
@@ -89,7 +114,7 @@ protected:
             cutoffFreq = filter.lpCutoff.getMax();
         }
 
-        float currentResonance = pow(10.f, (-(filter.resonance.get() + resModValue * filter.resModAmount1.getMax()) * 2.5f) / 20.f); 
+        float currentResonance = pow(10.f, (-(resonance + resModValue * filter.resModAmount1.getMax()) * 2.5f) / 20.f); 
         
         cutoffFreq /= sampleRate;
 
@@ -170,10 +195,10 @@ protected:
 
     //apply ladder filter to the current Sample in renderNextBlock() - Zavalishin approach
     //naive 1 pole filters wigh a hyperbolic tangent saturator
-    float ladderFilter(float ladderIn, float lcModValue, float resModValue)
+    float ladderFilter(float ladderIn, float lpCutoff, float resonance, float lcModValue, float resModValue)
     {
-        float cutoffFreq = filter.lpCutoff.get(); 
-        float currentResonance = filter.resonance.get() + resModValue * filter.resModAmount1.getMax();
+        float cutoffFreq = lpCutoff;
+        float currentResonance = resonance + resModValue * filter.resModAmount1.getMax();
 
         //Check for  Resonance Clipping
         if (currentResonance < filter.resonance.getMin())
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    FxChain.h
+
+  ==============================================================================
+*/
+
+#ifndef FXCHAIN_H_INCLUDED
+#define FXCHAIN_H_INCLUDED
+
+#include "SynthParams.h"
+#include "FxClipping.h"
+#include "FxDelay.h"
+#include "FxChorus.h"
+#include "LowFidelity.h"
+#include "FxReverb.h"
+#include "FxConvolution.h"
+
+//! FxChain Class: owns all effects and runs them in a user defined order
+/*! The order is read from the fxSlot params once per block. Duplicate slots are ignored
+    and effects missing from the slots are appended, so every effect is processed exactly once.
+    Switching an effect on or off crossfades between the dry and the processed signal.
+    Effects that are switched off, or whose input has been silent for longer than their
+    tail, are not processed at all.
+*/
+class FxChain {
+public:
+    //! FxChain constructor.
+    FxChain(SynthParams &p);
+    //! FxChain destructor.
+    ~FxChain();
+
+    //! fx chain initialization.
+    /*!
+    Initializes the effects and preallocates the buffer needed for bypass crossfades.
+    @param channelsIn the amount of audio channels
+    @param sampleRateIn the current sample rate
+    @param samplesPerBlock expected maximum block size
+    */
+    void init(int channelsIn, double sampleRateIn, int samplesPerBlock);
+
+    //! fx chain rendering.
+    /*!
+    Processes all effects in the current order on the given range of the buffer.
+    @param outputBuffer the buffer to process in place
+    @param startSample first sample to process
+    @param numSamples amount of samples to process
+    */
+    void render(AudioSampleBuffer& outputBuffer, int startSample, int numSamples);
+
+    //! tail length of the activated effects.
+    /*!
+    The effects are in series, so the tails add up.
+    @returns tail length in seconds
+    */
+    double getTailLengthSeconds() const;
+
+    //! starts loading a new impulse response for the convolution effect, not for the audio thread
+    void loadImpulseResponse(const File& file);
+
+private:
+    static const size_t nFx = static_cast<size_t>(eFxSlots::nSteps);
+
+    //! per effect state of the chain
+    struct SlotState {
+        float gain;         //!< current crossfade position, 0 = bypassed, 1 = fully processed
+        int silentSamples;  //!< amount of consecutive silent input samples
+    };
+
+    //! reads the fxSlot params and rebuilds the processing order
+    void updateOrder();
+
+    //! processes one chunk that fits into the crossfade buffer
+    void renderChunk(AudioSampleBuffer& outputBuffer, int startSample, int numSamples);
+
+    //! calls the render method of one effect
+    void renderEffect(eFxSlots fx, AudioSampleBuffer& outputBuffer, int startSample, int numSamples);
+
+    //! clears the internal state of one effect
+    void resetEffect(eFxSlots fx);
+
+    //! @returns true if the activation param of the effect is on
+    bool isActive(eFxSlots fx) const;
+
+    //! @returns tail length of one effect in seconds
+    double getEffectTail(eFxSlots fx) const;
+
+    //! @returns true if all channels are below the silence threshold in the given range
+    static bool isSilent(const AudioSampleBuffer& buffer, int startSample, int numSamples);
+
+    SynthParams &params;        //!< local params reference
+
+    FxDelay delay;              //!< delay effect
+    FxClipping clip;            //!< clipping effect
+    LowFidelity lowFi;          //!< bit reduction effect
+    FxChorus chorus;            //!< chorus effect
+    FxReverb reverb;            //!< reverb effect
+    FxConvolution convolution;  //!< convolution effect
+
+    std::array<ParamStepped<eFxSlots>*, nFx> slotParams; //!< the params holding the order
+    std::array<eFxSlots, nFx> order;                      //!< current processing order
+    std::array<SlotState, nFx> state;                     //!< state for each effect, indexed by eFxSlots
+
+    AudioSampleBuffer dryBuffer;    //!< copy of the input while an effect is crossfading
+    double sampleRate;              //!< current sample rate
+    float fadeStep;                 //!< gain increment per sample for the bypass crossfade
+
+    JUCE_DECLARE_NON_COPYABLE(FxChain)
+};
+
+#endif  // FXCHAIN_H_INCLUDED
@@ -11,6 +11,7 @@ class FxChorus
 public:
     FxChorus(SynthParams &p)
         : params(p)
+        , sampleRate(44100.f)
         , loopPosition(0)
         //, chorDelayLength(.02f)
         //, modulationDepth(.01f)
@@ -22,7 +23,12 @@ public:
     ~FxChorus();
 
     void init(int channelsIn, double sampleRateIn);
-    void render(AudioSampleBuffer& outputBuffer, int startSample);
+    void render(AudioSampleBuffer& outputBuffer, int startSample, int numSamples);
+
+    //! clears the chorus buffer, called when the effect is re-activated
+    void reset();
+    //! longest delay that can still be heard after the input stopped
+    double getTailLengthSeconds() const;
 
 private:
     SynthParams &params;
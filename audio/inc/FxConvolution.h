@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+    FxConvolution.h
+
+  ==============================================================================
+*/
+
+#ifndef FXCONVOLUTION_H_INCLUDED
+#define FXCONVOLUTION_H_INCLUDED
+
+#include "SynthParams.h"
+
+//! FxConvolution Class: Convolution with an impulse response
+/*! Uniformly partitioned overlap-save convolution based on juce::FFT.
+    The first partition of the impulse response is convolved directly in the time domain,
+    so the effect has no latency. The remaining partitions are multiplied with a frequency
+    domain delay line of the input spectra once every partitionSize samples.
+    Left and right are transformed together as real and imaginary part of one complex
+    signal, the impulse response is therefore mono.
+    Loading and transforming the impulse response happens on a background thread. The
+    prepared kernel is handed to the audio thread with an atomic pointer swap, the old
+    kernel is deleted by the loader thread again.
+*/
+class FxConvolution {
+public:
+    static const int partitionSize = 256;               //!< block size of the partitions
+    static const int fftSize = 2 * partitionSize;       //!< size of the overlap-save transforms
+    static const int maxIrSeconds = 5;                  //!< longer impulse responses are truncated
+
+    //! FxConvolution constructor.
+    FxConvolution(SynthParams &p);
+    //! FxConvolution destructor.
+    ~FxConvolution();
+
+    //! convolution initialization.
+    /*!
+    Preallocates all buffers for the longest impulse response at the given sample rate.
+    If an impulse response was loaded for another sample rate it is loaded again.
+    @param channelsIn the amount of audio channels
+    @param sampleRateIn the current sample rate
+    */
+    void init(int channelsIn, double sampleRateIn);
+
+    //! convolution reset.
+    /*!
+    Clears the input history and the frequency domain delay line.
+    */
+    void reset();
+
+    //! convolution rendering.
+    /*!
+    Mixes the convolved signal into the given range of the buffer according to the dry/wet param.
+    The buffer is not changed as long as no impulse response is loaded.
+    @param outputBuffer a reference to the current block
+    @param startSample first sample to process
+    @param numSamples amount of samples to process
+    */
+    void render(AudioSampleBuffer& outputBuffer, int startSample, int numSamples);
+
+    //! convolution tail length.
+    /*!
+    @returns length of the current impulse response in seconds
+    */
+    double getTailLengthSeconds() const;
+
+    //! impulse response loading.
+    /*!
+    Starts loading the given audio file on the background thread. Must not be called from the audio thread.
+    If the file does not exist or cannot be read, the convolution is switched off.
+    @param file audio file readable by the basic JUCE audio formats, File() for none
+    */
+    void loadImpulseResponse(const File& file);
+
+private:
+    //! impulse response prepared for the audio thread, an empty kernel switches the convolution off
+    struct Kernel {
+        Kernel() : sampleRate(0.), length(0), numPartitions(0) {}
+        double sampleRate;                  //!< sample rate the kernel was prepared for
+        int length;                         //!< length of the impulse response in samples, 0 without impulse response
+        int numPartitions;                  //!< amount of transformed partitions after the head
+        HeapBlock<float> head;              //!< first partition, time reversed
+        HeapBlock<FFT::Complex> spectra;    //!< numPartitions spectra of fftSize bins each
+    };
+
+    //! background thread that reads and transforms the impulse response
+    class Loader : public Thread {
+    public:
+        Loader(FxConvolution &o) : Thread("impulse response loader"), owner(o) {}
+        void run() override { owner.prepareKernel(); }
+    private:
+        FxConvolution &owner;
+    };
+
+    //! reads the file and publishes a new kernel, runs on the loader thread
+    void prepareKernel();
+
+    //! takes over a pending kernel, runs on the audio thread
+    void swapKernel();
+
+    //! convolves the last complete input block with all partitions
+    void processPartitions();
+
+    SynthParams &params;                //!< local params reference
+    FFT forwardFFT;                     //!< forward transform of fftSize points
+    FFT inverseFFT;                     //!< inverse transform of fftSize points
+    Loader loader;                      //!< loader thread
+
+    CriticalSection fileLock;           //!< guards file and targetSampleRate
+    File file;                          //!< impulse response to load
+    double targetSampleRate;            //!< sample rate the loader resamples to
+
+    Kernel* current;                    //!< kernel used by the audio thread
+    std::atomic<Kernel*> pending;       //!< kernel waiting to be used by the audio thread
+    std::atomic<Kernel*> retired;       //!< kernel waiting to be deleted by the loader thread
+    std::atomic<float> irSeconds;       //!< length of the current impulse response
+
+    int maxPartitions;                  //!< capacity of the frequency domain delay line
+    int fdlPosition;                    //!< newest spectrum in the delay line
+    int blockPosition;                  //!< position inside the current input block
+    HeapBlock<FFT::Complex> fdl;        //!< frequency domain delay line of input spectra
+    HeapBlock<FFT::Complex> frame;      //!< current overlap-save frame, left = real, right = imaginary
+    HeapBlock<FFT::Complex> spectrum;   //!< accumulated output spectrum
+    HeapBlock<FFT::Complex> inputBlock; //!< the last two input blocks
+    HeapBlock<FFT::Complex> tailBlock;  //!< output of the partitions for the current block
+    HeapBlock<float> history;           //!< input history for the direct head, 2 channels of 2 * partitionSize
+    int historyPosition;                //!< write position in the history
+
+    JUCE_DECLARE_NON_COPYABLE(FxConvolution)
+};
+
+#endif  // FXCONVOLUTION_H_INCLUDED
@@ -12,6 +12,7 @@
 #define FXDELAY_H_INCLUDED
 
 #include "SynthParams.h"
+#include "Denormals.h"
 
 //! FxDelay Class: Delay Effect
 /*! The delay effect adds a delayed signal to the current audiobuffer.
@@ -25,17 +26,23 @@ public:
     //! FxDelay constructor.
     FxDelay(SynthParams &p)
         : params(p)
-        , loopPosition(0)
-        , bpm(120)
-        , divisor(0)
-        , dividend(0)
+        , delayBuffer()
+        , sampleRate(44100.)
+        , channels(2)
+        , writePosition(0)
+        , delaySamples(1.f)
+        , reversePhase(0.f)
+        , maxDelayLength(20000)
+        , bpm(120.)
+        , tempoSlope(0.)
+        , lastPpq(0.)
+        , lastTimeInSamples(0)
         , fLastSample(0.f)
         , fInputDelay1(0.f)
         , fInputDelay2(0.f)
         , fOutputDelay1(0.f)
         , fOutputDelay2(0.f)
-        , delayBuffer()
-        , maxDelayLength(20000)
+        , timeMs(1000.f)
     {}
     //! FxDelay destructor.
     ~FxDelay(){}
@@ -43,12 +50,12 @@ public:
     //! delay rendering.
     /*!
     The public function render can be called to add a delay to a processed audio block.
-    This functions calls calcTime(), to determine the delay length, adds the (filtered)
-    signal to the delay and output buffer and takes care of the current position and
-    direction inside the ring buffer (feedback loop).
+    The delay time for the end of the range is determined by calcTime() and the read head
+    glides there linearly, so tempo ramps and time changes do not produce clicks.
+    The delayed signal is read with linear interpolation from a fixed size ring buffer.
     @param outputBuffer a reference to the current block. the delay gets added to it
-    @param startSample needed for sudden (midi) parameter changes
-    @param numSamplesIn the current block size
+    @param startSample first sample to process, also the offset inside the host block
+    @param numSamplesIn amount of samples to process
     */
     void render(AudioSampleBuffer& outputBuffer, int startSample, int numSamplesIn);
 
@@ -60,13 +67,43 @@ public:
     */
     void init(int channelsIn, double sampleRateIn);
 
+    //! delay reset.
+    /*!
+    Clears the part of the ring buffer that can currently be read and the filter history,
+    so that a re-activated delay does not replay stale material. The read head jumps to
+    the current delay time.
+    */
+    void reset();
+
+    //! delay tail length.
+    /*!
+    Estimates the time until the feedback loop has decayed by 60 dB with the current
+    time and feedback settings. Almost infinite feedback is capped at maxTailSeconds.
+    @returns tail length in seconds
+    */
+    double getTailLengthSeconds() const;
+
+    static const double maxTailSeconds; //!< upper bound for the reported tail
+
 private:
     //! delay time calculation.
     /*!
-    Calcutates the delay time in case of changes
-    of the host tempo or user input.
+    Calculates the delay time from the note length params if synced, otherwise
+    the delay time param is used. The params are never written.
+    @param bpmIn host tempo
+    @returns delay time in ms
+    */
+    float calcTime(double bpmIn) const;
+
+    //! host tempo estimation.
+    /*!
+    Hosts report the tempo at the beginning of the block only. The ppq distance between
+    two blocks gives the average tempo of the previous block, the difference to the
+    reported tempo is the slope of a tempo ramp, which is then followed inside the block.
+    @param endSample offset of the end of the rendered range inside the host block
+    @returns tempo at endSample in bpm
     */
-    void calcTime();
+    double hostTempo(int endSample);
 
     //! delay filter.
     /*!
@@ -75,25 +112,28 @@ private:
     The filter changes can be applied to the feedback while reading: realtime,
     or while writing to the buffer. This "records" changes into the delay.
     @param inputSignal the current input sample
+    @param cutoff smoothed cutoff frequency in Hz
     returns the filtered inputSignal
     */
-    float filter(float inputSignal);
+    float filter(float inputSignal, float cutoff);
 
     SynthParams &params;            //!< local params reference
-    AudioSampleBuffer delayBuffer;  //!< delay audio buffer
+    AudioSampleBuffer delayBuffer;  //!< delay ring buffer
     double sampleRate;              //!< current sammple rate
     int channels;                   //!< channel amount, 2 stereo
-    int loopPosition;               //!< the current loop position
-    int currentDelayLength;         //!< delay length, or delay time in samples
-    int maxDelayLength;             //!< maximum delay length in samples
-    double bpm;                     //!< current beats per minute, temp storage
-    float divisor;                  //!< user set delay time divisor, temp storage
-    float dividend;                 //!< user set delay time dividend, temp storage
+    int writePosition;              //!< the current write position in the ring buffer
+    float delaySamples;             //!< current delay length in samples, glides to the target
+    float reversePhase;             //!< position inside the current reverse segment
+    int maxDelayLength;             //!< maximum delay length in ms
+    double bpm;                     //!< tempo at the end of the last rendered range
+    double tempoSlope;              //!< tempo change per sample of a host tempo ramp
+    double lastPpq;                 //!< ppq position of the last host block
+    int64 lastTimeInSamples;        //!< host time of the last host block
     float fLastSample;              //!< filter sample storage
     float fInputDelay1;             //!< filter sample storage
     float fInputDelay2;             //!< filter sample storage
     float fOutputDelay1;            //!< filter sample storage
     float fOutputDelay2;            //!< filter sample storage
-    eOnOffToggle triplet;           //!< user set triplet mode, on==1 or off==0
+    std::atomic<float> timeMs;      //!< current delay time for the tail calculation
 };
 #endif  // FXDELAY_H_INCLUDED
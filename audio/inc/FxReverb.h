@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    FxReverb.h
+
+  ==============================================================================
+*/
+
+#ifndef FXREVERB_H_INCLUDED
+#define FXREVERB_H_INCLUDED
+
+#include "SynthParams.h"
+#include "Denormals.h"
+
+//! FxReverb Class: Feedback delay network reverb
+/*! Eight delay lines with mutually prime lengths are fed back into each other through
+    a Householder matrix. Every line has a one-pole lowpass in its feedback path for
+    the damping and a gain that is derived from the decay time, so that all lines decay
+    by 60 dB in the same time. The eight lines are processed in two groups of four
+    with SSE where available.
+*/
+class FxReverb {
+public:
+    //! number of delay lines in the network, must be a multiple of 4
+    static const int numLines = 8;
+
+    //! FxReverb constructor.
+    FxReverb(SynthParams &p)
+        : params(p)
+        , sampleRate(44100.)
+        , lineLength(0)
+        , writePosition(0)
+        , predelayPosition(0)
+    {}
+    //! FxReverb destructor.
+    ~FxReverb() {}
+
+    //! reverb initialization.
+    /*!
+    Allocates the delay lines for the largest room size and the maximum predelay.
+    @param channelsIn the amount of audio channels
+    @param sampleRateIn the current sample rate
+    */
+    void init(int channelsIn, double sampleRateIn);
+
+    //! reverb reset.
+    /*!
+    Clears the delay lines, the predelay and the damping filters.
+    */
+    void reset();
+
+    //! reverb rendering.
+    /*!
+    Mixes the reverberated signal into the given range of the buffer according to the dry/wet param.
+    @param outputBuffer a reference to the current block
+    @param startSample first sample to process
+    @param numSamples amount of samples to process
+    */
+    void render(AudioSampleBuffer& outputBuffer, int startSample, int numSamples);
+
+    //! reverb tail length.
+    /*!
+    @returns predelay, longest line and decay time in seconds
+    */
+    double getTailLengthSeconds() const;
+
+private:
+    //! recalculates line lengths and feedback gains from the params
+    /*!
+    @param decaySeconds smoothed decay time
+    */
+    void updateLines(float decaySeconds);
+
+    //! recalculates the feedback gains of the current line lengths
+    /*!
+    @param decaySeconds smoothed decay time
+    */
+    void updateGains(float decaySeconds);
+
+    SynthParams &params;                //!< local params reference
+    double sampleRate;                  //!< current sample rate
+    int lineLength;                     //!< allocated length of each delay line
+    int writePosition;                  //!< common write position of all delay lines
+    int predelayPosition;               //!< write position of the predelay line
+
+    HeapBlock<float> lines;             //!< numLines delay lines of lineLength samples, line after line
+    AudioSampleBuffer predelayBuffer;   //!< mono predelay ring buffer
+    std::array<int, numLines> delay;    //!< current delay of each line in samples
+    std::array<float, numLines> gain;   //!< feedback gain of each line
+    std::array<float, numLines> lowpassState; //!< damping filter state of each line
+
+    JUCE_DECLARE_NON_COPYABLE(FxReverb)
+};
+
+#endif  // FXREVERB_H_INCLUDED
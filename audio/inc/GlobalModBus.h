@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    GlobalModBus.h
+
+  ==============================================================================
+*/
+
+#ifndef GLOBALMODBUS_H_INCLUDED
+#define GLOBALMODBUS_H_INCLUDED
+
+#include "JuceHeader.h"
+#include "SynthParams.h"
+#include <array>
+
+//! GlobalModBus Class: modulation of the effect and master params
+/*! The voices have their own matrix, this bus drives the params that exist once per synth.
+    The global lfos run per sample, they are up to 50 Hz fast and would alias at the block rate.
+    The sequencer lane, the midi controllers and the slot amounts are evaluated once per block
+    and glide linearly from the value of the last block to the new one. The modulated values
+    are applied to the param ramps, so the effects read them without knowing about the bus.
+*/
+class GlobalModBus {
+public:
+    static const size_t nLfos = 2;
+    static const size_t nDestinations = static_cast<size_t>(eGlobalModDest::nSteps);
+
+    explicit GlobalModBus(SynthParams &p);
+
+    //! allocates the modulation buffers.
+    /*!
+    @param sampleRateIn the current sample rate
+    @param maxNumSamples the longest range that will be rendered
+    */
+    void init(double sampleRateIn, int maxNumSamples);
+
+    //! evaluates the block sources and the slots for the next block, audio thread.
+    /*!
+    @param numSamples length of the block
+    */
+    void beginBlock(int numSamples);
+
+    //! renders the lfos and modulates the param ramps of a range, called after the ramps are rendered.
+    /*!
+    @param startSample first sample of the range in the block
+    @param numSamples length of the range
+    */
+    void render(int startSample, int numSamples);
+
+    //! current bipolar output of a global lfo in [-1..1]
+    float getLfoValue(size_t lfo) const { return lfos[lfo].value; }
+
+private:
+    struct GlobalLfo {
+        double phase;   //!< position in the cycle in [0..1)
+        float value;    //!< output at the last rendered sample
+        bool used;      //!< a slot reads it in the current block
+    };
+
+    //! modulation of one destination as the sum of the slot amounts, in [-1..1] before the clipping
+    struct Destination {
+        float start;                        //!< block sources at the start of the block
+        float target;                       //!< block sources at the end of the block
+        std::array<float, nLfos> lfoStart;  //!< amount of each lfo at the start of the block
+        std::array<float, nLfos> lfoTarget; //!< amount of each lfo at the end of the block
+        bool active;                        //!< a slot modulates it, or it still returns to neutral
+    };
+
+    //! advances an unused global lfo over a range without rendering it
+    void advanceLfo(size_t i, int numSamples);
+
+    //! renders a global lfo over a range into lfoBuffer
+    void renderLfo(size_t i, int numSamples);
+
+    //! output of a global lfo at a phase, the held value for sample and hold
+    float getLfoOutput(size_t i, double phase) const;
+
+    //! value of a block source at the end of the block in [-1..1], unipolar sources in [0..1]
+    float getSourceValue(eGlobalModSource source) const;
+
+    //! maps the summed slot amounts to an offset or a factor for the ramp of the destination
+    float toRampValue(eGlobalModDest dest, float mod) const;
+
+    //! value of the destination that leaves its ramp unchanged
+    static float getNeutral(eGlobalModDest dest);
+    static ParamRamp::eMode getMode(eGlobalModDest dest);
+    const Param& getParam(eGlobalModDest dest) const;
+    ParamRamp& getRamp(eGlobalModDest dest);
+
+    SynthParams &params;
+
+    std::array<GlobalLfo, nLfos> lfos;
+    std::array<Destination, nDestinations> destinations;
+    AudioSampleBuffer lfoBuffer;    //!< output of the global lfos in the current range, one channel per lfo
+    AudioSampleBuffer modBuffer;    //!< values of the destination being applied
+    double sampleRate;
+    int blockSize;                  //!< length of the current block
+    Random random;                  //!< sample and hold values
+
+    JUCE_DECLARE_NON_COPYABLE(GlobalModBus)
+};
+
+#endif  // GLOBALMODBUS_H_INCLUDED
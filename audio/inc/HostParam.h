@@ -1,35 +1,128 @@
 #pragma once
 
 #include <atomic>
+#include <cstring>
 
 #include "JuceHeader.h"
 #include "Param.h"
 
+//! HostParamBase Class: the part of a host parameter that does not depend on the param type
+/*! Everything the host asks for repeatedly is prepared once: the name, the unit label and
+    the stable ID. The last normalised value is cached together with the engine
+    value it was computed from, so polling hosts do not run the scaling for unchanged params.
+*/
+class HostParamBase : public AudioProcessorParameter, public Param::Listener {
+public:
+    //! HostParamBase constructor.
+    /*!
+    @param p the param, its prefix must already be set
+    */
+    HostParamBase(Param &p)
+    : name(p.hostTag())
+    , label(p.unit())
+    , id(p.getID())
+    , valueCache(pack(std::numeric_limits<float>::quiet_NaN(), 0.f))
+    {
+    }
+
+    //! identifier that stays the same across versions and param orders, equal to the patch file tag
+    const String& getParameterID() const { return id; }
+
+    virtual String getName(int maximumStringLength) const override {
+        return name.length() <= maximumStringLength ? name : name.substring(0, maximumStringLength);
+    }
+
+    virtual String getLabel() const override {
+        return label;
+    }
+
+protected:
+    //! returns the cached normalised value if the engine value did not change.
+    /*!
+    @param engineVal the current raw value of the param
+    @param hostVal receives the normalised value
+    @returns false if the cache is outdated
+    */
+    bool getCachedValue(float engineVal, float &hostVal) const {
+        float cachedEngineVal;
+        unpack(valueCache.load(), cachedEngineVal, hostVal);
+        return cachedEngineVal == engineVal;
+    }
+
+    void setCachedValue(float engineVal, float hostVal) const {
+        valueCache.store(pack(engineVal, hostVal));
+    }
+
+    //! decimals of the value text, depending on the magnitude of the range
+    static int getNumDecimals(const Param &p) {
+        const float maxAbs = jmax(std::abs(p.getMin()), std::abs(p.getMax()));
+        return jlimit(0, 3, 3 - static_cast<int>(std::floor(std::log10(maxAbs))));
+    }
+
+    //! value text with a fixed amount of decimals, no "-0"
+    static String formatValue(float value, int numDecimals) {
+        const float scale = std::pow(10.f, static_cast<float>(numDecimals));
+        // adding zero turns -0 into 0
+        const float rounded = std::round(value * scale) / scale + 0.f;
+        return String::formatted("%.*f", numDecimals, rounded);
+    }
+
+private:
+    // both floats in one atomic, so that the pair is always consistent
+    static uint64 pack(float engineVal, float hostVal) {
+        uint32 bits[2];
+        std::memcpy(&bits[0], &engineVal, sizeof(float));
+        std::memcpy(&bits[1], &hostVal, sizeof(float));
+        return (static_cast<uint64>(bits[0]) << 32) | bits[1];
+    }
+    static void unpack(uint64 packed, float &engineVal, float &hostVal) {
+        const uint32 engineBits = static_cast<uint32>(packed >> 32);
+        const uint32 hostBits = static_cast<uint32>(packed);
+        std::memcpy(&engineVal, &engineBits, sizeof(float));
+        std::memcpy(&hostVal, &hostBits, sizeof(float));
+    }
+
+    const String name;
+    const String label;
+    const String id;
+    mutable std::atomic<uint64> valueCache; //!< last raw value and its normalised value
+};
+
 template<typename _par>
-class HostParam : public AudioProcessorParameter, public Param::Listener {
+class HostParam : public HostParamBase {
 public:
-    HostParam(_par &p) : param(p) {
+    HostParam(_par &p)
+    : HostParamBase(p)
+    , param(p)
+    , numDecimals(getNumDecimals(p))
+    {
         param.addListener(this);
     }
 
     ~HostParam() {
-        /* Problem in the destruction sequence: 
+        /* Problem in the destruction sequence:
          * The Param instances belong to SynthParams, a superclass of PluginAudioProcessor
-         * The HostParam instances are held in a pointer array that is a private member of 
+         * The HostParam instances are held in a pointer array that is a private member of
          * the Juce class AudioProcessor, which is also a superclass of PluginAudioProcessor.
-         * 
+         *
          * This means that when the destructor of AudioProcessor is called, the Param instances
          * are already gone. We must therefore not access param at HostParam destruction time.
          *
-         * A better solution would be clearing AudioProcessor::managedParameters within the 
-         * PluginAudioProcessor destructor. This is currently not possible because 
+         * A better solution would be clearing AudioProcessor::managedParameters within the
+         * PluginAudioProcessor destructor. This is currently not possible because
          * managedParameters is private.
          */
         //param.removeListener(this);
     }
 
     float getValue() const override {
-        return engineToHost(param.getUI());
+        const float engineVal = param.get();
+        float hostVal;
+        if (!getCachedValue(engineVal, hostVal)) {
+            hostVal = engineToHost(param.getUI());
+            setCachedValue(engineVal, hostVal);
+        }
+        return hostVal;
     }
 
     void setValue(float newValue) override {
@@ -38,33 +131,40 @@ public:
     }
 
     virtual float getDefaultValue() const override {
-        return engineToHost(param.getDefault());
-    }
-
-    virtual String getName(int maximumStringLength) const override {
-        return param.hostTag().substring(0,maximumStringLength);
-    }
-
-    virtual String getLabel() const override {
-        return param.unit();
+        return engineToHost(param.getDefaultUI());
     }
 
     virtual int getNumSteps() const override {
-        return param.getNumSteps();
+        return param.getNumSteps() > 0 ? param.getNumSteps() : AudioProcessor::getDefaultNumParameterSteps();
     }
 
-    //! \todo implement this
     virtual float getValueForText(const String& text) const override {
-        return text.getFloatValue();
+        const String t = text.trim();
+        if (param.hasLabels()) {
+            for (int i = 0; i < param.getNumSteps(); ++i) {
+                if (t.equalsIgnoreCase(param.getUIString(static_cast<float>(i)))) {
+                    return engineToHost(static_cast<float>(i));
+                }
+            }
+        }
+        // the number, a unit behind it is ignored
+        float engineVal = t.startsWithIgnoreCase("-inf") ? param.getMin() : t.getFloatValue();
+        engineVal = jlimit(param.getMin(), param.getMax(), engineVal);
+        if (param.getNumSteps() > 0) {
+            engineVal = std::floor(engineVal + .5f);
+        }
+        return engineToHost(engineVal);
     }
 
     virtual String getText (float value, int maximumStringLength) const override {
-        return param.getUIString(hostToEngine(value)).substring(0, maximumStringLength);
+        const float engineVal = hostToEngine(value);
+        const String text = param.hasLabels() ? param.getUIString(engineVal) : formatValue(engineVal, numDecimals);
+        return text.substring(0, maximumStringLength);
     }
 
     virtual void paramUIChanged() override {
         // this will (unnecessarily) call setValue
-        setValueNotifyingHost(engineToHost(param.getUI()));
+        setValueNotifyingHost(getValue());
     }
 
 protected:
@@ -82,6 +182,7 @@ protected:
     }
 
     _par &param;
+    const int numDecimals; //!< decimals of the value text
 };
 
 template<typename _par>
@@ -89,12 +190,14 @@ class HostParamLog : public HostParam<_par> {
 public:
     HostParamLog(_par &p, float midPoint) : HostParam<_par>(p) {
         skew = log(0.5f) / log((midPoint - p.getMin()) / (p.getMax() - p.getMin()));
+        inverseSkew = 1.f / skew;
         jassert(skew > 1.f || skew < 1.f);
         jassert(p.getNumSteps() == 0);
     }
 
 protected:
     float skew;
+    float inverseSkew;
 
     float engineToHost(float engineVal) const override {
         jassert(engineVal >= HostParam<_par>::param.getMin() && engineVal <= HostParam<_par>::param.getMax());
@@ -106,8 +209,8 @@ protected:
         jassert(hostVal >= 0.f && hostVal <= 1.f);
         // copied from juce::Slider::proportionOfLengthToValue
         if (hostVal > 0.f) {
-            hostVal = exp(log(hostVal) / skew);
+            hostVal = pow(hostVal, inverseSkew);
         }
         return HostParam<_par>::hostToEngine(hostVal);
     }
-};
\ No newline at end of file
+};
@@ -32,10 +32,12 @@ public:
     /*!
     A sample is usually coded with 16 bits.
     The bit degradation enables reducing this value (1 bit per sample minimum)
-    1 parameters:
+    3 parameters:
     @params AudioSampleBuffer - instance of the AudioSampleBuffer is an output buffer, which must be the buffer where the voices had been processed and added.
+    @params int - first sample to process
+    @params int - the number of samples to process
     */
-    void bitReduction(AudioSampleBuffer&);
+    void bitReduction(AudioSampleBuffer&, int, int);
 
 protected:
     SynthParams &params; //!< local params reference
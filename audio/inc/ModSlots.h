@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    ModSlots.h
+
+  ==============================================================================
+*/
+
+#ifndef MODSLOTS_H_INCLUDED
+#define MODSLOTS_H_INCLUDED
+
+#include "JuceHeader.h"
+#include "ModulationMatrix.h"
+#include <array>
+#include <atomic>
+
+//! ModSlots Class: the user slots of the modulation matrix
+/*! Besides the fixed rows of the panels, any source can modulate any destination through
+    one of these slots, as often as needed. Every slot is packed into one atomic word, the
+    UI edits them while the audio thread compiles the used ones into the matrix every block.
+    Patches only contain the used slots.
+*/
+class ModSlots {
+public:
+    static const int maxSlots = 32;
+
+    //! the unpacked values of a slot
+    struct Slot {
+        eModSource source;
+        destinations destination;
+        int amount;             //!< in percent of the destination range, [-100..100]
+        eModCurve curve;
+        eModPolarity polarity;
+    };
+
+    //! the packed slots, as copied into patch snapshots
+    typedef std::array<uint32, maxSlots> Data;
+
+    ModSlots();
+
+    Slot getSlot(int slot) const;
+    //! sets a slot, the values are clamped to their ranges
+    void setSlot(int slot, const Slot &s);
+    void clearSlot(int slot);
+
+    //! the first slot that is not used, -1 if all are
+    int findFreeSlot() const;
+
+    //! a slot without source and destination
+    static Slot getEmptySlot();
+    //! true if the slot modulates anything
+    static bool isUsed(const Slot &s);
+
+    //! all slots in packed form, lock-free
+    void getData(Data &data) const;
+    void setData(const Data &data);
+    static void getEmptyData(Data &data);
+
+    //! writes the used slots
+    void writeToStream(OutputStream &out) const;
+    //! reads slots written by writeToStream(), the others are empty
+    static bool readFromStream(InputStream &in, Data &data);
+
+    //! an element with a child per used slot, for XML patches
+    XmlElement* createXml(const String &tagName) const;
+    static void fromXml(const XmlElement &element, Data &data);
+
+private:
+    static uint32 pack(const Slot &s);
+    static Slot unpack(uint32 packed);
+    static int clampSlot(int slot) { return jlimit(0, maxSlots - 1, slot); }
+
+    std::array<std::atomic<uint32>, maxSlots> slots;
+
+    JUCE_DECLARE_NON_COPYABLE(ModSlots)
+};
+
+#endif  // MODSLOTS_H_INCLUDED
@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    ModSnapshot.h
+
+  ==============================================================================
+*/
+
+#ifndef MODSNAPSHOT_H_INCLUDED
+#define MODSNAPSHOT_H_INCLUDED
+
+#include "JuceHeader.h"
+#include "ModulationMatrix.h"
+#include <array>
+#include <atomic>
+
+//! ModSnapshot Class: the modulation of the newest voice, as seen by the editor
+/*! The audio thread publishes the values once per block, the editor fetches the latest ones
+    at its timer rate. The values live in three slots, the writer and the reader own one each
+    and swap theirs with the third through one atomic word, so neither side waits for the
+    other or allocates. Blocks the editor misses are dropped.
+*/
+class ModSnapshot {
+public:
+    static const size_t nLfos = 3;
+    static const size_t nEnvelopes = 3;
+
+    struct Values {
+        bool voiceActive;                                   //!< a voice is playing, the values below are valid
+        int note;                                           //!< midi note of the voice
+        std::array<float, MAX_DESTINATIONS> destinations;   //!< modulation as applied, offsets in the unit of the param or octaves for frequencies and speeds
+        std::array<bool, MAX_DESTINATIONS> destinationUsed; //!< a row modulates the destination
+        std::array<float, nLfos> lfo;                       //!< lfo outputs in [-1..1]
+        std::array<bool, nLfos> lfoUsed;                    //!< the lfo is rendered
+        std::array<float, nEnvelopes> env;                  //!< levels of the volume envelope, env2 and env3 in [0..1]
+        std::array<bool, nEnvelopes> envUsed;               //!< the envelope is rendered
+    };
+
+    ModSnapshot();
+
+    //! the slot for the next values, audio thread. It holds old values, every field has to be written
+    Values& beginWrite() { return slots[writeIndex]; }
+    //! hands the values written since beginWrite() to the reader, audio thread
+    void publish();
+
+    //! takes the latest published values if there are any the reader has not seen, message thread
+    bool fetch();
+    //! the values of the last successful fetch(), message thread
+    const Values& read() const { return slots[readIndex]; }
+
+    //! values without a playing voice
+    static void clear(Values &v);
+
+private:
+    static const int indexMask = 3;
+    static const int freshBit = 4;  //!< the spare slot holds values the reader has not taken yet
+
+    std::array<Values, 3> slots;
+    std::atomic<int> spare;         //!< index of the slot neither side owns, with the fresh bit
+    int writeIndex;                 //!< slot of the audio thread
+    int readIndex;                  //!< slot of the message thread
+
+    JUCE_DECLARE_NON_COPYABLE(ModSnapshot)
+};
+
+#endif  // MODSNAPSHOT_H_INCLUDED
@@ -13,7 +13,7 @@ Author:  nj
 
 #include "JuceHeader.h"
 #include "Param.h"
-#include <map>
+#include <array>
 
 //! Enumeration of all mod sources
 enum eModSource : int {
@@ -39,6 +39,12 @@ enum eModSource : int {
     eEnv2,
     eEnv3,
 
+    // Step sequencer
+    eSeqMod,
+
+    // Midi, MPE slide (CC 74)
+    eSlide,
+
     nSteps
 };
 
@@ -81,6 +87,24 @@ enum destinations : int {
     MAX_DESTINATIONS
 };
 
+//! Shapes of the user mod slots, applied to the source after the polarity
+enum class eModCurve : int {
+    eLinear = 0,
+    eExponential,   //!< x * |x|, finer near 0
+    eLogarithmic,   //!< sign(x) * sqrt(|x|), coarser near 0
+    nSteps
+};
+
+//! Range the source of a user mod slot is mapped to
+enum class eModPolarity : int {
+    eSource = 0,    //!< as the source delivers it
+    eUnipolar,      //!< [0..1], bipolar sources are shifted up
+    eBipolar,       //!< [-1..1], unipolar sources are stretched
+    nSteps
+};
+
+class ModSlots;
+
 //! mapping for mod sources to uni-/bipolar.
 /*!
 The mapping function that returns whether a modulation source if uni- or bipolar. 
@@ -99,6 +123,7 @@ static inline bool isUnipolar(eModSource source) {
     case eModSource::eInvertedVelocity:
     case eModSource::eFoot:
     case eModSource::eExpPedal:
+    case eModSource::eSlide:
         return true;
     default:
         return false;
@@ -129,7 +154,8 @@ static float toBipolar(float min, float max, float value) { return (2.0f*(value
 
 //! Modulation Matrix Class
 /*! This fixed size mod matrix is based on the book "Designing Software Synthesizer Plug-Ins in C++".
-It contains a row for each possible modulation source setting in the GUI, together with its amount and the name of its corresponding Combobox.
+It contains a row for each possible modulation source setting in the GUI, together with its amount. The rows live in a fixed size array,
+nothing is allocated when a synth instance is created.
 Within the synister synthesizer, it is maintained and instanced in the SynthParams as a global modulation matrix. Its doModulationsMatrix method
 that applies the modulation is called from the Voice for each sample.
 */
@@ -140,20 +166,20 @@ public:
     //! ModulationMatrix destructor.
     ~ModulationMatrix();
 
+    static const size_t maxRows = 64; //!< maximum amount of rows
+
     //! ModMatrixRow structure that carries the data associated with one modulation source combobox on the GUI, connecting one source with one destination.
     struct ModMatrixRow
     {
         ParamStepped<eModSource>* modSrc; //!< mod source enum/index
         destinations destinationIndex; //!< mod destination enum/index
         Param* modIntensity; //!< pointer to mod intensity param
-        String modSrcBox; //!< mod source box name
 
         //! ModMatrixRow constructor.
-        ModMatrixRow(ParamStepped<eModSource> *s, destinations d, Param *intensity, String boxname)
-            : modSrc(s)
-            , destinationIndex(d)
-            , modIntensity(intensity)
-            , modSrcBox(boxname)
+        ModMatrixRow()
+            : modSrc(nullptr)
+            , destinationIndex(DEST_NONE)
+            , modIntensity(nullptr)
         {}
     };
 
@@ -165,14 +191,14 @@ public:
     */
     inline bool modMatrixRowExists(eModSource sourceIndex, destinations destinationIndex) const;
 
-    //! Changes the source of a destination that belongs to a specific combobox.
+    //! Changes the source of a row.
     /*!
     Method that is called when the user selects a new source in a combobox. This combobox belongs to a
     row in the matrix, which is then updated.
-    @param comboBoxName name of the combobox the information comes from
+    @param modSrc the source param of the row, as registered with the combobox
     @param source the source to be changed to
     */
-    inline void changeSource(const String &comboBoxName, eModSource source);
+    inline void changeSource(const ParamStepped<eModSource> *modSrc, eModSource source);
 
     //! Adds a row to the modulation matrix.
     /*!
@@ -180,9 +206,34 @@ public:
     @param s the initial source
     @oaram d the destination
     @param intensity the initial intensity value
-    @param comboboxName the name of the combobox the row belongs to
     */
-    inline void addModMatrixRow(ParamStepped<eModSource> *s, destinations d, Param *intensity, String comboboxName);
+    inline void addModMatrixRow(ParamStepped<eModSource> *s, destinations d, Param *intensity);
+
+    //! Compiles the used user slots into the rows applied per sample.
+    /*!
+    Called by the audio thread at the start of each block, so the voices only loop over slots
+    that have a source, a destination and an amount. Lock-free and without allocation.
+    @param slots the user slots, may be edited by other threads meanwhile
+    */
+    void compileUserSlots(const ModSlots &slots);
+
+    //! amount of user slots applied per sample
+    size_t getNumUserRows() const { return numUserRows; }
+
+    //! Compiles the rows with a source and a destination and collects what they use.
+    /*!
+    Called by the audio thread before the voices render a range, as the sources of the rows are
+    params that may change between ranges. The voices only render the used sources and only
+    clear the used destinations.
+    */
+    void compileRouting();
+
+    //! true if a compiled row or user slot reads the source
+    bool isSourceUsed(eModSource source) const { return usedSources[source]; }
+    //! true if a compiled row or user slot writes the destination, the others stay zero
+    bool isDestinationUsed(destinations destination) const { return usedDestinations[destination]; }
+    //! true if doModulationsMatrix() has anything to do
+    bool hasActiveRows() const { return numActiveRows > 0 || numUserRows > 0; }
 
     //! Applies the modulation for a sample.
     /*!
@@ -194,45 +245,67 @@ public:
 
 
 private:
-    std::vector<ModMatrixRow> matrixCore; //!< matrix core that keeps all the rows of the matrix in a vector
+    //! a row with source and destination, with the intensity mapped to the polarity of the source
+    struct ActiveRow {
+        eModSource source;
+        destinations destination;
+        float intensity;
+    };
+
+    //! a user slot prepared for the audio thread
+    struct UserRow {
+        eModSource source;
+        destinations destination;
+        eModCurve curve;
+        float scale;    //!< polarity mapping, source * scale + offset
+        float offset;
+        float amount;   //!< in [-1..1]
+    };
+
+    std::array<ModMatrixRow, maxRows> matrixCore; //!< matrix core that keeps all the rows of the matrix, the first numRows are used
+    size_t numRows; //!< amount of used rows
+    std::array<UserRow, maxRows> userRows; //!< the used user slots, the first numUserRows are valid
+    size_t numUserRows; //!< amount of used user slots
+    std::array<ActiveRow, maxRows> activeRows; //!< the rows of matrixCore that modulate anything, the first numActiveRows are valid
+    size_t numActiveRows; //!< amount of active rows
+    std::array<bool, eModSource::nSteps> usedSources; //!< sources read by the active rows and user slots
+    std::array<bool, MAX_DESTINATIONS> usedDestinations; //!< destinations written by the active rows and user slots
 };
 
 inline void ModulationMatrix::doModulationsMatrix(const float** src, float** dst) const
 {
-    for (const ModMatrixRow &row : matrixCore)
+    for (size_t r = 0; r < numActiveRows; ++r)
     {
-        // get the source value & mod intensity
-        if (row.modSrc->getStep() > eModSource::eNone && row.modSrc->getStep() < eModSource::nSteps
-            && row.destinationIndex > DEST_NONE && row.destinationIndex < MAX_DESTINATIONS) {
-            float source = *(src[row.modSrc->getStep()]);
-            float intensity = row.modIntensity->get();
-
-            // get the min max values for the intensity for transformation
-            float min = row.modIntensity->getMin();
-            float max = row.modIntensity->getMax();
-
-            if (isUnipolar(row.modSrc->getStep())) {
-                // if the source is unipolar, transform the intensity to bipolar
-                intensity = toBipolar(min, max, intensity);
-            }
-            else {
-                // else the source is bipolar, transform the intensity to unipolar
-                intensity = toUnipolar(min, max, intensity);
-            }
+        const ActiveRow &row = activeRows[r];
+        /*we are just adding the modified values into the predefined buffers
+          the conversion and application is applied outside of the matrix*/
+        *(dst[row.destination]) += *(src[row.source]) * row.intensity;
+    }
 
-            float dModValue = source*intensity;
-            /*we are just adding the modified values into the predefined buffers
-              the conversion and application is applied outside of the matrix*/
-            *(dst[row.destinationIndex]) += dModValue;
+    for (size_t r = 0; r < numUserRows; ++r)
+    {
+        const UserRow &row = userRows[r];
+        float source = *(src[row.source]) * row.scale + row.offset;
+        switch (row.curve) {
+        case eModCurve::eExponential:
+            source *= std::abs(source);
+            break;
+        case eModCurve::eLogarithmic:
+            source = source < 0.f ? -std::sqrt(-source) : std::sqrt(source);
+            break;
+        default:
+            break;
         }
+        *(dst[row.destination]) += source * row.amount;
     }
 }
 
 // config changes
 inline bool ModulationMatrix::modMatrixRowExists(eModSource sourceIndex, destinations destinationIndex) const
 {
-    for (const ModMatrixRow &row : matrixCore)
+    for (size_t r = 0; r < numRows; ++r)
     {
+        const ModMatrixRow &row = matrixCore[r];
         // find matching source/destination pairs
         if (row.modSrc->getStep() == sourceIndex && row.destinationIndex == destinationIndex)
         {
@@ -242,11 +315,12 @@ inline bool ModulationMatrix::modMatrixRowExists(eModSource sourceIndex, destina
     return false;
 }
 
-inline void ModulationMatrix::changeSource(const String &comboBoxName, eModSource source) {
-    for (ModMatrixRow &row : matrixCore)
+inline void ModulationMatrix::changeSource(const ParamStepped<eModSource> *modSrc, eModSource source) {
+    for (size_t r = 0; r < numRows; ++r)
     {
-        // find matching source/destination pairs
-        if (row.modSrcBox == comboBoxName)
+        ModMatrixRow &row = matrixCore[r];
+        // find the row of the combobox
+        if (row.modSrc == modSrc)
         {
             // before we change the old source, we gotta check whether it is a switch between unipolar<->bipolar (for conversion reasons)
             eModSource oldSource = row.modSrc->getStep();
@@ -287,9 +361,16 @@ inline void ModulationMatrix::changeSource(const String &comboBoxName, eModSourc
     }
 }
 
-inline void ModulationMatrix::addModMatrixRow(ParamStepped<eModSource> *s, destinations d, Param *intensity, String boxname)
+inline void ModulationMatrix::addModMatrixRow(ParamStepped<eModSource> *s, destinations d, Param *intensity)
 {
-    matrixCore.push_back(ModMatrixRow(s, d, intensity, boxname));
+    // raise maxRows when adding mod sources to the ui
+    jassert(numRows < maxRows);
+    if (numRows < maxRows) {
+        ModMatrixRow &row = matrixCore[numRows++];
+        row.modSrc = s;
+        row.destinationIndex = d;
+        row.modIntensity = intensity;
+    }
 }
 
 #endif  // MODULATIONMATRIX_H_INCLUDED
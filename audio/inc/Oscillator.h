@@ -50,6 +50,11 @@ public:
         return result;
     }
 
+    //! advances the phase as numSamples calls of next() would, without computing the waveform
+    void skip(int numSamples) {
+        phase = std::fmod(phase + phaseDelta * static_cast<float>(numSamples), float_Pi * 2.0f);
+    }
+
     float next(float pitchMod, float widthOrTrDelta) {
         const float result = _waveform(phase, trngAmount + widthOrTrDelta, width + widthOrTrDelta);
         phase = std::fmod(phase + phaseDelta*pitchMod, float_Pi * 2.0f);
@@ -122,6 +127,14 @@ public:
         phase = std::fmod(phase + phaseDelta*pitchMod, float_Pi * 2.0f);
         return heldValue;
     }
+
+    //! advances the phase as numSamples calls of next() would, a new value is held if a period ends
+    void skip(int numSamples) {
+        if (phase + phaseDelta * static_cast<float>(numSamples) > 2.0f * float_Pi) {
+            heldValue = static_cast <float> (rand()) / (static_cast <float> (RAND_MAX / 2.f)) - 1.f;
+        }
+        phase = std::fmod(phase + phaseDelta * static_cast<float>(numSamples), float_Pi * 2.0f);
+    }
 };
 
 
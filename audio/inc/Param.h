@@ -3,36 +3,63 @@
 #include <atomic>
 #include <array>
 #include "JuceHeader.h"
+#include "ParamStore.h"
+
+//! immutable metadata of a param
+/*! Defined once in static tables and shared by all synth instances, the params only
+    keep a reference. Ranges of ParamDb are in dB.
+*/
+struct ParamDescriptor {
+    constexpr ParamDescriptor(const char *name_, const char *serializationTag_, const char *hostTag_, const char *unit_,
+                              float minval, float maxval, float defaultval, int numSteps_ = 0, const char * const *labels_ = nullptr)
+    : name(name_)
+    , serializationTag(serializationTag_)
+    , hostTag(hostTag_)
+    , unit(unit_)
+    , minValue(minval)
+    , maxValue(maxval)
+    , defaultValue(defaultval)
+    , numSteps(numSteps_)
+    , labels(labels_)
+    {}
+
+    const char *name;               //!< name shown in the ui
+    const char *serializationTag;   //!< tag in the patch files, without prefix
+    const char *hostTag;            //!< name shown to the host, without prefix
+    const char *unit;               //!< unit label
+    float minValue;                 //!< lowest ui value
+    float maxValue;                 //!< highest ui value
+    float defaultValue;             //!< default ui value
+    int numSteps;                   //!< 0 for continuous params
+    const char * const *labels;     //!< names of the steps or nullptr
+};
 
+//! descriptor of a ParamStepped, range and steps follow from the enum
+template<typename _enum>
+constexpr ParamDescriptor steppedDescriptor(const char *name, const char *serializationTag, const char *hostTag, _enum defaultval, const char * const *labels = nullptr)
+{
+    return ParamDescriptor(name, serializationTag, hostTag, "", 0.f, static_cast<float>(_enum::nSteps) - 1.f,
+                           static_cast<float>(defaultval), static_cast<int>(_enum::nSteps), labels);
+}
 
 class Param {
 public:
-    Param(const String &name, const String &serializationTag, const String &hostTag, const String &unit, float minval, float maxval, float defaultval, int numSteps=0)
-    : val_(defaultval)
-    , min_(minval)
-    , max_(maxval)
-    , default_(defaultval)
-    , name_(name)
-    , serializationTag_(serializationTag)
-    , hostTag_(hostTag)
-    , unit_(unit)
-    , numSteps_(numSteps)
-    {
-        jassert(minval < maxval);
-        // this is broken for ParamDb because minval and maxval are in the dB range, but defaultval is already transformed
-        //jassert(minval <= defaultval);
-        //jassert(defaultval <= maxval);
-    }
+    Param(ParamStore &store, const ParamDescriptor &desc)
+    : Param(store, desc, desc.defaultValue)
+    {}
     virtual ~Param() {}
 
     void setPrefix(const String &s) { prefix_ = s; }
     const String& prefix() { return prefix_; }
 
-    const String& name() const { return name_; }
-    const String& serializationTag() const { return serializationTag_; }
-    String hostTag() const { return prefix_.isEmpty() ? (hostTag_) : (prefix_ + " " + hostTag_); }
-    const String& unit() const { return unit_; }
-    int getNumSteps() const { return numSteps_; }
+    String name() const { return desc_.name; }
+    String serializationTag() const { return desc_.serializationTag; }
+    String hostTag() const { return prefix_.isEmpty() ? String(desc_.hostTag) : (prefix_ + " " + desc_.hostTag); }
+    String unit() const { return desc_.unit; }
+    int getNumSteps() const { return desc_.numSteps; }
+    const ParamDescriptor& descriptor() const { return desc_; }
+    //! stable identifier of the param, prefix and serialization tag without spaces as in the patch files
+    String getID() const { return (prefix_ + desc_.serializationTag).removeCharacters(" "); }
 
     void set(float f) { val_.store(f); }
     void set(float f, bool) {
@@ -42,7 +69,7 @@ public:
     float get() const { return val_.load(); }
 
     virtual void setUI(float f, bool notifyHost = true) {
-        if (f >= min_ && f <= max_) {
+        if (f >= desc_.minValue && f <= desc_.maxValue) {
             set(f);
         } else {
             jassertfalse;
@@ -52,14 +79,16 @@ public:
     }
     virtual float getUI() const { return get(); }
     virtual float getDefaultUI() const { return getDefault(); }
+    //! the value that setUI(f) would store, without storing it
+    virtual float fromUI(float f) const { return f; }
     virtual String getUIString() const { return getUIString(get()); }
     virtual String getUIString(float v) const { return String::formatted("%f", v); }
     virtual bool hasLabels() const { return false; }
 
-    float getMin() const { return min_; }
-    float getMax() const { return max_; }
+    float getMin() const { return desc_.minValue; }
+    float getMax() const { return desc_.maxValue; }
     float getDefault() const { return default_; }
-    String getUnit() const { return unit_; }
+    String getUnit() const { return desc_.unit; }
 
     void setHost(float f) {
         setUI(f, false);
@@ -97,18 +126,25 @@ public:
 
     void addListener(Listener *newListener) { listener.add(newListener); }
     void removeListener(Listener *aListener) { listener.remove(aListener); }
+    //! tells the listeners about a change made with set(), message thread only
+    void notifyListeners() { listener.call(&Listener::paramUIChanged); }
 
 protected:
-    ScopedPointer<float> value;
-    std::atomic<float> val_;
-    float min_;
-    float max_;
-    float default_;
-    String name_;
-    String serializationTag_;
-    String hostTag_;
-    String unit_;
-    int numSteps_;
+    Param(ParamStore &store, const ParamDescriptor &desc, float defaultval)
+    : desc_(desc)
+    , val_(store.allocate(defaultval))
+    , default_(defaultval)
+    , uiDirty(false)
+    {
+        jassert(desc.minValue < desc.maxValue);
+        // this is broken for ParamDb because minval and maxval are in the dB range, but defaultval is already transformed
+        //jassert(minval <= defaultval);
+        //jassert(defaultval <= maxval);
+    }
+
+    const ParamDescriptor &desc_;   //!< shared metadata
+    std::atomic<float> &val_;       //!< value in the store of the synth instance
+    float default_;                 //!< default value, transformed for ParamDb
 
     String prefix_;
 
@@ -118,13 +154,13 @@ protected:
 
 class ParamDb : public Param {
 public:
-    ParamDb(const String &name, const String &serializationTag, const String &hostTag, const String &unit, float minval, float maxval, float defaultval)
-        : Param(name, serializationTag, hostTag, unit, minval, maxval, fromDb(defaultval))
+    ParamDb(ParamStore &store, const ParamDescriptor &desc)
+        : Param(store, desc, fromDb(desc.defaultValue))
     {}
 
     virtual void setUI(float f, bool notifyHost = true) override {
-        if (f >= min_ && f <= max_) {
-            set(fromDb(f));
+        if (f >= desc_.minValue && f <= desc_.maxValue) {
+            set(fromUI(f));
         } else {
             jassert(false);
         }
@@ -132,56 +168,42 @@ public:
     }
     virtual float getUI() const override { return toDb(get()); }
     virtual float getDefaultUI() const { return toDb(getDefault()); }
+    virtual float fromUI(float f) const override { return fromDb(f); }
 };
 
 template<typename _enum>
 class ParamStepped : public Param {
 public:
-    ParamStepped(const String &name, const String &serializationTag, const String &hostTag, _enum defaultval, const char **labels = nullptr)
-    : Param(name, serializationTag, hostTag, "", 0.f, static_cast<float>(_enum::nSteps)-1.f,
-            static_cast<float>(defaultval),
-            static_cast<int>(_enum::nSteps))
-    , step_(defaultval)
-    , labelsSet(false)
+    ParamStepped(ParamStore &store, const ParamDescriptor &desc)
+    : Param(store, desc)
     {
-        const char **lbl = labels;
-        for(size_t u = 0; u<labels_.size() && lbl != nullptr && *lbl != nullptr; ++u, ++lbl) {
-            labels_[u] = *lbl;
-            labelsSet = true;
-        }
+        jassert(desc.numSteps == static_cast<int>(_enum::nSteps));
     }
 
-    //! \todo what about the set method? Make sure that no inconsistent state is created!
-
+    //! the value is always stored rounded to a step
     _enum getStep () const {
-        return step_.load();
+        return static_cast<_enum>(static_cast<int>(get() + .5f));
     }
     void setStep (_enum v) {
-        step_.store(v);
         set(static_cast<float>(v));
     }
 
     virtual void setUI(float f, bool notifyHost = true) override {
-        set(f);
-        int ival = static_cast<int>(std::trunc(f + .5f));
-        jassert(ival >= 0 && ival < static_cast<int>(_enum::nSteps));
-        step_.store(static_cast<_enum>(ival));
+        const float step = fromUI(f);
+        jassert(step >= 0.f && step < static_cast<float>(_enum::nSteps));
+        set(step);
         if (notifyHost) listener.call(&Listener::paramUIChanged);
     }
-    virtual String getUIString() const override { return labels_[static_cast<size_t>(getStep())]; }
+    virtual float fromUI(float f) const override { return std::trunc(f + .5f); }
+    virtual String getUIString() const override { return getUIString(get()); }
     virtual String getUIString(float v) const override {
         size_t u = static_cast<size_t>(std::trunc(v+.5f));
-        if(u<labels_.size()) {
-            return labels_[u];
+        if(u<static_cast<size_t>(_enum::nSteps)) {
+            return desc_.labels != nullptr ? String(desc_.labels[u]) : String();
         } else {
             jassert(false);
             return String::formatted("val%u",u);
         }
     }
-    virtual bool hasLabels() const override { return labelsSet; }
-
-protected:
-    std::atomic<_enum> step_;
-    std::array<String, static_cast<size_t>(_enum::nSteps)> labels_;
-    bool labelsSet;
+    virtual bool hasLabels() const override { return desc_.labels != nullptr; }
 };
@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    ParamEventQueue.h
+
+  ==============================================================================
+*/
+
+#ifndef PARAMEVENTQUEUE_H_INCLUDED
+#define PARAMEVENTQUEUE_H_INCLUDED
+
+#include "JuceHeader.h"
+#include <atomic>
+#include <array>
+
+//! ParamEventQueue Class: lock-free queue of timestamped parameter changes
+/*! Bounded queue with one sequence counter per cell (after Dmitry Vyukov), any thread
+    may push, only one thread at a time may pop. Nothing is allocated after construction,
+    push fails if the queue is full.
+*/
+class ParamEventQueue {
+public:
+    //! a parameter change as it arrived from the host
+    struct Event {
+        int index;          //!< host parameter index
+        float value;        //!< normalized host value
+        int64 ticks;        //!< Time::getHighResolutionTicks() at arrival
+        bool immediate;     //!< arrived on the audio thread before the block, applies at its start
+    };
+
+    static const size_t capacity = 1024;   //!< maximum amount of queued events, power of two
+
+    //! ParamEventQueue constructor.
+    ParamEventQueue();
+
+    //! adds an event, can be called from any thread.
+    /*!
+    @param e the event to add
+    @returns false if the queue is full and the event was dropped
+    */
+    bool push(const Event& e);
+
+    //! removes the oldest event, must only be called from one thread at a time.
+    /*!
+    @param e receives the event
+    @returns false if the queue is empty
+    */
+    bool pop(Event& e);
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        Event event;
+    };
+
+    std::array<Cell, capacity> cells;
+    std::atomic<size_t> enqueuePosition;
+    std::atomic<size_t> dequeuePosition;
+
+    JUCE_DECLARE_NON_COPYABLE(ParamEventQueue)
+};
+
+#endif  // PARAMEVENTQUEUE_H_INCLUDED
@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    ParamRamp.h
+
+  ==============================================================================
+*/
+
+#ifndef PARAMRAMP_H_INCLUDED
+#define PARAMRAMP_H_INCLUDED
+
+#include "JuceHeader.h"
+#include "Param.h"
+
+//! ParamRamp Class: smoothed per-sample values of a continuous param
+/*! The param is read once per rendered range. A change starts a ramp from the current
+    to the new value that lasts the ramp time, the values of the range are written into a
+    buffer that the render loops read instead of the param. Linear ramps are meant for
+    gains and mix amounts, multiplicative ramps for frequencies.
+*/
+class ParamRamp {
+public:
+    enum class eMode : int {
+        eLinear = 0,
+        eMultiplicative = 1
+    };
+
+    //! ParamRamp constructor.
+    /*!
+    @param p the smoothed param
+    @param m linear or multiplicative ramp
+    @param rampSeconds duration of a ramp
+    */
+    ParamRamp(Param &p, eMode m = eMode::eLinear, float rampSeconds = .02f);
+
+    //! ramp initialization.
+    /*!
+    Allocates the value buffer and jumps to the current param value.
+    @param sampleRateIn the current sample rate
+    @param maxNumSamples the longest range that will be rendered
+    */
+    void init(double sampleRateIn, int maxNumSamples);
+
+    //! sets the duration of the following ramps.
+    void setRampTime(float seconds);
+
+    //! jumps to the current param value.
+    void reset();
+
+    //! ramp rendering.
+    /*!
+    Fills the buffer with the values of the given range. Must be called for every range
+    before the values are read.
+    @param startSample first sample of the range
+    @param numSamples length of the range, at most maxNumSamples
+    */
+    void render(int startSample, int numSamples);
+
+    //! values of the last rendered range.
+    /*!
+    @param startSample a sample inside the last rendered range
+    @returns pointer to the value at startSample
+    */
+    const float* getRamp(int startSample) const
+    {
+        jassert(startSample >= rangeStart && startSample - rangeStart < capacity);
+        return values + (startSample - rangeStart);
+    }
+
+    //! modulation of the last rendered range.
+    /*!
+    Applies a per-sample modulation to the values, the result is kept inside the range of
+    the param. Called after render() and before the values are read.
+    @param m eLinear adds mod to the values, eMultiplicative multiplies them by it
+    @param mod modulation values starting at the first sample of the range
+    @param numSamples length of the range
+    */
+    void modulate(eMode m, const float* mod, int numSamples);
+
+    //! true while a ramp is running.
+    bool isSmoothing() const { return stepsLeft > 0; }
+
+    //! value after the last rendered range.
+    float getCurrent() const { return current; }
+
+private:
+    Param &param;           //!< smoothed param
+    eMode mode;             //!< ramp shape
+    float rampTime;         //!< ramp duration in seconds
+    double sampleRate;      //!< current sample rate
+    HeapBlock<float> values;//!< values of the last rendered range
+    int capacity;           //!< size of values
+    int rangeStart;         //!< first sample of the last rendered range
+    float current;          //!< current value
+    float target;           //!< value at the end of the ramp
+    float step;             //!< increment or factor per sample
+    int stepsLeft;          //!< remaining samples of the ramp
+    bool multiplicative;    //!< step is a factor for the running ramp
+
+    JUCE_DECLARE_NON_COPYABLE(ParamRamp)
+};
+
+#endif  // PARAMRAMP_H_INCLUDED
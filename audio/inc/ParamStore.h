@@ -0,0 +1,68 @@
+/*
+  ==============================================================================
+
+    ParamStore.h
+
+  ==============================================================================
+*/
+
+#ifndef PARAMSTORE_H_INCLUDED
+#define PARAMSTORE_H_INCLUDED
+
+#include "JuceHeader.h"
+#include <atomic>
+
+//! ParamStore Class: contiguous storage for the values of all params of one synth instance
+/*! Every Param takes one slot at construction, in declaration order, so params that are
+    declared next to each other share cache lines. The block starts on a cache line and
+    holds nothing but the values, the render loops touch a few kilobytes instead of one
+    cache line per param.
+*/
+class ParamStore {
+public:
+    static const int capacity = 512;    //!< maximum amount of params
+    static const int cacheLineSize = 64;
+
+    ParamStore()
+        : overflow(0.f)
+        , numSlots(0)
+    {
+        // no alignment guarantee from operator new, align by hand
+        storage.allocate(capacity * sizeof(std::atomic<float>) + cacheLineSize, false);
+        const pointer_sized_int address = reinterpret_cast<pointer_sized_int>(storage.getData());
+        const pointer_sized_int aligned = (address + cacheLineSize - 1) & ~static_cast<pointer_sized_int>(cacheLineSize - 1);
+        values = reinterpret_cast<std::atomic<float>*>(aligned);
+        for (int i = 0; i < capacity; ++i) {
+            new (values + i) std::atomic<float>(0.f);
+        }
+    }
+
+    //! takes the next free slot.
+    /*!
+    @param initialValue value of the slot
+    @returns the slot, valid for the lifetime of the store. If all slots are taken, a spare
+             slot outside the store, which the params beyond capacity have to share.
+    */
+    std::atomic<float>& allocate(float initialValue)
+    {
+        // the params that fit keep their own slots, only the excess ones interfere
+        std::atomic<float>& slot = (numSlots < capacity) ? values[numSlots] : overflow;
+        jassert(numSlots < capacity); // raise capacity
+        ++numSlots;
+        slot.store(initialValue);
+        return slot;
+    }
+
+    //! amount of allocated slots, more than capacity if params did not fit
+    int size() const { return numSlots; }
+
+private:
+    HeapBlock<char> storage;        //!< unaligned memory of the values
+    std::atomic<float>* values;     //!< first slot, on a cache line
+    std::atomic<float> overflow;    //!< handed out once all slots are taken
+    int numSlots;                   //!< taken slots
+
+    JUCE_DECLARE_NON_COPYABLE(ParamStore)
+};
+
+#endif  // PARAMSTORE_H_INCLUDED
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    PatchSnapshot.h
+
+  ==============================================================================
+*/
+
+#ifndef PATCHSNAPSHOT_H_INCLUDED
+#define PATCHSNAPSHOT_H_INCLUDED
+
+#include "JuceHeader.h"
+#include "Param.h"
+#include "SeqPattern.h"
+#include "ModSlots.h"
+
+//! PatchSnapshot Class: the decoded values of a patch, ready to be applied in one go
+/*! A patch is decoded into a snapshot on the message thread, value conversions and
+    range checks included. Applying it only stores the prepared values, so it can run on
+    the audio thread between two blocks and no block ever sees half of a patch.
+*/
+class PatchSnapshot {
+public:
+    //! PatchSnapshot constructor.
+    /*!
+    @param maxNumValues amount of params the patch may contain
+    */
+    explicit PatchSnapshot(int maxNumValues)
+        : capacity(jmax(0, maxNumValues))
+        , numValues(0)
+        , pattern(nullptr)
+        , slots(nullptr)
+    {
+        params.allocate(static_cast<size_t>(capacity), false);
+        values.allocate(static_cast<size_t>(capacity), false);
+    }
+
+    //! adds the value of a param, clamped to its range.
+    /*!
+    @param p the param
+    @param uiValue value as shown in the UI, i.e. in dB for ParamDb
+    */
+    void add(Param &p, float uiValue)
+    {
+        jassert(numValues < capacity);
+        if (numValues < capacity) {
+            params[numValues] = &p;
+            values[numValues] = p.fromUI(jlimit(p.getMin(), p.getMax(), uiValue));
+            ++numValues;
+        }
+    }
+
+    //! adds the steps of a sequencer pattern.
+    /*!
+    @param target the pattern to set
+    @param data its new steps
+    */
+    void setPattern(SeqPattern &target, const SeqPattern::Data &data)
+    {
+        pattern = &target;
+        patternData = data;
+    }
+
+    //! adds the user slots of the mod matrix.
+    /*!
+    @param target the slots to set
+    @param data their new values
+    */
+    void setModSlots(ModSlots &target, const ModSlots::Data &data)
+    {
+        slots = &target;
+        slotData = data;
+    }
+
+    //! stores all values and marks the params dirty for the UI, lock-free and without allocation
+    void apply() const
+    {
+        for (int i = 0; i < numValues; ++i) {
+            params[i]->set(values[i], true);
+        }
+        if (pattern != nullptr) {
+            pattern->setData(patternData);
+        }
+        if (slots != nullptr) {
+            slots->setData(slotData);
+        }
+    }
+
+    //! tells the listeners (host params) about the new values, message thread only
+    void notifyListeners() const
+    {
+        for (int i = 0; i < numValues; ++i) {
+            params[i]->notifyListeners();
+        }
+    }
+
+    int size() const { return numValues; }
+
+private:
+    const int capacity;
+    int numValues;
+    HeapBlock<Param*> params;   //!< params of the patch
+    HeapBlock<float> values;    //!< their new values, already transformed by Param::fromUI
+    SeqPattern* pattern;        //!< pattern to set, nullptr if the patch has none
+    SeqPattern::Data patternData;
+    ModSlots* slots;            //!< user mod slots to set, nullptr if the patch has none
+    ModSlots::Data slotData;
+
+    JUCE_DECLARE_NON_COPYABLE(PatchSnapshot)
+};
+
+#endif  // PATCHSNAPSHOT_H_INCLUDED
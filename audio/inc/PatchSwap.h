@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    PatchSwap.h
+
+  ==============================================================================
+*/
+
+#ifndef PATCHSWAP_H_INCLUDED
+#define PATCHSWAP_H_INCLUDED
+
+#include "JuceHeader.h"
+#include "PatchSnapshot.h"
+#include <atomic>
+
+//! PatchSwap Class: hands decoded patches to the audio thread and applies them between blocks
+/*! The message thread posts a PatchSnapshot, the audio thread picks it up at the start of a
+    block and applies all values at once. Depending on the transition the output is faded
+    out before and faded in after the switch, optionally stopping the playing voices while
+    the output is silent.
+    Only one snapshot is with the audio thread at a time. Patches posted meanwhile wait on
+    the message thread and follow in order, since a patch may contain only some params (e.g.
+    the sequencer). Applied snapshots are handed back and deleted on the message thread, the
+    audio thread never allocates, frees or locks.
+*/
+class PatchSwap : private Timer {
+public:
+    //! how the audio changes from the old to the new patch
+    enum class eTransition {
+        eImmediate,     //!< apply at the next block, the param ramps smooth the change
+        eFade,          //!< fade out, apply, fade in
+        eReleaseVoices  //!< like eFade, but the playing voices are stopped while silent
+    };
+
+    //! what processBlock has to do after beginBlock()
+    enum class eAction {
+        eNone,          //!< nothing was applied
+        eApplied,       //!< applied while audible
+        eAppliedSilent, //!< applied while the output is faded out, ramps may jump
+        eReleaseVoices  //!< applied while silent, the voices must be stopped
+    };
+
+    PatchSwap();
+    ~PatchSwap();
+
+    void setTransition(eTransition t) { transition.store(t); }
+    eTransition getTransition() const { return transition.load(); }
+
+    //! prepares the fades and routes snapshots to the audio thread, call in prepareToPlay
+    void prepare(double sampleRate);
+
+    //! applies everything that is still waiting, call when the audio thread has stopped
+    void release();
+
+    //! hands a snapshot over, message thread only.
+    /*!
+    @param snapshot the decoded patch, ownership is taken
+    */
+    void post(PatchSnapshot* snapshot);
+
+    //! picks up a posted snapshot, audio thread, at the start of a block
+    eAction beginBlock();
+
+    //! fades the block if a switch is in progress, audio thread, after rendering the block
+    void endBlock(AudioSampleBuffer& buffer, int numSamples);
+
+private:
+    void timerCallback() override;
+
+    //! applies and deletes a snapshot while the audio thread is not running
+    static void applyNow(PatchSnapshot* snapshot);
+
+    //! returns applied snapshots and publishes the waiting one, message thread
+    void exchange();
+
+    std::atomic<eTransition> transition;
+    std::atomic<bool> audioActive;                  //!< snapshots go to the audio thread
+
+    OwnedArray<PatchSnapshot> waiting;              //!< posted while another one was published
+    CriticalSection waitingLock;                    //!< some hosts restore state from other threads
+    std::atomic<PatchSnapshot*> published;          //!< with the audio thread, owned by the message thread
+    std::atomic<PatchSnapshot*> retired;            //!< equals published once the audio thread applied it
+
+    // audio thread
+    float gain;                                     //!< current fade gain
+    float fadeStep;                                 //!< gain change per sample
+    int fadeDirection;                              //!< -1 fading out, 1 fading in, 0 idle
+
+    JUCE_DECLARE_NON_COPYABLE(PatchSwap)
+};
+
+#endif  // PATCHSWAP_H_INCLUDED
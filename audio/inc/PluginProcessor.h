@@ -14,19 +14,26 @@
 #include "../JuceLibraryCode/JuceHeader.h"
 
 #include "SynthParams.h"
-#include "FxClipping.h"
-#include "FxDelay.h"
+#include "FxChain.h"
+#include "Denormals.h"
+#include "ParamEventQueue.h"
+#include "PatchSwap.h"
+#include "ProgramBank.h"
+#include "RealtimeGuard.h"
 #include <array>
+#include <vector>
 #include "StepSequencer.h"
-#include "FxChorus.h"
-#include "LowFidelity.h"
+#include "Arpeggiator.h"
+#include "GlobalModBus.h"
 #include <math.h>
 
+class Voice;
+
 //==============================================================================
 /**
 */
 class Sequencer;
-class PluginAudioProcessor  : public AudioProcessor, public SynthParams
+class PluginAudioProcessor  : public AudioProcessor, public SynthParams, private ChangeListener
 {
 public:
     //==============================================================================
@@ -39,6 +46,13 @@ public:
 
     void processBlock (AudioSampleBuffer&, MidiBuffer&) override;
 
+    //! schedules host parameter changes for the audio thread instead of applying them at once
+    /*! Changes that arrive on other threads are spread over the next block in their relative
+        timing. Hosts that automate from the audio thread between the blocks give no sample
+        position, their changes apply at the start of the next block.
+    */
+    void setParameter (int index, float newValue) override;
+
     //==============================================================================
     AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -67,6 +81,14 @@ public:
     void getStateInformation (MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    //==============================================================================
+    void loadImpulseResponse(const String& path) override;
+    //! the patch is applied by the audio thread between two blocks
+    void applyPatch(PatchSnapshot* snapshot) override;
+
+    //! sets how the sound changes when a patch is loaded while playing
+    void setPatchTransition(PatchSwap::eTransition t) { patchSwap.setTransition(t); }
+
 
 private:
     //==============================================================================
@@ -78,13 +100,26 @@ private:
             {
                 
             case 1: //Modwheel
-                midiState.values[MidiState::eModwheel] = newValue;
+                midiState.setMsb(MidiState::eModwheel, newValue);
                 break;
             case 4: //Foot Controller
-                midiState.values[MidiState::eFoot] = newValue;
+                midiState.setMsb(MidiState::eFoot, newValue);
                 break;
             case 11: //Expression Control
-                midiState.values[MidiState::eExpPedal] = newValue;
+                midiState.setMsb(MidiState::eExpPedal, newValue);
+                break;
+            // the LSBs of 14 bit controllers, they follow their MSB
+            case 33:
+                midiState.setLsb(MidiState::eModwheel, newValue);
+                break;
+            case 36:
+                midiState.setLsb(MidiState::eFoot, newValue);
+                break;
+            case 43:
+                midiState.setLsb(MidiState::eExpPedal, newValue);
+                break;
+            case 74: //MPE Slide
+                midiState.getChannel(midiChannel).slide = newValue;
                 break;
             default:
                 break;
@@ -92,25 +127,65 @@ private:
             Synthesiser::handleController(midiChannel, controllerNumber, newValue);
         }
         void handleChannelPressure(int midiChannel, int channelPressureValue) override {
-            midiState.values[MidiState::eAftertouch] = channelPressureValue;
+            midiState.setMsb(MidiState::eAftertouch, channelPressureValue);
+            midiState.getChannel(midiChannel).pressure = channelPressureValue;
             Synthesiser::handleChannelPressure(midiChannel, channelPressureValue);
         }
+        void handlePitchWheel(int midiChannel, int wheelValue) override {
+            // the voices read the expression of their channel when they render
+            midiState.getChannel(midiChannel).pitchBend = wheelValue;
+            Synthesiser::handlePitchWheel(midiChannel, wheelValue);
+        }
     private:
         MidiState& midiState;
     };
 
     Synth synth;
+    std::vector<Voice*> voices;     //!< the voices of synth, which owns them. Read without its lock
 
     // FX
-    FxDelay delay;
-    FxClipping clip;
-
-    LowFidelity lowFi;
+    FxChain fxChain;
 
     StepSequencer stepSeq;
-    FxChorus chorus;
+    Arpeggiator arpeggiator;
+    GlobalModBus globalModBus;      //!< modulation of the fx and master params
+
+    //! counts denormal and NaN samples per stage in debug builds
+    NonFiniteSentinel sentinel;
+
+    //! parameter change at a sample position of the current block
+    struct ScheduledEvent {
+        int offset;
+        int index;
+        float value;
+    };
+
+    PatchSwap patchSwap;                                                        //!< patches loaded while the audio thread runs
+    ProgramBank programBank;                                                    //!< presets for program changes
+
+    ParamEventQueue paramEvents;                                                //!< host parameter changes, filled by setParameter
+    std::array<ScheduledEvent, ParamEventQueue::capacity> scheduledEvents;      //!< changes of the current block, sorted by offset
+    std::vector<std::atomic<int>> pendingParamEvents;                           //!< queued changes per host param, not applied yet
+    std::atomic<bool> paramEventsActive;                                        //!< changes are queued only while the audio thread runs
+    std::atomic<Thread::ThreadID> audioThreadId;                                //!< thread of the last processBlock call
+    int64 lastBlockTicks;                                                       //!< start time of the last block
+    int maxRangeSize;                                                           //!< longest range renderRange is called with
+    AudioSampleBuffer panGains;                                                 //!< left and right master pan gains of the current range
+
+    //! moves the queued changes into scheduledEvents and maps their arrival times to sample offsets
+    int collectParamEvents(int numSamples);
+    //! applies all queued changes at once, only while the audio thread is not running
+    void flushParamEvents();
+    //! applies a queued change
+    void applyParamEvent(int index, float value);
+    //! renders the synth, fx and master stage for a part of the block
+    void renderRange(AudioSampleBuffer& buffer, MidiBuffer& midiMessages, int startSample, int numSamples);
 
     void updateHostInfo();
+    //! publishes the modulation of the newest voice for the editor
+    void publishModSnapshot();
+    //! the program list or the current program changed
+    void changeListenerCallback(ChangeBroadcaster* source) override;
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginAudioProcessor)
 };
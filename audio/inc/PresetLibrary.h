@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    PresetLibrary.h
+
+  ==============================================================================
+*/
+
+#ifndef PRESETLIBRARY_H_INCLUDED
+#define PRESETLIBRARY_H_INCLUDED
+
+#include "JuceHeader.h"
+#include "Param.h"
+#include <array>
+#include <vector>
+
+//! PresetLibrary Class: searchable index of the patch files in the preset folder
+/*! A background thread keeps an index file in the user application data folder up to date:
+    per patch the file, name, tags, a hash of the file content and a few key param values.
+    The index is memory mapped, so browsing and searching never parse a patch file and
+    opening the browser with thousands of patches costs nothing but the mapping.
+    The folder is checked every few seconds, only new and modified files are parsed, the
+    index is only rewritten when something changed. Listeners get a change message then.
+    All instances in all processes share the index: the checks are serialised by an
+    InterProcessLock, and a changed index is written as a new numbered file, because a file
+    that another process has mapped cannot be replaced on every platform. Every instance
+    maps the newest one, older files are deleted once nobody maps them anymore.
+    Entry indices are valid until the next change message.
+    Tags are the "tags" attribute of a patch (comma separated) and the names of the
+    subfolders it is in.
+*/
+class PresetLibrary : private Thread, public ChangeBroadcaster {
+public:
+    //! params whose values are kept in the index
+    enum eKeyParam {
+        eOscWaveform = 0,
+        eFilterCutoff,
+        eAttack,
+        eRelease,
+        nKeyParams
+    };
+
+    //! PresetLibrary constructor, nothing is read before startIndexing().
+    /*!
+    @param keyParams the params of eKeyParam, their IDs are read when indexing starts
+    */
+    explicit PresetLibrary(const std::array<const Param*, nKeyParams> &keyParams);
+    ~PresetLibrary();
+
+    //! folder the patches are saved to and indexed in
+    static File getPresetDirectory();
+    //! the newest index file, a nonexistent file if there is none yet
+    static File getIndexFile();
+
+    //! maps the last index and starts keeping it up to date, the first call starts the thread
+    void startIndexing();
+
+    //! amount of indexed files, including files that are no valid patches
+    int getNumPresets() const;
+    //! false if the file could not be read as a patch
+    bool isValid(int index) const;
+    String getName(int index) const;
+    String getTags(int index) const;
+    File getFile(int index) const;
+    //! 64 bit FNV-1a of the file content, equal for duplicates
+    uint64 getContentHash(int index) const;
+    //! value of a key param in UI units, NaN if the patch does not contain it
+    float getKeyValue(int index, eKeyParam keyParam) const;
+
+    //! finds the valid patches whose name, tags or file name contain all words of the query.
+    /*!
+    @param query words separated by spaces, case is ignored, empty for all patches
+    @param results receives the entry indices in index order
+    */
+    void search(const String &query, Array<int> &results) const;
+
+private:
+    struct Header;
+    struct Entry;
+    struct NewEntry;
+    struct WriterLock;
+
+    void run() override;
+
+    //! maps an index file, an invalid one is ignored. Call with indexLock held.
+    void mapIndex(const File &indexFile);
+    //! maps the newest index and writes a new one if the folder differs from it, true if either changed
+    bool update();
+    //! parses a patch file into an entry
+    NewEntry readPatch(const File &file, const File &directory) const;
+    //! writes the entries into a new index file and maps it
+    void writeIndex(const std::vector<NewEntry> &entries);
+    //! deletes the index files before the previous one, they fail while another process maps them
+    void deleteOldIndices() const;
+
+    const Entry* getEntry(int index) const;
+    const char* getString(uint32 offset) const;
+
+    const std::array<const Param*, nKeyParams> keyParams;
+    StringArray keyParamIds;                    //!< read when indexing starts, the prefixes are set then
+
+    SharedResourcePointer<WriterLock> writerLock;   //!< one index check at a time, in all instances and processes
+    CriticalSection indexLock;                  //!< guards the mapping, taken by the reader and the indexing thread
+    File mappedFile;                            //!< the index file last mapped, even if it was invalid
+    ScopedPointer<MemoryMappedFile> mappedIndex;
+    const char* data;                           //!< start of the mapped index, nullptr if there is none
+    size_t dataSize;
+    int numEntries;
+
+    JUCE_DECLARE_NON_COPYABLE(PresetLibrary)
+};
+
+#endif  // PRESETLIBRARY_H_INCLUDED
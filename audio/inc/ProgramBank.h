@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    ProgramBank.h
+
+  ==============================================================================
+*/
+
+#ifndef PROGRAMBANK_H_INCLUDED
+#define PROGRAMBANK_H_INCLUDED
+
+#include "JuceHeader.h"
+#include "SynthParams.h"
+#include <array>
+#include <atomic>
+
+//! ProgramBank Class: the presets of the Synister folder, ready to be switched to
+/*! The preset folder is parsed once per process on a background thread, when the first
+    instance asks for its programs, and all instances share the parsed files. Each instance
+    decodes a program into a PatchSnapshot when it is selected for the first time and keeps
+    it. Switching a program then only stores the prepared values: a host or a MIDI program
+    change selects it, the audio thread applies it at the start of the next block. A program
+    that is not decoded yet is decoded on the message thread first and applied a block later.
+    The patch name, the impulse response and the host notifications follow on the message
+    thread.
+*/
+class ProgramBank : private Timer, private ChangeListener, public ChangeBroadcaster {
+public:
+    static const int maxPrograms = 128;     //!< as many as a MIDI program change can address
+
+    //! ProgramBank constructor, the preset folder is not touched before the first query.
+    /*!
+    @param p params the presets are decoded for
+    */
+    explicit ProgramBank(SynthParams &p);
+    ~ProgramBank();
+
+    //! amount of programs found so far, starts indexing the preset folder
+    int getNumPrograms();
+    //! last program that was applied, -1 for none
+    int getCurrentProgram() const { return currentProgram.load(); }
+    //! name of a program, empty if it does not exist. Starts indexing the preset folder
+    String getProgramName(int index);
+
+    //! lets the audio thread switch to a program at the next block, any thread
+    void requestProgram(int index) { requestedProgram.store(index); }
+
+    //! switches to a program at once, message thread while the audio thread is not running
+    void applyProgram(int index);
+
+    //! starts indexing the preset folder so that MIDI program changes find their programs, not on the audio thread
+    void prepare();
+
+    //! applies a requested program or the last program change of the block, audio thread.
+    /*!
+    @param midiMessages incoming MIDI of the block
+    */
+    void beginBlock(const MidiBuffer &midiMessages);
+
+private:
+    //! a parsed preset file
+    struct Program {
+        String name;
+        String convIr;                          //!< impulse response path, empty if the patch has none
+        ScopedPointer<XmlElement> patch;
+    };
+
+    //! the parsed preset folder, one per process
+    class Presets : private Thread, public ChangeBroadcaster {
+    public:
+        Presets();
+        ~Presets();
+
+        //! starts parsing the preset folder, only the first call has an effect
+        void scan();
+        //! amount of programs parsed so far
+        int getNumPrograms() const { return numPrograms.load(); }
+        //! a program below getNumPrograms(), it does not change anymore
+        const Program& getProgram(int index) const { return *programs[static_cast<size_t>(index)]; }
+
+    private:
+        void run() override;
+
+        std::array<ScopedPointer<Program>, maxPrograms> programs;   //!< written before numPrograms is raised
+        std::atomic<int> numPrograms;
+        std::atomic<bool> scanStarted;
+
+        JUCE_DECLARE_NON_COPYABLE(Presets)
+    };
+
+    void timerCallback() override;
+    //! the shared presets found new programs
+    void changeListenerCallback(ChangeBroadcaster* source) override;
+
+    //! starts the scan and the polling timer on first use, not on the audio thread
+    void start();
+    //! the snapshot of a program, decoded on first use, message thread
+    const PatchSnapshot& getSnapshot(int index);
+    //! applies patch name, impulse response and host notifications of a program, message thread
+    void completeProgramChange(int index);
+
+    SynthParams &params;
+    SharedResourcePointer<Presets> presets;
+    std::array<std::atomic<PatchSnapshot*>, maxPrograms> snapshots;    //!< owned, set once by the message thread
+    std::atomic<bool> started;
+    std::atomic<int> currentProgram;
+    std::atomic<int> requestedProgram;          //!< -1 for none
+    std::atomic<int> undecodedProgram;          //!< requested before it was decoded, waits for the message thread
+    std::atomic<int> appliedProgram;            //!< applied by the audio thread, waits for completeProgramChange
+
+    JUCE_DECLARE_NON_COPYABLE(ProgramBank)
+};
+
+#endif  // PROGRAMBANK_H_INCLUDED
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    RealtimeGuard.h
+
+  ==============================================================================
+*/
+
+#ifndef REALTIMEGUARD_H_INCLUDED
+#define REALTIMEGUARD_H_INCLUDED
+
+#include "JuceHeader.h"
+#include <atomic>
+
+//! compiles the realtime checks, on by default in debug builds
+#ifndef SYNISTER_REALTIME_CHECKS
+ #define SYNISTER_REALTIME_CHECKS JUCE_DEBUG
+#endif
+
+//! RealtimeGuard Class: reports allocations and locks on the audio thread
+/*! While a Scope exists on a thread, every heap allocation, deallocation and mutex lock of
+    that thread is reported with its call stack to stderr, once per call site.
+    The hooks are only compiled into the standalone application, a plugin binary must not
+    replace the allocator of its host. Allocations are caught by replacing the global
+    operator new and delete. On Linux malloc, free and pthread_mutex_lock are interposed
+    instead, which also catches allocations inside C code and all locks taken by JUCE
+    (CriticalSection, MidiKeyboardState, MidiBuffer growth).
+    "standalone --realtime-check" renders a scripted scenario and exits with 1 on a
+    violation. If the environment variable SYNISTER_RT_ABORT is set the process aborts on
+    the first violation, also while playing live.
+    Without SYNISTER_REALTIME_CHECKS all of this compiles to nothing.
+*/
+class RealtimeGuard {
+public:
+    //! kinds of violations
+    enum eViolation : int {
+        eAllocation = 0,
+        eDeallocation,
+        eLock,
+        nViolations
+    };
+
+    //! marks the current thread as realtime for its lifetime, can be nested
+    class Scope {
+    public:
+#if SYNISTER_REALTIME_CHECKS
+        Scope() { enter(); }
+        ~Scope() { leave(); }
+#else
+        Scope() {}
+#endif
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+    //! permits allocations and locks inside a Scope, for code paths that are known and accepted
+    class ScopedAllow {
+    public:
+#if SYNISTER_REALTIME_CHECKS
+        ScopedAllow() { allow(true); }
+        ~ScopedAllow() { allow(false); }
+#else
+        ScopedAllow() {}
+#endif
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE(ScopedAllow)
+    };
+
+    //! called by the hooks, reports if the current thread is inside a Scope
+    static void check(eViolation type)
+    {
+#if SYNISTER_REALTIME_CHECKS
+        if (isActive()) {
+            report(type);
+        }
+#else
+        ignoreUnused(type);
+#endif
+    }
+
+    //! amount of violations since program start, including repeated ones
+    static int getNumViolations();
+
+private:
+#if SYNISTER_REALTIME_CHECKS
+    static void enter();
+    static void leave();
+    static void allow(bool allowed);
+    static bool isActive();
+    static void report(eViolation type);
+#endif
+};
+
+#endif  // REALTIMEGUARD_H_INCLUDED
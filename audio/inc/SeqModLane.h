@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    SeqModLane.h
+
+  ==============================================================================
+*/
+
+#ifndef SEQMODLANE_H_INCLUDED
+#define SEQMODLANE_H_INCLUDED
+
+#include "JuceHeader.h"
+#include <array>
+
+//! SeqModLane Class: the modulation lane of the step sequencer as a per-sample mod source
+/*! The sequencer hands over the lane value of every step it plays together with the sample
+    of the step edge. Like a ParamRamp the values are rendered once per range into a buffer
+    that all voices read through the mod matrix, with a short smoothing so that the steps do
+    not click. Without playing sequencer the value returns to 0.
+*/
+class SeqModLane {
+public:
+    static const int maxStepsPerBlock = 64;    //!< later steps of a block only keep the last value
+
+    SeqModLane();
+
+    //! allocates the value buffer and jumps to 0.
+    /*!
+    @param sampleRate the current sample rate
+    @param maxNumSamples the longest range that will be rendered
+    */
+    void init(double sampleRate, int maxNumSamples);
+
+    //! forgets the steps of the last block, call before the sequencer runs
+    void beginBlock();
+
+    //! a step edge of the current block.
+    /*!
+    @param sample offset of the edge in the block, in increasing order
+    @param value lane value in [-1..1]
+    */
+    void addStep(int sample, float value);
+
+    //! fills the buffer with the values of the given range, called for every range of the block
+    void render(int startSample, int numSamples);
+
+    //! values of the last rendered range.
+    /*!
+    @param startSample a sample inside the last rendered range
+    @returns pointer to the value at startSample
+    */
+    const float* getValues(int startSample) const
+    {
+        jassert(startSample >= rangeStart && startSample - rangeStart <= capacity);
+        return values + (startSample - rangeStart);
+    }
+
+    //! value after the last rendered range.
+    float getCurrent() const { return current; }
+
+private:
+    struct Step {
+        int sample;
+        float value;
+    };
+
+    HeapBlock<float> values;    //!< values of the last rendered range and the value after it
+    int capacity;               //!< longest range
+    int rangeStart;             //!< first sample of the last rendered range
+    float current;              //!< smoothed value
+    float target;               //!< value of the playing step
+    float coeff;                //!< one-pole smoothing coefficient
+
+    std::array<Step, maxStepsPerBlock> steps;   //!< step edges of the current block
+    int numSteps;
+    int nextStep;               //!< first step edge that is not rendered yet
+
+    JUCE_DECLARE_NON_COPYABLE(SeqModLane)
+};
+
+#endif  // SEQMODLANE_H_INCLUDED
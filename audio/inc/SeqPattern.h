@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    SeqPattern.h
+
+  ==============================================================================
+*/
+
+#ifndef SEQPATTERN_H_INCLUDED
+#define SEQPATTERN_H_INCLUDED
+
+#include "JuceHeader.h"
+#include <array>
+#include <atomic>
+
+//! SeqPattern Class: the steps of the step sequencer with all their lanes
+/*! Every step is packed into one atomic word, so the audio thread reads a step in one load
+    and always sees consistent lanes while the GUI edits. The whole pattern is 512 bytes.
+    In patches only the steps up to the last one that differs from the defaults are stored,
+    five bytes per step.
+*/
+class SeqPattern {
+public:
+    static const int maxSteps = 64;
+
+    //! values every step has
+    enum eLane {
+        eNote = 0,      //!< midi note in [0..127]
+        eVelocity,      //!< midi velocity in [1..127]
+        eGate,          //!< note length in percent of the sequencer note length, [1..100]
+        eProbability,   //!< chance the step plays in percent, [0..100]
+        eMod,           //!< modulation value in percent, [-100..100]
+        nLanes
+    };
+
+    //! the unpacked values of a step
+    struct Step {
+        int lanes[nLanes];
+        bool active;        //!< false if the step is muted
+    };
+
+    //! the packed steps, as copied into patch snapshots
+    typedef std::array<uint64, maxSteps> Data;
+
+    SeqPattern();
+
+    Step getStep(int step) const;
+    void setStep(int step, const Step &s);
+
+    int getValue(int step, eLane lane) const;
+    //! sets one lane of a step, the value is clamped to the lane range
+    void setValue(int step, eLane lane, int value);
+
+    bool isActive(int step) const;
+    void setActive(int step, bool active);
+
+    static int getMinValue(eLane lane);
+    static int getMaxValue(eLane lane);
+    //! the default of a step, the notes repeat the scale of the first eight steps
+    static Step getDefaultStep(int step);
+
+    //! all steps in packed form, lock-free
+    void getData(Data &data) const;
+    void setData(const Data &data);
+    static void getDefaultData(Data &data);
+
+    //! writes the steps up to the last one that differs from the defaults
+    void writeToStream(OutputStream &out) const;
+    //! reads steps written by writeToStream(), the remaining steps get their defaults
+    static bool readFromStream(InputStream &in, Data &data);
+
+    //! writeToStream() as base 64 for XML patches
+    String toBase64() const;
+    static bool fromBase64(const String &text, Data &data);
+
+private:
+    static uint64 pack(const Step &s);
+    static Step unpack(uint64 packed);
+    static int clampStep(int step) { return jlimit(0, maxSteps - 1, step); }
+
+    std::array<std::atomic<uint64>, maxSteps> steps;
+
+    JUCE_DECLARE_NON_COPYABLE(SeqPattern)
+};
+
+#endif  // SEQPATTERN_H_INCLUDED
@@ -62,27 +62,40 @@ public:
     void playRandom(bool play);
     //==============================================================================
     /**
-    * Generate a random sequence by setting each step random.
+    * Generate a random sequence by setting the note of each of the SeqPattern::maxSteps steps random.
       The lowest and highest random note can be set with provided functions.
     */
     void generateRandomSeq();
 
     /**
     * Set a specific step note as random. The lowest and highest random note can be set with provided functions.
-    @param step the (step+1)th sequence note in range of [0..7]
+    @param step the (step+1)th sequence note in range of [0..63]
     */
     void setStepRandom(int step);
 
+    /**
+    * Set the midi note of a step. The first eight steps are set through their params.
+    @param step in range of [0..63]
+    @param note in range of [0..127]
+    */
+    void setStepNote(int step, int note);
+
+    /**
+    * Set a lane value of a step, see SeqPattern::eLane for the ranges.
+    @param step in range of [0..63]
+    */
+    void setStepValue(int step, SeqPattern::eLane lane, int value);
+
     /**
     * Function to set a specific step as activated or mute.
-    @param step the (step+1)th sequence note in range of [0..7]
+    @param step the (step+1)th sequence note in range of [0..63]
     @param active false->mute
     */
     void setStepActive(int step, bool active);
 
     /**
     * Set the number of steps for the sequencer.
-    @param numSteps in range of [1..8]
+    @param numSteps in range of [1..64]
     */
     void setNumSteps(int numSteps);
 
@@ -132,21 +145,27 @@ public:
     void setRandMax(int max);
     //==============================================================================
     /**
-    * Get the last played sequence step in range [0..7]. Can be used to dispay playing position in GUI.
+    * Get the last played sequence step in range [0..63]. Can be used to dispay playing position in GUI.
     */
     int getLastSeqNote();
 
     /**
-    * Get the current number of steps in use for the stepSequencee in range [1..8]
+    * Get the current number of steps in use for the stepSequencee in range [1..64]
     */
     int getNumStep();
 
     /**
     * Get the midi note value of a specific step.
-    @param step in range [0..7]
+    @param step in range [0..63]
     */
     int getStepNoteAsInt(int step);
 
+    /**
+    * Get a lane value of a specific step, see SeqPattern::eLane for the ranges.
+    @param step in range [0..63]
+    */
+    int getStepValue(int step, SeqPattern::eLane lane);
+
     /**
     * Get the midi note value of the current minimum random note.
     */
@@ -159,7 +178,7 @@ public:
 
     /**
     * Get the note name as a string of a specific step by using MidiMessage::getMidiNoteName().
-    @param step in range [0..7]
+    @param step in range [0..63]
     @param sharps if true use sharps and flats
     @octaveNumber if true display octave number
     @middleC number to use for middle c
@@ -221,40 +240,39 @@ public:
 
     /**
     * Is true if specific step is activated and should play.
-    @param step in range [0..7]
+    @param step in range [0..63]
     */
     bool isStepActive(int step);
 
 private:
     //==============================================================================
     void seqNoHostSync(MidiBuffer& midiMessages, int bufferSize, double sampleRate);
-    void seqHostSync(MidiBuffer& midiMessages);
+    void seqHostSync(MidiBuffer& midiMessages, int bufferSize, double sampleRate);
+    void playSegment(MidiBuffer& midiMessages, double ppqStart, int startSample, int endSample, double samplesPerPpq);
+    void relocate(MidiBuffer& midiMessages, double ppq, int sample);
+    int getStepOfCount(int64 stepCount) const;
     void sendMidiNoteOffMessage(MidiBuffer& midiMessages, int sample);
-    void sendMidiNoteOnMessage(MidiBuffer& midiMessages, int sample);
-    void midiNoteChanged(MidiBuffer& midiMessages);
+    void sendMidiNoteOnMessage(MidiBuffer& midiMessages, int sample, const SeqPattern::Step& step);
     void stopSeq(MidiBuffer& midiMessages);
     //==============================================================================
     SynthParams &params;
 
-    // StepSequencer gui params
-    std::array<int, 8> prevMidiStepSeq;
+    // StepSequencer gui params, the note and on/off of the first steps in the pattern
     std::array<Param*, 8> currMidiStepSeq;
-    std::array<eOnOffToggle, 8> prevStepOnOff;
     std::array<ParamStepped<eOnOffToggle>*, 8> currStepOnOff;
     float seqStepSpeed;
     double seqStepLength;
     int seqNumSteps;
 
-    // internal StepSequencer variables
+    // internal StepSequencer variables, all positions in quarter notes
     int currSeqNote;
-    int lastPlayedNote;
-    int seqNoteAdd;
-    int nextPlaySample;
-    int noteOffSample;
-    double seqNextStep;
-    double stopNoteTime;
-    double lastPlayHeadPosition;
+    int lastPlayedNote;         //!< note of the sounding step, -1 if it sent none
+    int64 nextStepCount;        //!< steps from ppq 0 to the next step to play
+    double noteOffPpq;          //!< end of the playing note, may lie in a later block
+    double expectedPpq;         //!< end of the last block, the next block starts here unless the host jumped
+    float lastStepSpeed;        //!< step speed of the last block, the step count is rebuilt when it changes
     bool seqNoteIsPlaying;
     bool seqStopped;
+    Random random;  //!< seeded once, reseeding on the audio thread queries the system clock
 };
 #endif  // STEPSEQUENCER_H_INCLUDED
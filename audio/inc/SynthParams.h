@@ -2,6 +2,12 @@
 
 #include "JuceHeader.h"
 #include "Param.h"
+#include "ParamRamp.h"
+#include "PatchSnapshot.h"
+#include "PresetLibrary.h"
+#include "SeqModLane.h"
+#include "ModSlots.h"
+#include "ModSnapshot.h"
 #include <vector>
 #include <array>
 #include "ModulationMatrix.h"
@@ -52,11 +58,79 @@ enum class eSeqPlayModes : int {
     nSteps = 3
 };
 
+enum class eArpModes : int {
+    eUp = 0,
+    eDown = 1,
+    eUpDown = 2,
+    eRandom = 3,
+    eAsPlayed = 4,
+    nSteps = 5
+};
+
+enum class eGlobalModSource : int {
+    eNone = 0,
+    eGlobalLfo1 = 1,
+    eGlobalLfo2 = 2,
+    eSeqLane = 3,
+    eModwheel = 4,
+    eFoot = 5,
+    eExpPedal = 6,
+    nSteps = 7
+};
+
+enum class eGlobalModDest : int {
+    eNone = 0,
+    eMasterAmp = 1,
+    eMasterPan = 2,
+    eDelayTime = 3,
+    eDelayFeedback = 4,
+    eChorusDepth = 5,
+    eClipping = 6,
+    eLowFiBits = 7,
+    nSteps = 8
+};
+
+enum class eFxSlots : int {
+    eLowFi = 0,
+    eClipping = 1,
+    eDelay = 2,
+    eChorus = 3,
+    eReverb = 4,
+    eConvolution = 5,
+    nSteps = 6
+};
+
 
 struct MidiState {
     MidiState()
     {
         std::fill(values.begin(), values.end(), 0);
+        for (ChannelExpression &c : channels) {
+            c.pitchBend = 8192;
+            c.pressure = 0;
+            c.slide = 0;
+        }
+    }
+
+    static const int numChannels = 16;
+    //! MPE master channel of the lower zone
+    static const int masterChannel = 1;
+
+    //! last expression values of a midi channel, with MPE the expression of the note on it
+    struct ChannelExpression {
+        int pitchBend;  //!< 14 bit, 8192 is the centre
+        int pressure;   //!< channel pressure in [0..127]
+        int slide;      //!< CC 74 in [0..127]
+    };
+
+    //! expression of a channel in [1..16]
+    const ChannelExpression& getChannel(int midiChannel) const {
+        jassert(midiChannel >= 1 && midiChannel <= numChannels);
+        return channels[static_cast<size_t>(jlimit(1, numChannels, midiChannel) - 1)];
+    }
+    ChannelExpression& getChannel(int midiChannel) {
+        jassert(midiChannel >= 1 && midiChannel <= numChannels);
+        return channels[static_cast<size_t>(jlimit(1, numChannels, midiChannel) - 1)];
     }
 
     enum eMsg : int {
@@ -67,18 +141,32 @@ struct MidiState {
         nSteps
     };
 
-    float get(eMsg e) const {
+    //! sets a 7 bit value or the MSB of a 14 bit controller, a following LSB refines it
+    void setMsb(eMsg e, int value) {
         jassert(e >= eAftertouch && e < nSteps);
-        return static_cast<float>(values[e]);
+        values[e] = (value & 0x7f) << 7;
     }
 
-    std::array<int, eMsg::nSteps> values;
+    //! sets the LSB of a 14 bit controller (CC 32-63)
+    void setLsb(eMsg e, int value) {
+        jassert(e >= eAftertouch && e < nSteps);
+        values[e] = (values[e] & ~0x7f) | (value & 0x7f);
+    }
+
+    //! value in [0..1), a 7 bit value v gives v / 128
+    float getNormalized(eMsg e) const {
+        jassert(e >= eAftertouch && e < nSteps);
+        return static_cast<float>(values[e]) / 16384.f;
+    }
+
+    std::array<int, eMsg::nSteps> values;                   //!< 14 bit
+    std::array<ChannelExpression, numChannels> channels;    //!< written by the synth, read by the voices, audio thread only
 };
 
 class SynthParams {
 public:
     SynthParams();
-    ~SynthParams();
+    virtual ~SynthParams();
 
     static const Colour oscColour;
     static const Colour envColour;
@@ -86,6 +174,7 @@ public:
     static const Colour filterColour;
     static const Colour fxColour;
     static const Colour stepSeqColour;
+    static const Colour modSlotsColour;
     static const Colour onOffSwitchEnabled;
     static const Colour onOffSwitchDisabled;
     static const Colour envelopeCurveLine;
@@ -95,6 +184,10 @@ public:
     static const Colour otherModulation;
 
     static const char* getModSrcName(int index);
+    //! name of a mod destination, "None" for DEST_NONE
+    static const char* getModDestName(int index);
+
+    ParamStore store; //!< values of all params, must be declared before them
 
     ParamDb masterAmp; //!< master volume
     Param masterPan; //!< master pan
@@ -114,7 +207,7 @@ public:
     };
 
     struct EnvBase : public BaseParamStruct {
-        EnvBase();
+        EnvBase(ParamStore &store);
         Param attack;    //!< env attack in [0.001..5]s
         Param decay;     //!< env decay in [0.001..5]s
         Param release;   //!< env release in [0.001..5]s (logarithmic scaling)
@@ -143,7 +236,7 @@ public:
     };
 
     struct EnvVol : public EnvBase {
-        EnvVol();
+        EnvVol(ParamStore &store);
         ParamDb sustain;   //!< Envelope sustain in [-96..0] dB
 
         void setName(const String& s) {
@@ -153,7 +246,7 @@ public:
     };
 
     struct Env : public EnvBase {
-        Env();
+        Env(ParamStore &store);
         Param sustain; //!< Envelope sustain in [0..1]
 
         void setName(const String& s) {
@@ -163,7 +256,7 @@ public:
     };
 
     struct Lfo : public BaseParamStruct {
-        Lfo();
+        Lfo(ParamStore &store);
         Param freq; //!< lfo frequency in Hz
         ParamStepped<eOnOffToggle> tempSync; //!< bool if checked or not
         ParamStepped<eOnOffToggle> lfoTriplets; //!< bool for triplet toggle in lfo
@@ -197,7 +290,7 @@ public:
     };
 
     struct Filter : public BaseParamStruct {
-        Filter();
+        Filter(ParamStore &store);
 
         ParamStepped<eBiquadFilters> passtype; //!< passtype that decides whether lowpass, highpass or bandpass filter is used
         Param lpCutoff; //!< filter cutoff frequency in Hz
@@ -217,6 +310,9 @@ public:
         ParamStepped<eModSource> resonanceModSrc1;  //! biquad filter resonance modulation source
         ParamStepped<eModSource> resonanceModSrc2;  //! biquad filter resonance modulation source
         ParamStepped<eOnOffToggle> filterActivation; //!< Activation of the filter
+        ParamRamp lpCutoffRamp; //!< smoothed lpCutoff
+        ParamRamp hpCutoffRamp; //!< smoothed hpCutoff
+        ParamRamp resonanceRamp; //!< smoothed resonance
 
         void setName(const String& s) {
             BaseParamStruct::setName(s);
@@ -241,7 +337,7 @@ public:
     };
 
     struct Osc : public BaseParamStruct {
-        Osc();
+        Osc(ParamStore &store);
         Param fine;      //!< fine tune in [-100..100] ct
         Param coarse;    //!< coarse tune in [-11..11] st
         ParamStepped<eOscWaves> waveForm; //! waveform of the oscillator, it can be either square, saw, or noise
@@ -268,6 +364,9 @@ public:
         ParamStepped<eModSource> gainModSrc2; //!< gain mod source
         
         ParamStepped<eOnOffToggle> oscActivation; //!< toggle osc activation
+        ParamRamp volRamp; //!< smoothed vol
+        ParamRamp panDirRamp; //!< smoothed panDir
+        ParamRamp pulseWidthRamp; //!< smoothed pulseWidth
 
         void setName(const String& s) {
             BaseParamStruct::setName(s);
@@ -298,11 +397,41 @@ public:
         }
     };
 
+    //! free running lfo of the global modulation bus
+    struct GlobalLfo : public BaseParamStruct {
+        GlobalLfo(ParamStore &store);
+        Param freq; //!< lfo frequency in Hz
+        ParamStepped<eLfoWaves> wave; //!< lfo waveform
+
+        void setName(const String& s) {
+            BaseParamStruct::setName(s);
+            freq.setPrefix(s);
+            wave.setPrefix(s);
+        }
+    };
+
+    //! slot of the global modulation bus, modulates an effect or master param
+    struct GlobalModSlot : public BaseParamStruct {
+        GlobalModSlot(ParamStore &store);
+        ParamStepped<eGlobalModSource> source;      //!< mod source
+        ParamStepped<eGlobalModDest> destination;   //!< modulated param
+        Param amount;   //!< mod amount in percent of the destination range, [-100..100]
+
+        void setName(const String& s) {
+            BaseParamStruct::setName(s);
+            source.setPrefix(s);
+            destination.setPrefix(s);
+            amount.setPrefix(s);
+        }
+    };
+
     std::array<Filter, 2> filter;
     std::array<Lfo, 3> lfo;
     std::array<EnvVol, 1> envVol;
     std::array<Env, 2> env;
     std::array<Osc, 3> osc;
+    std::array<GlobalLfo, 2> globalLfo;
+    std::array<GlobalModSlot, 4> globalModSlot;
 
     ParamStepped<eSectionState> oscSection;
     ParamStepped<eSectionState> envSection;
@@ -310,6 +439,8 @@ public:
     ParamStepped<eSectionState> filterSection;
     ParamStepped<eSectionState> fxSection;
     ParamStepped<eSectionState> seqSection;
+    ParamStepped<eSectionState> arpSection;
+    ParamStepped<eSectionState> modSlotsSection;
     
     ParamDb clippingFactor;     //!< overdrive factor of the amplitude of the signal in [0..30] dB
     ParamStepped<eOnOffToggle> clippingActivation; //!< Activation of the clipping effect
@@ -320,19 +451,30 @@ public:
     Param chorModDepth;
     ParamStepped<eOnOffToggle> chorActivation; //!< Activation of the chorus effect
 
+    Param revSize;          //!< reverb room size in [0..1], scales the delay line lengths
+    Param revDecay;         //!< reverb decay time (-60 dB) in [0.1..20] s
+    Param revDamping;       //!< reverb high frequency damping in [0..1]
+    Param revPredelay;      //!< reverb predelay in [0..200] ms
+    Param revDryWet;        //!< reverb wet signal
+    ParamStepped<eOnOffToggle> revActivation; //!< Activation of the reverb effect
+
+    Param convDryWet;       //!< convolution wet signal
+    ParamStepped<eOnOffToggle> convActivation; //!< Activation of the convolution effect
+    String convIrPath = ""; //!< impulse response file of the convolution effect
+
     Param seqPlaceHolder;                       //!< placeholder for register slider with exactly two thumb slider, value as int in [0..127]
     ParamStepped<eOnOffToggle> seqPlayNoHost;   //!< play without host? 0 = no, 1 = yes
     ParamStepped<eOnOffToggle> seqPlaySyncHost; //!< play synced with host? 0 = no, 1 = yes
     ParamStepped<eSeqPlayModes> seqPlayMode;    //!< 0 = sequential, 1 = upDown, 2 = random
-    Param seqLastPlayedStep;                    //!< index of last played sequencer step in [0..7]
-    Param seqNumSteps;                          //!< number of steps in [1..8] steps
+    Param seqLastPlayedStep;                    //!< index of last played sequencer step in [0..63]
+    Param seqNumSteps;                          //!< number of steps in [1..64] steps
     Param seqStepSpeed;                         //!< step speed in 1/[1 .. 64]
     Param seqStepLength;                        //!< step length in 1/[1 .. 64]
     ParamStepped<eOnOffToggle> seqTriplets;     //!< activate triplet tempo? 0 = no, 1 = active
     ParamStepped<eOnOffToggle> seqDottedLength;       //!< activate dotted tempo? 0 = no, 1 = active
     Param seqRandomMin;                         //!< randomMin value as int in [0..127]
     Param seqRandomMax;                         //!< randomMax value as int in [0..127]
-    Param seqStep0;                             //!< midi note as int in [0..127]
+    Param seqStep0;                             //!< midi note of the first pattern step as int in [0..127]
     Param seqStep1;
     Param seqStep2;
     Param seqStep3;
@@ -348,11 +490,22 @@ public:
     ParamStepped<eOnOffToggle> seqStepActive5;
     ParamStepped<eOnOffToggle> seqStepActive6;
     ParamStepped<eOnOffToggle> seqStepActive7;
+    SeqPattern seqPattern;                      //!< all steps and lanes, note and on/off of the first eight steps follow the params above
+    SeqModLane seqModLane;                      //!< mod lane values of the playing steps, the eSeqMod source of the voices
+
+    ParamStepped<eOnOffToggle> arpActivation;   //!< arpeggiator on? the held notes are replaced by the arpeggio
+    ParamStepped<eArpModes> arpMode;            //!< order of the arpeggio notes
+    Param arpOctaves;                           //!< octave range of the arpeggio in [1..4]
+    Param arpSpeed;                             //!< note speed in 1/[1 .. 64]
+    Param arpGate;                              //!< note length in percent of the note speed, [1..100]
+
+    ParamStepped<eOnOffToggle> mpeActivation;   //!< MPE lower zone? channel 1 is the master channel, every note has its own channel
 
     ParamStepped<eOnOffToggle> lowFiActivation; //!< Activation of the low fidelity effect
     Param nBitsLowFi; //!< Bit degradation
 
     ModulationMatrix globalModMatrix;
+    ModSlots modSlots;                          //!< user slots of the matrix, compiled into globalModMatrix every block
     MidiKeyboardState keyboardState;
     MidiState midiState;
 
@@ -371,11 +524,38 @@ public:
     ParamStepped<eOnOffToggle> delayActivation;     //!< delay activation
     ParamStepped<eOnOffToggle> syncToggle;          //!< delay sync toggle
 
+    ParamStepped<eFxSlots> fxSlot0;     //!< effect processed first in the fx chain
+    ParamStepped<eFxSlots> fxSlot1;     //!< effect processed second in the fx chain
+    ParamStepped<eFxSlots> fxSlot2;     //!< effect processed third in the fx chain
+    ParamStepped<eFxSlots> fxSlot3;     //!< effect processed fourth in the fx chain
+    ParamStepped<eFxSlots> fxSlot4;     //!< effect processed fifth in the fx chain
+    ParamStepped<eFxSlots> fxSlot5;     //!< effect processed last in the fx chain
+
+    ParamRamp masterAmpRamp;        //!< smoothed masterAmp
+    ParamRamp masterPanRamp;        //!< smoothed masterPan
+    ParamRamp delayFeedbackRamp;    //!< smoothed delayFeedback
+    ParamRamp delayDryWetRamp;      //!< smoothed delayDryWet
+    ParamRamp chorDryWetRamp;       //!< smoothed chorDryWet
+    ParamRamp revDryWetRamp;        //!< smoothed revDryWet
+    ParamRamp convDryWetRamp;       //!< smoothed convDryWet
+    ParamRamp clippingFactorRamp;   //!< smoothed clippingFactor
+    ParamRamp delayTimeRamp;        //!< smoothed delayTime
+    ParamRamp chorModDepthRamp;     //!< smoothed chorModDepth
+    ParamRamp nBitsLowFiRamp;       //!< smoothed nBitsLowFi
+    ParamRamp delayCutoffRamp;      //!< smoothed delayCutoff
+    ParamRamp revDecayRamp;         //!< smoothed revDecay
+    ParamRamp revDampingRamp;       //!< smoothed revDamping
+
+    // list of smoothed params, the processor renders them once for every range before the voices and fx
+    std::vector<ParamRamp*> rampParams; //!< vector of ramps to be rendered
+
     // list of current params, just add your new param here if you want it to be serialized
     std::vector<Param*> serializeParams; //!< vector of params to be serialized
     // list of only stepSeq params
     std::vector<Param*> stepSeqParams;
 
+    PresetLibrary presetLibrary; //!< index of the preset folder for the browser, started on first use
+
 
     String patchName = "";
     bool patchNameDirty = false;
@@ -383,8 +563,27 @@ public:
 
     static Colour getModSourceColour(eModSource source);
 
+    /**
+    * Copy the note and on/off params of the first eight steps into the sequencer pattern, they are
+    * the host automatable part of it. Called by the sequencer every block and before saving.
+    */
+    void updateSeqPattern();
+
     static String getShortModSrcName(int index);
 
+    /**
+    * Set the impulse response file of the convolution effect. The processor overrides this to start loading the file.
+    @param path full path of the audio file, empty for none
+    */
+    virtual void loadImpulseResponse(const String& path);
+
+    /**
+    * Apply a decoded patch. Here the values are set at once, the processor overrides this to
+    * hand the snapshot to the audio thread.
+    @param snapshot the decoded patch, ownership is taken
+    */
+    virtual void applyPatch(PatchSnapshot* snapshot);
+
     /**
     * Store host state by creating XML file to serialize specified parameters by using writeXMLPatchTree().
     @param destData host data
@@ -399,20 +598,35 @@ public:
     void writeXMLPatchStandalone(eSerializationParams paramsToSerialize);
 
     /**
-    * Set the parameters if they exist in the XML patch.
-    @param patch XML patch to work on
-    @param paramName name to check whether parameter exist in XML patch
-    @param param parameter to set
+    * Store host state in the binary patch format, see readBinaryPatchHost().
+    @param destData host data
     */
-    void fillValueIfExists(XmlElement * patch, String paramName, Param& param);
+    void writeBinaryPatchHost(MemoryBlock& destData);
 
     /**
-    * Iterate over specified parameters and set the values in the xml by using fillValueIfExists().
+    * Restore host state from the binary patch format. Every entry is found by the hash of the
+    * param ID, in the common case of an unchanged param order directly at its index.
+    @param data binary data
+    @param sizeInBytes data size
+    @return false if the data is not a binary patch, e.g. an XML state of an older version
+    */
+    bool readBinaryPatchHost(const void * data, int sizeInBytes);
+
+    /**
+    * Iterate over specified parameters and set the values that exist in the xml.
     @param patch XML patch to work on
     @param paramsToSerialize specify which parameters should be used (all or only sequencer parameters)
     */
     void fillValues(XmlElement * patch, eSerializationParams paramsToSerialize);
 
+    /**
+    * Read the param values of an XML patch without applying them, can be called from any thread.
+    @param patch XML patch to read
+    @param paramsToSerialize specify which parameters should be used (all or only sequencer parameters)
+    @return the decoded values, the caller takes ownership
+    */
+    PatchSnapshot* decodeXMLPatch(const XmlElement& patch, eSerializationParams paramsToSerialize);
+
     /**
     * Restore host state by converting binary data into a XML file and set serialized parameters by using fillValues().
     @param data binary data to return to XML
@@ -422,7 +636,14 @@ public:
     void readXMLPatchHost(const void * data, int sizeInBytes, eSerializationParams paramsToSerialize);
 
     /**
-    * Read XML file to set serialized parameters by using fillValues().
+    * Read an XML patch file to set serialized parameters by using fillValues().
+    @param file the patch file
+    @param paramsToSerialize specify which parameters should be used (all or only sequencer parameters)
+    */
+    void readXMLPatchFile(const File& file, eSerializationParams paramsToSerialize);
+
+    /**
+    * Let the user choose an XML file to set serialized parameters by using readXMLPatchFile().
     @param paramsToSerialize specify which parameters should be used (all or only sequencer parameters)
     */
     void readXMLPatchStandalone(eSerializationParams paramsToSerialize);
@@ -434,10 +655,30 @@ public:
     int getGUIIndex();
     int getAudioIndex();
 
+    ModSnapshot modSnapshot;    //!< modulation of the newest voice, published once per block for the editor
+
 protected:
 private:
+    //! param of the binary patch format together with the hash of its ID
+    struct IdEntry {
+        uint32 idHash;
+        Param* param;
+    };
+
     void addElement(XmlElement* patch, String name, float value); // adds an element to the XML tree
 
+    static uint32 hashId(const String& id); // FNV-1a of the UTF-8 ID
+
+    /**
+    * Build the ID hashes of the serialized params on first use.
+    @return hashes in the order of serializeParams, params without serialization tag are left out
+    */
+    const std::vector<IdEntry>& getIdEntries();
+
+    std::vector<IdEntry> idEntries;         //!< hashes in serialization order
+    std::vector<IdEntry> sortedIdEntries;   //!< the same entries, sorted by hash for lookup
+    CriticalSection idEntriesLock;
+
     /**
     * Write the XML patch tree for parameters to be serialized.
     @param patch XML patch to work on
@@ -32,36 +32,79 @@ struct Lfo {
     }
 };
 
+//! per sample values of a midi expression of a voice, glides to the last received value
+struct MidiExpression {
+    MidiExpression(int blockSize)
+        : buffer(1, blockSize)
+        , current(0.f)
+        , target(0.f)
+    {
+    }
+    AudioSampleBuffer buffer;
+    float current;
+    float target;
+
+    //! jumps to the value, e.g. at the start of a note
+    void reset(float value) {
+        current = target = value;
+        buffer.setSample(0, 0, value);
+    }
+
+    //! fills the first numSamples values with a one-pole glide to the target
+    const float* render(int numSamples, float coeff) {
+        float *values = buffer.getWritePointer(0);
+        if (current == target) {
+            FloatVectorOperations::fill(values, current, numSamples);
+            return values;
+        }
+        for (int s = 0; s < numSamples; ++s) {
+            current += (target - current) * coeff;
+            values[s] = current;
+        }
+        if (std::abs(target - current) < 1e-5f) {
+            current = target;
+        }
+        return values;
+    }
+};
+
 class Voice : public SynthesiserVoice {
 public:
     Voice(SynthParams &p, int blockSize)
     : params(p)
+    , totalVoiceSamples(0)
+    , lastRangeSamples(0)
+    , lfo({ { { blockSize},{ blockSize },{ blockSize } } })
     , filter({ { {p.filter[0],p.filter[1] },{ p.filter[0],p.filter[1] },{ p.filter[0],p.filter[1] } } })
-    , envToVolume(p.envVol[0], p.envVol[0].sustain, getSampleRate())
-    , env2(p.env[0], p.env[0].sustain, getSampleRate())
-    , env3(p.env[1], p.env[1].sustain, getSampleRate())
+    , midiChannel(1)
+    , expressions({ { { blockSize },{ blockSize },{ blockSize },{ blockSize },{ blockSize },{ blockSize } } })
     , modMatrix(p.globalModMatrix)
+    , zeroMod(0.f)
+    , modDestBuffer(destinations::MAX_DESTINATIONS, blockSize)
+    , neutralModBuffer(eNeutralMods, blockSize)
     , envToVolBuffer(1, blockSize)
     , env2Buffer(1, blockSize)
     , env3Buffer(1, blockSize)
-    , zeroMod(0.f)
-    , totalVoiceSamples(0)
-    , modDestBuffer(destinations::MAX_DESTINATIONS, blockSize)
-    , lfo({ { { blockSize},{ blockSize },{ blockSize } } })
+    , envToVolume(p.envVol[0], p.envVol[0].sustain, getSampleRate())
+    , env2(p.env[0], p.env[0].sustain, getSampleRate())
+    , env3(p.env[1], p.env[1].sustain, getSampleRate())
     {
         std::fill(modSources.begin(), modSources.end(), &zeroMod);
         std::fill(modDestinations.begin(), modDestinations.end(), nullptr);
+        usedSources.fill(false);
+
+        // read instead of the destinations that no row modulates
+        neutralModBuffer.clear(eNeutralZero, 0, blockSize);
+        FloatVectorOperations::fill(neutralModBuffer.getWritePointer(eNeutralOne), 1.f, blockSize);
 
         //set connection bewtween source and matrix here
         // midi
-        modSources[eModSource::eAftertouch] = &channelAfterTouch;
         modSources[eModSource::eKeyBipolar] = &keyBipolar;
         modSources[eModSource::eInvertedVelocity] = &currentInvertedVelocity;
         modSources[eModSource::eVelocity] = &currentVelocity;
-        modSources[eModSource::eFoot] = &footControlValue;
-        modSources[eModSource::eExpPedal] = &expPedalValue;
-        modSources[eModSource::eModwheel] = &modWheelValue;
-        modSources[eModSource::ePitchbend] = &pitchBend;
+        for (size_t e = 0; e < expressions.size(); ++e) {
+            modSources[getExpressionSource(e)] = expressions[e].buffer.getReadPointer(0);
+        }
         // internal
         modSources[eModSource::eLFO1] = lfo[0].audioBuffer.getWritePointer(0);
         modSources[eModSource::eLFO2] = lfo[1].audioBuffer.getWritePointer(0);
@@ -83,19 +126,29 @@ public:
     }
 
     void startNote(int midiNoteNumber, float velocity,
-        SynthesiserSound*, int currentPitchWheelPosition) override {
+        SynthesiserSound*, int /*currentPitchWheelPosition*/) override {
 
         totalVoiceSamples = 0;
+        lastRangeSamples = 0;
+
+        // the synthesiser sets the channel before starting the note
+        for (int c = 1; c <= MidiState::numChannels; ++c) {
+            if (isPlayingChannel(c)) {
+                midiChannel = c;
+                break;
+            }
+        }
+
+        // Initialization of midi values, the expression and controllers start without glide
+        updateExpressionTargets();
+        for (size_t e = 0; e < expressions.size(); ++e) {
+            expressions[e].reset(expressions[e].target);
+            modSources[getExpressionSource(e)] = expressions[e].buffer.getReadPointer(0);
+        }
 
-        // Initialization of midi values
-        channelAfterTouch = params.midiState.get(MidiState::eAftertouch)/128.f;
         keyBipolar = (static_cast<float>(midiNoteNumber) - 64.f) / 64.f;
         currentInvertedVelocity = 1.f - velocity;
         currentVelocity = velocity;
-        footControlValue = params.midiState.get(MidiState::eFoot) / 128.f;
-        expPedalValue = params.midiState.get(MidiState::eExpPedal) / 128.f;
-        modWheelValue = params.midiState.get(MidiState::eModwheel) / 128.f;
-        pitchBend = (currentPitchWheelPosition - 8192.0f) / 8192.0f;
 
         const float sRate = static_cast<float>(getSampleRate());
         const float bpm = static_cast<float>(params.positionInfo[params.getGUIIndex()].bpm);
@@ -208,33 +261,33 @@ public:
         }
     }
 
-    void channelPressureChanged(int newValue) override {
-        channelAfterTouch = static_cast<float>(newValue) / 128.f;
-    }
-
-    void pitchWheelMoved(int newValue) override{
-        pitchBend = (newValue - 8192.f) / 8192.0f;
-    }
+    //! modulation at the end of the last rendered range, for the editor
+    void fillSnapshot(ModSnapshot::Values &v) const {
+        const int last = lastRangeSamples - 1;
+        v.voiceActive = last >= 0;
+        v.note = getCurrentlyPlayingNote();
 
-    //Midi Control
-    void controllerMoved(int controllerNumber, int newValue) override{
-
-        switch(controllerNumber){
-        //Modwheel
-        case 1:
-            modWheelValue = static_cast<float>(newValue) / 128.f;
-            break;
-        //Foot Controller
-        case 4:
-            footControlValue = (static_cast<float>(newValue) / 128.f); //TODO: test
-            break;
-        //Expression Control
-        case 11:
-            expPedalValue = static_cast<float>(newValue) / 128.f; //TODO: test
-            break;
+        for (int d = 0; d < MAX_DESTINATIONS; ++d) {
+            const destinations dest = static_cast<destinations>(d);
+            v.destinationUsed[d] = v.voiceActive && modMatrix.isDestinationUsed(dest);
+            v.destinations[d] = v.destinationUsed[d] ? getAppliedModulation(dest, modDestBuffer.getSample(d, last)) : 0.f;
+        }
+        for (size_t l = 0; l < lfo.size(); ++l) {
+            v.lfoUsed[l] = v.voiceActive && usedSources[eModSource::eLFO1 + l];
+            v.lfo[l] = v.lfoUsed[l] ? lfo[l].audioBuffer.getSample(0, last) : 0.f;
+        }
+        const AudioSampleBuffer *envBuffers[] = { &envToVolBuffer, &env2Buffer, &env3Buffer };
+        for (size_t e = 0; e < v.env.size(); ++e) {
+            v.envUsed[e] = v.voiceActive && usedSources[eModSource::eVolEnv + e];
+            v.env[e] = v.envUsed[e] ? envBuffers[e]->getSample(0, last) : 0.f;
         }
     }
 
+    void pitchWheelMoved(int /*newValue*/) override {}
+
+    // the controllers are read from the midi state, see updateExpressionTargets()
+    void controllerMoved(int /*controllerNumber*/, int /*newValue*/) override {}
+
     void renderNextBlock(AudioSampleBuffer& outputBuffer, int startSample, int numSamples) override{
         
         const float sRate = static_cast<float>(getSampleRate());
@@ -246,7 +299,7 @@ public:
             lfo[2].sine.isActive() || lfo[2].square.isActive() ){
 
             // Modulation
-            renderModulation(numSamples);
+            renderModulation(startSample, numSamples);
 
             const float *envToVolMod = envToVolBuffer.getReadPointer(0);
 
@@ -259,7 +312,6 @@ public:
                         {
                             osc[o].square.phaseDelta = midiNoteFreq * Param::fromCent(params.osc[o].fine.get()) *
                                 Param::fromSemi(params.osc[o].coarse.get()) / sRate * 2.f * float_Pi;
-                            osc[o].square.width = params.osc[o].pulseWidth.get();
                         }
                         break;
                         case eOscWaves::eOscSaw:
@@ -271,10 +323,16 @@ public:
                         break;
                     }
 
-                    const float *pitchMod = modDestBuffer.getReadPointer(DEST_OSC1_PI + o);
-                    const float *shapeMod = modDestBuffer.getReadPointer(DEST_OSC1_PW + o);
-                    const float *panMod = modDestBuffer.getReadPointer(DEST_OSC1_PAN + o);
-                    const float *gainMod = modDestBuffer.getReadPointer(DEST_OSC1_GAIN + o);
+                    const float *pitchMod = getPitchFactor(o);
+                    const float *shapeMod = getModDestination(static_cast<destinations>(DEST_OSC1_PW + o));
+                    const float *panMod = getModDestination(static_cast<destinations>(DEST_OSC1_PAN + o));
+                    const float *gainMod = getModDestination(static_cast<destinations>(DEST_OSC1_GAIN + o));
+                    const float *vol = params.osc[o].volRamp.getRamp(startSample);
+                    const float *panDir = params.osc[o].panDirRamp.getRamp(startSample);
+                    const float *lpCutoff[] = { params.filter[0].lpCutoffRamp.getRamp(startSample), params.filter[1].lpCutoffRamp.getRamp(startSample) };
+                    const float *hpCutoff[] = { params.filter[0].hpCutoffRamp.getRamp(startSample), params.filter[1].hpCutoffRamp.getRamp(startSample) };
+                    const float *resonance[] = { params.filter[0].resonanceRamp.getRamp(startSample), params.filter[1].resonanceRamp.getRamp(startSample) };
+                    const float *pulseWidth = params.osc[o].pulseWidthRamp.getRamp(startSample);
                     
                     for (int s = 0; s < numSamples; ++s) {
                         
@@ -284,6 +342,7 @@ public:
                             case eOscWaves::eOscSquare: 
                             {
                                 // In case of pulse width modulation
+                                osc[o].square.width = pulseWidth[s];
                                 float delta = shapeMod[s];
                                 delta = std::min(osc[o].square.width + delta, params.osc[o].pulseWidth.getMax()) - osc[o].square.width;
                                 delta = std::max(osc[o].square.width + delta, params.osc[o].pulseWidth.getMin()) - osc[o].square.width;
@@ -309,21 +368,21 @@ public:
                         for (size_t f = 0; f < params.filter.size(); ++f)
                         {
                             if(params.filter[f].filterActivation.getStep() == eOnOffToggle::eOn) {
-                                const float *filterLCMod = modDestBuffer.getReadPointer(DEST_FILTER1_LC + f);
-                                const float *filterHCMod = modDestBuffer.getReadPointer(DEST_FILTER1_HC + f);
-                                const float *resMod = modDestBuffer.getReadPointer(DEST_FILTER1_RES + f);
-                                currentSample = filter[o][f].run(currentSample, filterLCMod[s], filterHCMod[s], resMod[s]);
+                                const float *filterLCMod = getModDestination(static_cast<destinations>(DEST_FILTER1_LC + f));
+                                const float *filterHCMod = getModDestination(static_cast<destinations>(DEST_FILTER1_HC + f));
+                                const float *resMod = getModDestination(static_cast<destinations>(DEST_FILTER1_RES + f));
+                                currentSample = filter[o][f].run(currentSample, lpCutoff[f][s], hpCutoff[f][s], resonance[f][s], filterLCMod[s], filterHCMod[s], resMod[s]);
                             }
                         }
                         
                         // gain + pan
-                        const float currentAmp =    params.osc[o].vol.get() * Param::fromDb(gainMod[s] *
+                        const float currentAmp =    vol[s] * Param::fromDb(gainMod[s] *
                                                                                             params.osc[o].gainModAmount1.getMax()) * envToVolMod[s];
                         
                         // check if the output is a stereo output
                         if (outputBuffer.getNumChannels() == 2){
                             // Pan Influence
-                            const float currentPan = params.osc[o].panDir.get() + panMod[s] * 100.f;
+                            const float currentPan = panDir[s] + panMod[s] * 100.f;
                             //const float currentPan = panMod[s] * 100.f;
                             const float currentAmpRight = currentAmp + (currentAmp / 100.f * currentPan);
                             const float currentAmpLeft = currentAmp - (currentAmp / 100.f * currentPan);
@@ -343,6 +402,13 @@ public:
                 }
             }
 
+            // decaying filter states must not become denormal
+            for (auto& filters : filter) {
+                for (Filter& f : filters) {
+                    f.flushDenormals();
+                }
+            }
+
             if (envToVolume.getReleaseSamples() <= envToVolume.getReleaseCounter()){
                 clearCurrentNote();
                 for (size_t l = 0; l < lfo.size(); ++l) {
@@ -376,17 +442,140 @@ protected:
         return source * intensity;
     }
 
-    void renderModulation(int numSamples) {
+    //! reads the pitch bend, pressure and slide of the channel of the note and the controllers
+    /*! The synthesiser renders up to each midi event, so the values are read on their sample.
+        With MPE the master channel bends and presses all notes as well.
+    */
+    void updateExpressionTargets() {
+        const MidiState::ChannelExpression &own = params.midiState.getChannel(midiChannel);
+        float bend = (own.pitchBend - 8192.f) / 8192.f;
+        float pressure = own.pressure / 128.f;
+
+        if (params.mpeActivation.getStep() == eOnOffToggle::eOn && midiChannel != MidiState::masterChannel) {
+            const MidiState::ChannelExpression &master = params.midiState.getChannel(MidiState::masterChannel);
+            bend += (master.pitchBend - 8192.f) / 8192.f;
+            pressure = std::max(pressure, master.pressure / 128.f);
+        }
+
+        expressions[eExpAftertouch].target = pressure;
+        expressions[eExpPitchbend].target = jlimit(-1.f, 1.f, bend);
+        expressions[eExpSlide].target = own.slide / 128.f;
+        expressions[eExpModwheel].target = params.midiState.getNormalized(MidiState::eModwheel);
+        expressions[eExpFoot].target = params.midiState.getNormalized(MidiState::eFoot);
+        expressions[eExpPedal].target = params.midiState.getNormalized(MidiState::eExpPedal);
+    }
+
+    //! mod source a midi expression feeds
+    static eModSource getExpressionSource(size_t expression) {
+        static const eModSource sources[nExpressions] = {
+            eModSource::eAftertouch, eModSource::ePitchbend, eModSource::eSlide,
+            eModSource::eModwheel, eModSource::eFoot, eModSource::eExpPedal
+        };
+        return sources[expression];
+    }
+
+    //! modulation of a destination, constant zero if no row modulates it
+    const float* getModDestination(destinations d) const {
+        return modMatrix.isDestinationUsed(d) ? modDestBuffer.getReadPointer(d) : neutralModBuffer.getReadPointer(eNeutralZero);
+    }
+
+    //! pitch factor of an oscillator, constant one if no row modulates its pitch
+    const float* getPitchFactor(size_t o) const {
+        const destinations d = static_cast<destinations>(DEST_OSC1_PI + o);
+        return modMatrix.isDestinationUsed(d) ? modDestBuffer.getReadPointer(d) : neutralModBuffer.getReadPointer(eNeutralOne);
+    }
+
+    //! a value of modDestBuffer in the units the voice applies it, see ModSnapshot::Values
+    float getAppliedModulation(destinations d, float mod) const {
+        switch (d) {
+        case DEST_FILTER1_LC:
+        case DEST_FILTER2_LC:
+        {
+            const SynthParams::Filter &f = params.filter[d - DEST_FILTER1_LC];
+            return mod * (f.passtype.getStep() == eBiquadFilters::eLadder ? 8.f : f.lpModAmount1.getMax());
+        }
+        case DEST_FILTER1_HC:
+        case DEST_FILTER2_HC:
+            return mod * params.filter[d - DEST_FILTER1_HC].hpModAmount1.getMax();
+        case DEST_FILTER1_RES:
+        case DEST_FILTER2_RES:
+            return mod * params.filter[d - DEST_FILTER1_RES].resModAmount1.getMax();
+        case DEST_OSC1_GAIN:
+        case DEST_OSC2_GAIN:
+        case DEST_OSC3_GAIN:
+            return mod * params.osc[d - DEST_OSC1_GAIN].gainModAmount1.getMax();
+        case DEST_OSC1_PAN:
+        case DEST_OSC2_PAN:
+        case DEST_OSC3_PAN:
+            return mod * 100.f;
+        case DEST_OSC1_PI:
+        case DEST_OSC2_PI:
+        case DEST_OSC3_PI:
+            // already converted to a factor
+            return 12.f * std::log2(mod);
+        case DEST_LFO1_FREQ:
+        case DEST_LFO2_FREQ:
+        case DEST_LFO3_FREQ:
+            return mod * params.lfo[d - DEST_LFO1_FREQ].freqModAmount1.getMax();
+        case DEST_VOL_ENV_SPEED:
+            return mod * params.envVol[0].speedModAmount1.getMax();
+        case DEST_ENV2_SPEED:
+        case DEST_ENV3_SPEED:
+            return mod * params.env[d - DEST_ENV2_SPEED].speedModAmount1.getMax();
+        default:
+            return mod;
+        }
+    }
+
+    //! collects the sources read by the matrix and by the lfo and envelope mod params
+    void updateUsedSources() {
+        for (int src = 0; src < eModSource::nSteps; ++src) {
+            usedSources[src] = modMatrix.isSourceUsed(static_cast<eModSource>(src));
+        }
+        for (const SynthParams::Lfo &l : params.lfo) {
+            usedSources[l.gainModSrc.getStep()] = true;
+            usedSources[l.freqModSrc1.getStep()] = true;
+            usedSources[l.freqModSrc2.getStep()] = true;
+        }
+        usedSources[params.envVol[0].speedModSrc1.getStep()] = true;
+        usedSources[params.envVol[0].speedModSrc2.getStep()] = true;
+        for (const SynthParams::Env &e : params.env) {
+            usedSources[e.speedModSrc1.getStep()] = true;
+            usedSources[e.speedModSrc2.getStep()] = true;
+        }
+        // the volume envelope shapes every note
+        usedSources[eModSource::eVolEnv] = true;
+        usedSources[eModSource::eNone] = false;
+    }
+
+    void renderModulation(int startSample, int numSamples) {
 
         const float sRate = static_cast<float>(getSampleRate());
+        lastRangeSamples = numSamples;
+
+        // only what the compiled rows and the lfo and envelope mod params read is rendered
+        updateUsedSources();
+        const bool lfoUsed[3] = { usedSources[eModSource::eLFO1], usedSources[eModSource::eLFO2], usedSources[eModSource::eLFO3] };
+        const bool env2Used = usedSources[eModSource::eEnv2];
+        const bool env3Used = usedSources[eModSource::eEnv3];
+        const bool matrixUsed = modMatrix.hasActiveRows();
+
+        // midi expression and controllers, before anything reads the mod sources
+        const float expressionCoeff = 1.f - std::exp(-1.f / (expressionGlideTime * sRate));
+        const float controllerCoeff = 1.f - std::exp(-1.f / (controllerGlideTime * sRate));
+        updateExpressionTargets();
+        for (size_t e = 0; e < expressions.size(); ++e) {
+            if (usedSources[getExpressionSource(e)]) {
+                const float coeff = e < eExpModwheel ? expressionCoeff : controllerCoeff;
+                modSources[getExpressionSource(e)] = expressions[e].render(numSamples, coeff);
+            }
+        }
         int samplesFadeIn[3] = { 0,0,0 };
         float lfoGain[3] = { 0.f, 0.f, 0.f };
         float lfoFreqMod[3] = {0.f, 0.f, 0.f};
 
         // Init
         for (size_t l = 0; l < lfo.size(); ++l) {
-            lfo[l].audioBuffer.clear();
-            
             //Set the deltaPhase for realtime LFO Changes
             if (params.lfo[l].tempSync.getStep() == eOnOffToggle::eOn) {
 
@@ -412,6 +601,14 @@ protected:
                 lfo[l].random.phaseDelta = params.lfo[l].freq.get() / sRate * 2.f * float_Pi;
             }
 
+            if (!lfoUsed[l]) {
+                // keep the phase running, so that the lfo is not frozen once a row reads it again
+                lfo[l].sine.skip(numSamples);
+                lfo[l].square.skip(numSamples);
+                lfo[l].random.skip(numSamples);
+                continue;
+            }
+
             // Length in samples of the LFO fade in
             samplesFadeIn[l] = static_cast<int>(params.lfo[l].fadeIn.get() * sRate);
             
@@ -427,11 +624,12 @@ protected:
             lfoFreqMod[l] = std::pow(2.f, (freqModVal1 + freqModVal2) * params.lfo[l].freqModAmount1.getMax());
         }
 
-        //clear the buffers
-        modDestBuffer.clear();
-        envToVolBuffer.clear();
-        env2Buffer.clear();
-        env3Buffer.clear();
+        //clear the used destinations, the others are read as constant zero
+        for (size_t u = 0; u < MAX_DESTINATIONS; ++u) {
+            if (modMatrix.isDestinationUsed(static_cast<destinations>(u))) {
+                modDestBuffer.clear(static_cast<int>(u), 0, numSamples);
+            }
+        }
 
         //set the write point in the buffers
         for (size_t u = 0; u < MAX_DESTINATIONS; ++u) {
@@ -444,12 +642,46 @@ protected:
         modSources[eModSource::eVolEnv] = envToVolBuffer.getWritePointer(0);
         modSources[eModSource::eEnv2] = env2Buffer.getWritePointer(0);
         modSources[eModSource::eEnv3] = env3Buffer.getWritePointer(0);
+        modSources[eModSource::eSeqMod] = params.seqModLane.getValues(startSample);
+
+        // the sources rendered in this range, the others keep pointing at the start of their buffers
+        std::array<eModSource, eModSource::nSteps> renderedSources;
+        size_t numRendered = 0;
+        renderedSources[numRendered++] = eModSource::eVolEnv;
+        renderedSources[numRendered++] = eModSource::eSeqMod;
+        for (size_t l = 0; l < lfo.size(); ++l) {
+            if (lfoUsed[l]) {
+                renderedSources[numRendered++] = static_cast<eModSource>(eModSource::eLFO1 + l);
+            }
+        }
+        if (env2Used) {
+            renderedSources[numRendered++] = eModSource::eEnv2;
+        }
+        if (env3Used) {
+            renderedSources[numRendered++] = eModSource::eEnv3;
+        }
+        for (size_t e = 0; e < expressions.size(); ++e) {
+            if (usedSources[getExpressionSource(e)]) {
+                renderedSources[numRendered++] = getExpressionSource(e);
+            }
+        }
+
+        // the envelopes no row reads only advance their stage
+        if (!env2Used) {
+            env2.skipSamples(numSamples);
+        }
+        if (!env3Used) {
+            env3.skipSamples(numSamples);
+        }
 
         //for each sample
         for (int s = 0; s < numSamples; ++s) {
 
             //calc lfo stuff
             for (size_t l = 0; l < lfo.size(); ++l) {
+                if (!lfoUsed[l]) {
+                    continue;
+                }
                 
                 float factorFadeIn = 1.f;
 
@@ -475,8 +707,16 @@ protected:
             // Calculate the Envelope coefficients and fill the buffers
             // alternative: second matrix with external controls only
             envToVolBuffer.setSample(0, s, envToVolume.getNextEnvCoeff());
-            env2Buffer.setSample(0, s, env2.getNextEnvCoeff());
-            env3Buffer.setSample(0, s, env3.getNextEnvCoeff());
+            if (env2Used) {
+                env2Buffer.setSample(0, s, env2.getNextEnvCoeff());
+            }
+            if (env3Used) {
+                env3Buffer.setSample(0, s, env3.getNextEnvCoeff());
+            }
+
+            if (!matrixUsed) {
+                continue;
+            }
 
             //run the matrix
             modMatrix.doModulationsMatrix(&*modSources.begin(), &*modDestinations.begin());
@@ -485,27 +725,49 @@ protected:
                 ++modDestinations[u];
             }
 
-            // internal modSources
-            ++modSources[eModSource::eLFO1];
-            ++modSources[eModSource::eLFO2];
-            ++modSources[eModSource::eLFO3];
-            ++modSources[eModSource::eVolEnv];
-            ++modSources[eModSource::eEnv2];
-            ++modSources[eModSource::eEnv3];
-
-            //! \todo check whether this should be at the place where the values are actually used
-            modDestBuffer.setSample(DEST_OSC1_PI, s, Param::fromSemi(modDestBuffer.getSample(DEST_OSC1_PI, s) * 
-                                    params.osc[0].pitchModAmount1.getMax()));
-            modDestBuffer.setSample(DEST_OSC2_PI, s, Param::fromSemi(modDestBuffer.getSample(DEST_OSC2_PI, s) * 
-                                    params.osc[1].pitchModAmount1.getMax()));
-            modDestBuffer.setSample(DEST_OSC3_PI, s, Param::fromSemi(modDestBuffer.getSample(DEST_OSC3_PI, s) * 
-                                    params.osc[2].pitchModAmount1.getMax()));
+            for (size_t r = 0; r < numRendered; ++r) {
+                ++modSources[renderedSources[r]];
+            }
+        }
+
+        //! \todo check whether this should be at the place where the values are actually used
+        for (size_t o = 0; o < osc.size(); ++o) {
+            const destinations d = static_cast<destinations>(DEST_OSC1_PI + o);
+            if (modMatrix.isDestinationUsed(d)) {
+                float *pitch = modDestBuffer.getWritePointer(d);
+                for (int s = 0; s < numSamples; ++s) {
+                    pitch[s] = Param::fromSemi(pitch[s] * params.osc[o].pitchModAmount1.getMax());
+                }
+            }
         }
     }
 private:
+    //! time constant of the pitch bend, pressure and slide glide in seconds, against zipper noise
+    static constexpr float expressionGlideTime = 0.003f;
+    //! time constant of the controller glide in seconds, longer for the coarser steps of 7 bit controllers
+    static constexpr float controllerGlideTime = 0.01f;
+
+    //! rows of neutralModBuffer
+    enum eNeutralMod {
+        eNeutralZero = 0,   //!< no modulation of an additive destination
+        eNeutralOne,        //!< no modulation of a pitch factor
+        eNeutralMods
+    };
+
+    //! midi values rendered per sample, in the order of getExpressionSource()
+    enum eExpression {
+        eExpAftertouch = 0,
+        eExpPitchbend,
+        eExpSlide,
+        eExpModwheel,
+        eExpFoot,
+        eExpPedal,
+        nExpressions
+    };
 
     SynthParams &params;
     int totalVoiceSamples;
+    int lastRangeSamples;       //!< length of the last range renderModulation() filled the buffers for
     std::array<Lfo, 3> lfo;
 
     struct Osc {
@@ -519,16 +781,14 @@ private:
     std::array<std::array<Filter,2>,3> filter;
     std::array<const float*, eModSource::nSteps> modSources;
     std::array<float*, MAX_DESTINATIONS> modDestinations;
+    std::array<bool, eModSource::nSteps> usedSources;   //!< sources rendered in the current range
 
     // Midi
-    float channelAfterTouch;
+    int midiChannel;            //!< channel of the playing note
+    std::array<MidiExpression, nExpressions> expressions;
     float keyBipolar;
     float currentInvertedVelocity;
     float currentVelocity;
-    float footControlValue;
-    float expPedalValue;
-    float modWheelValue;
-    float pitchBend;
 
     //Mod matrix
     ModulationMatrix& modMatrix;
@@ -536,6 +796,7 @@ private:
 
     // Buffers
     AudioSampleBuffer modDestBuffer;
+    AudioSampleBuffer neutralModBuffer;     //!< constant values for the destinations no row modulates
     AudioSampleBuffer envToVolBuffer;
     AudioSampleBuffer env2Buffer;
     AudioSampleBuffer env3Buffer;
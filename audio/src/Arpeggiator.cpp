@@ -0,0 +1,242 @@
+/*
+  ==============================================================================
+
+    Arpeggiator.cpp
+
+  ==============================================================================
+*/
+
+#include "Arpeggiator.h"
+#include <algorithm>
+
+namespace {
+    //! fraction of a step a position may lie before a step and still count as on it
+    const double stepEpsilon = 1e-6;
+    //! deviations of the host position from the expected one up to this are drift, not a jump
+    const double maxDriftSamples = 16.0;
+    //! bytes reserved for the output, enough for the midi of any sane block
+    const int outputBufferBytes = 4096;
+
+    const uint8 allSoundOffController = 120;
+    const uint8 allNotesOffController = 123;
+}
+
+Arpeggiator::Arpeggiator(SynthParams &p)
+    : params(p)
+    , numHeld(0)
+    , originPpq(0.0)
+    , noteOffPpq(0.0)
+    , expectedPpq(0.0)
+    , lastSpeed(0.f)
+    , nextStepCount(0)
+    , arpIndex(0)
+    , playingNote(-1)
+    , channel(1)
+    , wasActive(false)
+    , wasHostPlaying(false)
+{
+    heldNotes.fill(0);
+    playedNotes.fill(0);
+    velocities.fill(0);
+    random.setSeedRandomly();
+}
+
+void Arpeggiator::prepare()
+{
+    output.ensureSize(outputBufferBytes);
+    output.clear();
+}
+
+void Arpeggiator::run(MidiBuffer &midiMessages, int numSamples, double sampleRate)
+{
+    const bool active = params.arpActivation.getStep() == eOnOffToggle::eOn;
+    const AudioPlayHead::CurrentPositionInfo &hostPlayHead = params.positionInfo[params.getAudioIndex()];
+
+    if (!active || hostPlayHead.bpm <= 0.0 || sampleRate <= 0.0) {
+        if (wasActive) {
+            // the synth never got the held keys, only the arpeggio note has to stop
+            sendNoteOff(midiMessages, 0);
+            numHeld = 0;
+            arpIndex = 0;
+            wasActive = false;
+        }
+        return;
+    }
+
+    const float speed = 4.f / params.arpSpeed.get(); // internally working with 1/4 = 1.0f
+    const double samplesPerPpq = sampleRate * 60.0 / hostPlayHead.bpm;
+    const bool hostPlaying = hostPlayHead.isPlaying;
+
+    output.clear();
+
+    double blockPpq;
+    if (hostPlaying) {
+        // the steps lie on multiples of the speed counted from the start of the song
+        blockPpq = hostPlayHead.ppqPosition;
+        if (!wasActive || !wasHostPlaying || std::abs(blockPpq - expectedPpq) * samplesPerPpq > maxDriftSamples) {
+            sendNoteOff(output, 0);
+            originPpq = 0.0;
+            lastSpeed = speed;
+            relocate(blockPpq);
+        }
+    } else {
+        // on its own position, the first pressed key starts the arpeggio
+        blockPpq = expectedPpq;
+    }
+    if (speed != lastSpeed) {
+        lastSpeed = speed;
+        relocate(blockPpq);
+    }
+    wasActive = true;
+    wasHostPlaying = hostPlaying;
+
+    MidiBuffer::Iterator it(midiMessages);
+    const uint8 *data;
+    int size;
+    int sample;
+    while (it.getNextEvent(data, size, sample)) {
+        advance(output, blockPpq, sample, samplesPerPpq);
+
+        const uint8 status = data[0] & 0xf0;
+        if (size >= 3 && status == 0x90 && data[2] > 0) {
+            if (numHeld == 0) {
+                arpIndex = 0;
+                if (!hostPlaying) {
+                    originPpq = blockPpq + sample / samplesPerPpq;
+                    nextStepCount = 0;
+                }
+            }
+            channel = (data[0] & 0x0f) + 1;
+            noteOn(data[1], data[2]);
+        } else if (size >= 3 && (status == 0x80 || status == 0x90)) {
+            // keys pressed before the arpeggiator was switched on still sound in the synth
+            if (!noteOff(data[1])) {
+                output.addEvent(data, size, sample);
+            }
+        } else {
+            if (size >= 3 && status == 0xb0 && (data[1] == allSoundOffController || data[1] == allNotesOffController)) {
+                numHeld = 0;
+                sendNoteOff(output, sample);
+            }
+            output.addEvent(data, size, sample);
+        }
+    }
+    advance(output, blockPpq, numSamples, samplesPerPpq);
+
+    expectedPpq = blockPpq + numSamples / samplesPerPpq;
+    // copied back instead of swapped, so that output keeps its reserved memory
+    midiMessages.clear();
+    midiMessages.addEvents(output, 0, -1, 0);
+}
+
+void Arpeggiator::advance(MidiBuffer &out, double blockPpq, int endSample, double samplesPerPpq)
+{
+    const double speed = static_cast<double>(lastSpeed);
+    for (;;) {
+        const double stepPpq = originPpq + static_cast<double>(nextStepCount) * speed;
+
+        // the note off comes first if both fall on the same sample
+        const bool noteOffNext = playingNote >= 0 && noteOffPpq <= stepPpq;
+        const double eventPpq = jmax(blockPpq, noteOffNext ? noteOffPpq : stepPpq);
+        const int sample = roundToInt((eventPpq - blockPpq) * samplesPerPpq);
+        if (sample >= endSample) {
+            break;
+        }
+
+        sendNoteOff(out, sample);
+        if (noteOffNext) {
+            continue;
+        }
+
+        // steps without held keys pass silently, the arpeggio restarts with the next key
+        if (numHeld > 0) {
+            uint8 velocity = 0;
+            const int note = getArpNote(arpIndex++, velocity);
+            if (note >= 0) {
+                const uint8 noteOnData[3] = { static_cast<uint8>(0x90 | (channel - 1)), static_cast<uint8>(note), velocity };
+                out.addEvent(noteOnData, 3, sample);
+                playingNote = note;
+            }
+        }
+        noteOffPpq = stepPpq + speed * params.arpGate.get() / 100.0;
+        ++nextStepCount;
+    }
+}
+
+void Arpeggiator::relocate(double ppq)
+{
+    const double steps = std::ceil((ppq - originPpq) / static_cast<double>(lastSpeed) - stepEpsilon);
+    nextStepCount = jmax(static_cast<int64>(0), static_cast<int64>(steps));
+}
+
+void Arpeggiator::noteOn(int note, int velocity)
+{
+    velocities[static_cast<size_t>(note)] = static_cast<uint8>(velocity);
+
+    uint8 *end = heldNotes.data() + numHeld;
+    uint8 *pos = std::lower_bound(heldNotes.data(), end, static_cast<uint8>(note));
+    if (pos != end && *pos == note) {
+        return;
+    }
+    std::copy_backward(pos, end, end + 1);
+    *pos = static_cast<uint8>(note);
+    playedNotes[static_cast<size_t>(numHeld)] = static_cast<uint8>(note);
+    ++numHeld;
+}
+
+bool Arpeggiator::noteOff(int note)
+{
+    uint8 *end = heldNotes.data() + numHeld;
+    uint8 *pos = std::lower_bound(heldNotes.data(), end, static_cast<uint8>(note));
+    if (pos == end || *pos != note) {
+        return false;
+    }
+    std::copy(pos + 1, end, pos);
+
+    uint8 *playedEnd = playedNotes.data() + numHeld;
+    uint8 *played = std::find(playedNotes.data(), playedEnd, static_cast<uint8>(note));
+    std::copy(played + 1, playedEnd, played);
+    --numHeld;
+    return true;
+}
+
+void Arpeggiator::sendNoteOff(MidiBuffer &out, int sample)
+{
+    if (playingNote >= 0) {
+        const uint8 noteOffData[3] = { static_cast<uint8>(0x80 | (channel - 1)), static_cast<uint8>(playingNote), 0 };
+        out.addEvent(noteOffData, 3, sample);
+        playingNote = -1;
+    }
+}
+
+int Arpeggiator::getArpNote(int64 index, uint8 &velocity)
+{
+    const int octaves = jlimit(1, 4, static_cast<int>(params.arpOctaves.get()));
+    const int64 length = static_cast<int64>(numHeld) * octaves;
+
+    int64 k;
+    switch (params.arpMode.getStep()) {
+    case eArpModes::eDown:
+        k = length - 1 - index % length;
+        break;
+    case eArpModes::eUpDown: {
+        // the top and bottom notes are not repeated at the turns
+        const int64 period = jmax(static_cast<int64>(1), 2 * length - 2);
+        const int64 p = index % period;
+        k = p < length ? p : period - p;
+        break;
+    }
+    case eArpModes::eRandom:
+        k = random.nextInt(static_cast<int>(length));
+        break;
+    default:
+        k = index % length;
+        break;
+    }
+
+    const std::array<uint8, maxHeldNotes> &notes = params.arpMode.getStep() == eArpModes::eAsPlayed ? playedNotes : heldNotes;
+    const uint8 key = notes[static_cast<size_t>(k % numHeld)];
+    const int note = key + 12 * static_cast<int>(k / numHeld);
+    velocity = velocities[key];
+    return note <= 127 ? note : -1;
+}
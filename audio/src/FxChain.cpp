@@ -0,0 +1,254 @@
+/*
+  ==============================================================================
+
+    FxChain.cpp
+
+  ==============================================================================
+*/
+
+#include "FxChain.h"
+
+namespace {
+    const float silenceThreshold = 1e-5f;  // about -100 dB
+    const double fadeTime = .01;            // bypass crossfade in seconds
+}
+
+FxChain::FxChain(SynthParams &p)
+    : params(p)
+    , delay(p)
+    , clip(p)
+    , lowFi(p)
+    , chorus(p)
+    , reverb(p)
+    , convolution(p)
+    , slotParams{ { &p.fxSlot0, &p.fxSlot1, &p.fxSlot2, &p.fxSlot3, &p.fxSlot4, &p.fxSlot5 } }
+    , sampleRate(44100.)
+    , fadeStep(1.f)
+{
+    for (size_t i = 0; i < nFx; ++i) {
+        order[i] = static_cast<eFxSlots>(i);
+        state[i].gain = isActive(order[i]) ? 1.f : 0.f;
+        state[i].silentSamples = 0;
+    }
+}
+
+FxChain::~FxChain()
+{
+}
+
+void FxChain::init(int channelsIn, double sampleRateIn, int samplesPerBlock)
+{
+    sampleRate = sampleRateIn;
+    fadeStep = static_cast<float>(1.0 / (fadeTime * sampleRate));
+    dryBuffer.setSize(channelsIn, jmax(1, samplesPerBlock));
+
+    delay.init(channelsIn, sampleRateIn);
+    chorus.init(channelsIn, sampleRateIn);
+    reverb.init(channelsIn, sampleRateIn);
+    convolution.init(channelsIn, sampleRateIn);
+
+    for (SlotState &s : state) {
+        s.silentSamples = 0;
+    }
+}
+
+void FxChain::render(AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
+{
+    updateOrder();
+
+    // hosts may exceed the announced block size, the crossfade buffer is never resized here
+    const int maxChunk = dryBuffer.getNumSamples();
+    while (numSamples > 0) {
+        const int chunk = jmin(numSamples, maxChunk);
+        renderChunk(outputBuffer, startSample, chunk);
+        startSample += chunk;
+        numSamples -= chunk;
+    }
+}
+
+void FxChain::renderChunk(AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
+{
+    const int channels = jmin(outputBuffer.getNumChannels(), dryBuffer.getNumChannels());
+
+    for (eFxSlots fx : order) {
+        SlotState &s = state[static_cast<size_t>(fx)];
+        const float target = isActive(fx) ? 1.f : 0.f;
+
+        // bypassed and faded out: no work at all
+        if (target == 0.f && s.gain == 0.f) {
+            continue;
+        }
+        // start from a clean state when switched on again
+        if (s.gain == 0.f) {
+            resetEffect(fx);
+            s.silentSamples = 0;
+        }
+
+        if (isSilent(outputBuffer, startSample, numSamples)) {
+            s.silentSamples = jmin(s.silentSamples + numSamples, std::numeric_limits<int>::max() / 2);
+        } else {
+            s.silentSamples = 0;
+        }
+
+        if (s.gain == target) {
+            // fully active, skip if the tail has already decayed
+            if (s.silentSamples > static_cast<int>(getEffectTail(fx) * sampleRate) + numSamples) {
+                continue;
+            }
+            renderEffect(fx, outputBuffer, startSample, numSamples);
+            continue;
+        }
+
+        // crossfade between dry and processed signal
+        for (int c = 0; c < channels; ++c) {
+            dryBuffer.copyFrom(c, 0, outputBuffer, c, startSample, numSamples);
+        }
+        renderEffect(fx, outputBuffer, startSample, numSamples);
+
+        float gain = s.gain;
+        for (int c = 0; c < channels; ++c) {
+            const float* dry = dryBuffer.getReadPointer(c);
+            float* out = outputBuffer.getWritePointer(c, startSample);
+            gain = s.gain;
+            for (int i = 0; i < numSamples; ++i) {
+                gain = (target > gain) ? jmin(target, gain + fadeStep) : jmax(target, gain - fadeStep);
+                out[i] = dry[i] + gain * (out[i] - dry[i]);
+            }
+        }
+        s.gain = gain;
+    }
+}
+
+void FxChain::updateOrder()
+{
+    std::array<bool, nFx> used;
+    used.fill(false);
+
+    size_t n = 0;
+    for (ParamStepped<eFxSlots>* slot : slotParams) {
+        const eFxSlots fx = slot->getStep();
+        const size_t i = static_cast<size_t>(fx);
+        if (i < nFx && !used[i]) {
+            used[i] = true;
+            order[n++] = fx;
+        }
+    }
+    // effects that are not assigned to a slot keep running at the end
+    for (size_t i = 0; i < nFx; ++i) {
+        if (!used[i]) {
+            order[n++] = static_cast<eFxSlots>(i);
+        }
+    }
+}
+
+void FxChain::renderEffect(eFxSlots fx, AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
+{
+    switch (fx) {
+    case eFxSlots::eLowFi:
+        lowFi.bitReduction(outputBuffer, startSample, numSamples);
+        break;
+    case eFxSlots::eClipping:
+        clip.clipSignal(outputBuffer, startSample, numSamples);
+        break;
+    case eFxSlots::eDelay:
+        delay.render(outputBuffer, startSample, numSamples); // adds the delay to the outputBuffer
+        break;
+    case eFxSlots::eChorus:
+        chorus.render(outputBuffer, startSample, numSamples);
+        break;
+    case eFxSlots::eReverb:
+        reverb.render(outputBuffer, startSample, numSamples);
+        break;
+    case eFxSlots::eConvolution:
+        convolution.render(outputBuffer, startSample, numSamples);
+        break;
+    default:
+        jassertfalse;
+        break;
+    }
+}
+
+void FxChain::resetEffect(eFxSlots fx)
+{
+    switch (fx) {
+    case eFxSlots::eDelay:
+        delay.reset();
+        break;
+    case eFxSlots::eChorus:
+        chorus.reset();
+        break;
+    case eFxSlots::eReverb:
+        reverb.reset();
+        break;
+    case eFxSlots::eConvolution:
+        convolution.reset();
+        break;
+    default:
+        // stateless effects
+        break;
+    }
+}
+
+bool FxChain::isActive(eFxSlots fx) const
+{
+    switch (fx) {
+    case eFxSlots::eLowFi:
+        return params.lowFiActivation.getStep() == eOnOffToggle::eOn;
+    case eFxSlots::eClipping:
+        return params.clippingActivation.getStep() == eOnOffToggle::eOn;
+    case eFxSlots::eDelay:
+        return params.delayActivation.getStep() == eOnOffToggle::eOn;
+    case eFxSlots::eChorus:
+        return params.chorActivation.getStep() == eOnOffToggle::eOn;
+    case eFxSlots::eReverb:
+        return params.revActivation.getStep() == eOnOffToggle::eOn;
+    case eFxSlots::eConvolution:
+        return params.convActivation.getStep() == eOnOffToggle::eOn;
+    default:
+        return false;
+    }
+}
+
+double FxChain::getEffectTail(eFxSlots fx) const
+{
+    switch (fx) {
+    case eFxSlots::eDelay:
+        return delay.getTailLengthSeconds();
+    case eFxSlots::eChorus:
+        return chorus.getTailLengthSeconds();
+    case eFxSlots::eReverb:
+        return reverb.getTailLengthSeconds();
+    case eFxSlots::eConvolution:
+        return convolution.getTailLengthSeconds();
+    default:
+        // memoryless effects, silence in gives silence out
+        return 0.0;
+    }
+}
+
+double FxChain::getTailLengthSeconds() const
+{
+    double tail = 0.0;
+    for (size_t i = 0; i < nFx; ++i) {
+        const eFxSlots fx = static_cast<eFxSlots>(i);
+        if (isActive(fx)) {
+            tail += getEffectTail(fx);
+        }
+    }
+    return jmin(tail, FxDelay::maxTailSeconds);
+}
+
+void FxChain::loadImpulseResponse(const File& file)
+{
+    convolution.loadImpulseResponse(file);
+}
+
+bool FxChain::isSilent(const AudioSampleBuffer& buffer, int startSample, int numSamples)
+{
+    for (int c = 0; c < buffer.getNumChannels(); ++c) {
+        if (buffer.getMagnitude(c, startSample, numSamples) > silenceThreshold) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -29,10 +29,24 @@ void FxChorus::init(int channelsIn, double sampleRateIn)
     }
 }
 
-void FxChorus::render(AudioSampleBuffer& outputBuffer, int startSample) {
+void FxChorus::reset()
+{
+    chorusBuffer.clear();
+    loopPosition = 0;
+}
+
+double FxChorus::getTailLengthSeconds() const
+{
+    // loop length plus the maximum modulation offset, render uses the depth as an offset in samples
+    return params.chorDelayLength.get() + params.chorModDepth.get() / sampleRate;
+}
+
+void FxChorus::render(AudioSampleBuffer& outputBuffer, int startSample, int numSamples) {
     int newLoopLength;
+    const float* wetness = params.chorDryWetRamp.getRamp(startSample);
+    const float* depth = params.chorModDepthRamp.getRamp(startSample);
 
-    for (int i = 0; i < outputBuffer.getNumSamples(); ++i)
+    for (int i = 0; i < numSamples; ++i)
     {
         //newLoopLength = static_cast<int>(params.chorDelayLength.get() * (sampleRate / 1000.0));
         newLoopLength = static_cast<int>(params.chorDelayLength.get() * sampleRate);
@@ -53,11 +67,11 @@ void FxChorus::render(AudioSampleBuffer& outputBuffer, int startSample) {
 
         // Interpolation
         // get delayed sample index for both oscillators
-        float currentDelayMod1 = modSine1.next() * params.chorModDepth.get();
-        float currentDelayMod2 = modSine2.next() * params.chorModDepth.get();
-        float currentDelayMod3 = modSine3.next() * params.chorModDepth.get();
-        float currentDelayMod4 = modSine4.next() * params.chorModDepth.get();
-        float currentDelayMod5 = modSine5.next() * params.chorModDepth.get();
+        float currentDelayMod1 = modSine1.next() * depth[i];
+        float currentDelayMod2 = modSine2.next() * depth[i];
+        float currentDelayMod3 = modSine3.next() * depth[i];
+        float currentDelayMod4 = modSine4.next() * depth[i];
+        float currentDelayMod5 = modSine5.next() * depth[i];
 
 
         // get "time" in samples between two samples
@@ -102,7 +116,7 @@ void FxChorus::render(AudioSampleBuffer& outputBuffer, int startSample) {
 
             // Amplituden anpassen und Werte in Buffer schreiben
 
-            float currentWetness = params.chorDryWet.get();
+            float currentWetness = wetness[i];
 
             outputBuffer.setSample(c, startSample + i, currentSample * (1.f - currentWetness));
 
@@ -14,7 +14,7 @@ FxClipping::~FxClipping(){};
 
 void FxClipping::clipSignal(AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
 {
-    float clipFactor = params.clippingFactor.get();
+    const float* clipFactor = params.clippingFactorRamp.getRamp(startSample);
     for (int c = 0; c < outputBuffer.getNumChannels(); ++c) {
         FloatVectorOperations::multiply(outputBuffer.getWritePointer(c, startSample), clipFactor, numSamples);
         FloatVectorOperations::clip(outputBuffer.getWritePointer(c, startSample), outputBuffer.getReadPointer(c, startSample), -1.f, 1.f, numSamples);
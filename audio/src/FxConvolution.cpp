@@ -0,0 +1,281 @@
+/*
+  ==============================================================================
+
+    FxConvolution.cpp
+
+  ==============================================================================
+*/
+
+#include "FxConvolution.h"
+
+namespace {
+    const int fftOrder = 9; // 2^9 = fftSize
+
+    inline void clearComplex(FFT::Complex* data, int num)
+    {
+        FloatVectorOperations::clear(reinterpret_cast<float*>(data), 2 * num);
+    }
+}
+
+FxConvolution::FxConvolution(SynthParams &p)
+    : params(p)
+    , forwardFFT(fftOrder, false)
+    , inverseFFT(fftOrder, true)
+    , loader(*this)
+    , targetSampleRate(44100.)
+    , current(nullptr)
+    , pending(nullptr)
+    , retired(nullptr)
+    , irSeconds(0.f)
+    , maxPartitions(0)
+    , fdlPosition(0)
+    , blockPosition(0)
+    , historyPosition(0)
+{
+    jassert(forwardFFT.getSize() == fftSize);
+}
+
+FxConvolution::~FxConvolution()
+{
+    loader.stopThread(5000);
+    delete current;
+    delete pending.exchange(nullptr);
+    delete retired.exchange(nullptr);
+}
+
+void FxConvolution::init(int channelsIn, double sampleRateIn)
+{
+    ignoreUnused(channelsIn);
+
+    maxPartitions = static_cast<int>(std::ceil(maxIrSeconds * sampleRateIn / partitionSize));
+    fdl.allocate(static_cast<size_t>(maxPartitions * fftSize), true);
+    frame.allocate(fftSize, true);
+    spectrum.allocate(fftSize, true);
+    inputBlock.allocate(2 * partitionSize, true);
+    tailBlock.allocate(partitionSize, true);
+    history.allocate(2 * 2 * partitionSize, true);
+    reset();
+
+    bool reload;
+    {
+        const ScopedLock sl(fileLock);
+        reload = targetSampleRate != sampleRateIn && file.existsAsFile();
+        targetSampleRate = sampleRateIn;
+    }
+    if (reload) {
+        loader.stopThread(5000);
+        loader.startThread();
+    }
+}
+
+void FxConvolution::reset()
+{
+    if (maxPartitions == 0) {
+        return;
+    }
+    // all slots, processPartitions reads back across the wrap of the delay line
+    clearComplex(fdl, maxPartitions * fftSize);
+    clearComplex(inputBlock, 2 * partitionSize);
+    clearComplex(tailBlock, partitionSize);
+    FloatVectorOperations::clear(history, 2 * 2 * partitionSize);
+    fdlPosition = 0;
+    blockPosition = 0;
+    historyPosition = 0;
+}
+
+void FxConvolution::loadImpulseResponse(const File& newFile)
+{
+    loader.stopThread(5000);
+    {
+        const ScopedLock sl(fileLock);
+        file = newFile;
+    }
+    loader.startThread();
+}
+
+void FxConvolution::prepareKernel()
+{
+    File irFile;
+    double sampleRate;
+    {
+        const ScopedLock sl(fileLock);
+        irFile = file;
+        sampleRate = targetSampleRate;
+    }
+
+    // a kernel the audio thread has handed back can be freed now
+    delete retired.exchange(nullptr);
+
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    ScopedPointer<AudioFormatReader> reader = formatManager.createReaderFor(irFile);
+    const int fileLength = (reader != nullptr) ? static_cast<int>(jmin<int64>(reader->lengthInSamples,
+        static_cast<int64>(maxIrSeconds * reader->sampleRate))) : 0;
+    if (fileLength <= 0) {
+        // no or an unreadable file, the previous impulse response must not keep sounding
+        irSeconds.store(0.f);
+        delete pending.exchange(new Kernel());
+        return;
+    }
+    AudioSampleBuffer fileBuffer(static_cast<int>(reader->numChannels), fileLength);
+    reader->read(&fileBuffer, 0, fileLength, 0, true, true);
+
+    // mono mix and linear resampling to the engine sample rate
+    const double ratio = reader->sampleRate / sampleRate;
+    const int length = jmin(static_cast<int>(fileLength / ratio), static_cast<int>(maxIrSeconds * sampleRate));
+    HeapBlock<float> ir(static_cast<size_t>(length), true);
+    for (int i = 0; i < length; ++i) {
+        const double pos = i * ratio;
+        const int i0 = static_cast<int>(pos);
+        const int i1 = jmin(i0 + 1, fileLength - 1);
+        const float frac = static_cast<float>(pos - i0);
+        for (int c = 0; c < fileBuffer.getNumChannels(); ++c) {
+            const float* d = fileBuffer.getReadPointer(c);
+            ir[i] += d[i0] + frac * (d[i1] - d[i0]);
+        }
+    }
+
+    // normalize to unity energy so that different files have a similar loudness
+    double energy = 0.;
+    for (int i = 0; i < length; ++i) {
+        energy += ir[i] * ir[i];
+    }
+    if (energy > 0.) {
+        FloatVectorOperations::multiply(ir, static_cast<float>(1. / std::sqrt(energy)), length);
+    }
+
+    ScopedPointer<Kernel> kernel = new Kernel();
+    kernel->sampleRate = sampleRate;
+    kernel->length = length;
+    kernel->numPartitions = jmax(0, (length - partitionSize + partitionSize - 1) / partitionSize);
+
+    // time reversed head for the direct convolution
+    kernel->head.allocate(partitionSize, true);
+    for (int i = 0; i < jmin(length, partitionSize); ++i) {
+        kernel->head[partitionSize - 1 - i] = ir[i];
+    }
+
+    // spectra of the remaining partitions, zero padded to fftSize and scaled for the inverse transform
+    kernel->spectra.allocate(static_cast<size_t>(jmax(1, kernel->numPartitions) * fftSize), true);
+    HeapBlock<FFT::Complex> padded(fftSize);
+    const float scale = 1.f / fftSize;
+    for (int p = 0; p < kernel->numPartitions; ++p) {
+        if (loader.threadShouldExit()) {
+            return;
+        }
+        clearComplex(padded, fftSize);
+        const int offset = (p + 1) * partitionSize;
+        for (int i = 0; i < partitionSize && offset + i < length; ++i) {
+            padded[i].r = ir[offset + i] * scale;
+        }
+        forwardFFT.perform(padded, kernel->spectra + p * fftSize);
+    }
+
+    irSeconds.store(static_cast<float>(length / sampleRate));
+    // a kernel that has never been picked up is replaced
+    delete pending.exchange(kernel.release());
+}
+
+void FxConvolution::swapKernel()
+{
+    // wait with the swap until the loader has deleted the previous kernel
+    if (retired.load() != nullptr || pending.load() == nullptr) {
+        return;
+    }
+    Kernel* k = pending.exchange(nullptr);
+    if (k != nullptr) {
+        retired.store(current);
+        current = k;
+        reset();
+    }
+}
+
+void FxConvolution::processPartitions()
+{
+    // overlap-save frame: previous and current input block
+    memcpy(frame, inputBlock, sizeof(FFT::Complex) * 2 * partitionSize);
+    memmove(inputBlock, inputBlock + partitionSize, sizeof(FFT::Complex) * partitionSize);
+
+    if (++fdlPosition >= maxPartitions) {
+        fdlPosition = 0;
+    }
+    forwardFFT.perform(frame, fdl + fdlPosition * fftSize);
+
+    // multiply-accumulate the delayed input spectra with the partition spectra
+    clearComplex(spectrum, fftSize);
+    const int numPartitions = jmin(current->numPartitions, maxPartitions);
+    for (int p = 0; p < numPartitions; ++p) {
+        int slot = fdlPosition - p;
+        if (slot < 0) slot += maxPartitions;
+        const FFT::Complex* x = fdl + slot * fftSize;
+        const FFT::Complex* h = current->spectra + p * fftSize;
+        for (int k = 0; k < fftSize; ++k) {
+            spectrum[k].r += x[k].r * h[k].r - x[k].i * h[k].i;
+            spectrum[k].i += x[k].r * h[k].i + x[k].i * h[k].r;
+        }
+    }
+
+    // the last half of the frame is valid, it belongs to the next block because of the head partition
+    inverseFFT.perform(spectrum, frame);
+    memcpy(tailBlock, frame + partitionSize, sizeof(FFT::Complex) * partitionSize);
+}
+
+void FxConvolution::render(AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
+{
+    swapKernel();
+    if (current == nullptr || current->length == 0 || maxPartitions == 0) {
+        return;
+    }
+
+    const int channels = outputBuffer.getNumChannels();
+    const float* wetness = params.convDryWetRamp.getRamp(startSample);
+    float* left = outputBuffer.getWritePointer(0, startSample);
+    float* right = (channels > 1) ? outputBuffer.getWritePointer(1, startSample) : nullptr;
+    float* historyLeft = history;
+    float* historyRight = history + 2 * partitionSize;
+    const float* head = current->head;
+
+    for (int s = 0; s < numSamples; ++s) {
+        const float inLeft = left[s];
+        const float inRight = (right != nullptr) ? right[s] : 0.f;
+
+        // written twice, so that the last partitionSize samples are always contiguous
+        historyLeft[historyPosition] = historyLeft[historyPosition + partitionSize] = inLeft;
+        historyRight[historyPosition] = historyRight[historyPosition + partitionSize] = inRight;
+        if (++historyPosition >= partitionSize) historyPosition = 0;
+
+        const float* xl = historyLeft + historyPosition;
+        const float* xr = historyRight + historyPosition;
+        float headLeft = 0.f;
+        float headRight = 0.f;
+        for (int i = 0; i < partitionSize; ++i) {
+            headLeft += xl[i] * head[i];
+            headRight += xr[i] * head[i];
+        }
+
+        const float wet = wetness[s];
+        const float dry = 1.f - wet;
+        left[s] = inLeft * dry + (headLeft + tailBlock[blockPosition].r) * wet;
+        if (right != nullptr) {
+            right[s] = inRight * dry + (headRight + tailBlock[blockPosition].i) * wet;
+        }
+
+        FFT::Complex& in = inputBlock[partitionSize + blockPosition];
+        in.r = inLeft;
+        in.i = inRight;
+        if (++blockPosition >= partitionSize) {
+            blockPosition = 0;
+            processPartitions();
+        }
+    }
+
+    // further channels get the left signal
+    for (int c = 2; c < channels; ++c) {
+        outputBuffer.copyFrom(c, startSample, outputBuffer, 0, startSample, numSamples);
+    }
+}
+
+double FxConvolution::getTailLengthSeconds() const
+{
+    return irSeconds.load();
+}
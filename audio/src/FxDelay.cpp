@@ -10,12 +10,14 @@ Author:  nj
 
 #include "FxDelay.h"
 
-float FxDelay::filter(float currentSample) {
+const double FxDelay::maxTailSeconds = 60.0;
+
+float FxDelay::filter(float currentSample, float cutoff) {
 
     //New Filter Design: Biquad (2 delays) Source: http://www.musicdsp.org/showArchiveComment.php?ArchiveID=259
     float k, coeff1, coeff2, coeff3, b0, b1, b2, a1, a2;
 
-    const float currentLowcutFreq = params.delayCutoff.get() / static_cast<float>(sampleRate);
+    const float currentLowcutFreq = cutoff / static_cast<float>(sampleRate);
     //const float currentResonance = pow(10.f, -params.delayResonance.get() / 20.f);
 
     // coefficients for lowpass, depending on resonance and lowcut frequency
@@ -43,96 +45,196 @@ float FxDelay::filter(float currentSample) {
     return currentSample;
 }
 
+namespace {
+    // fastest movement of the read head in samples per sample, limits the pitch shift of large time changes
+    const float maxGlideSpeed = .5f;
+}
+
 void FxDelay::init(int channelsIn, double sampleRateIn)
 {
     channels = channelsIn;
     sampleRate = sampleRateIn;
-    delayBuffer.setSize(channels, static_cast<int>(sampleRate * 20.0));
-    currentDelayLength = static_cast<int>(params.delayTime.get()*(sampleRate / 1000.0));
+    // two extra samples for the interpolation
+    delayBuffer.setSize(channels, static_cast<int>(sampleRate * maxDelayLength / 1000.0) + 2);
     delayBuffer.clear();
+    writePosition = 0;
+    lastTimeInSamples = 0;
+    tempoSlope = 0.;
+    reset();
 }
 
-void FxDelay::calcTime()
+void FxDelay::reset()
 {
-    if (params.delaySync.getStep() == eOnOffToggle::eOn){
-        double bpmIn = params.positionInfo[params.getGUIIndex()].bpm;
-
-        float newTime = static_cast<float>(4000.0 * (1. / (bpmIn / 60.)) *
-                                           static_cast<double>(params.delayDividend.get() / params.delayDivisor.get()));
+    const int bufferLength = delayBuffer.getNumSamples();
+    if (bufferLength == 0) {
+        return;
+    }
 
-        if (params.delayDottedLength.getStep() == eOnOffToggle::eOn) {
-            newTime *= 1.5f;
-        }
-        if (params.delayTriplet.getStep() == eOnOffToggle::eOn) {
-            newTime *= 2.f/3.f;
-        }
+    const float time = calcTime(bpm);
+    timeMs.store(time);
+    delaySamples = jlimit(1.f, static_cast<float>(bufferLength - 2), time * static_cast<float>(sampleRate / 1000.0));
+    reversePhase = 0.f;
+
+    // everything the read head can reach, up to two delay lengths in reverse mode
+    int length = jmin(bufferLength, 2 * static_cast<int>(delaySamples) + 3);
+    int start = writePosition - length;
+    if (start < 0) {
+        delayBuffer.clear(start + bufferLength, -start);
+        length += start;
+        start = 0;
+    }
+    delayBuffer.clear(start, length);
 
-        bpm = bpmIn;
-        divisor = params.delayDivisor.get();
-        dividend = params.delayDividend.get();
-        triplet = params.delayTriplet.getStep();
+    fLastSample = fInputDelay1 = fInputDelay2 = fOutputDelay1 = fOutputDelay2 = 0.f;
+}
 
-        if (newTime > static_cast<float>(maxDelayLength)) {
-            newTime = static_cast<float>(maxDelayLength);
-        }
+double FxDelay::getTailLengthSeconds() const
+{
+    const double time = timeMs.load() / 1000.0;
+    const double feedback = params.delayFeedback.get();
 
-        float oldTime = params.delayTime.get();
-        // only notify ui (and host) if change is greater than .1 ms
-        params.delayTime.set(newTime, std::abs(oldTime-newTime) > .1f);
+    if (feedback < .001) {
+        // a single repetition
+        return time;
     }
+    if (feedback > .999) {
+        return maxTailSeconds;
+    }
+    // number of repetitions until -60 dB
+    const double repetitions = std::log(.001) / std::log(feedback);
+    return jmin(maxTailSeconds, time * (repetitions + 1.0));
 }
 
-void FxDelay::render(AudioSampleBuffer& outputBuffer, int startSample, int numSamplesIn)
+float FxDelay::calcTime(double bpmIn) const
 {
-    ignoreUnused(numSamplesIn); // to get rid of the compiler warning, since it is not used yet
+    if (params.delaySync.getStep() == eOnOffToggle::eOff) {
+        return params.delayTime.get();
+    }
 
-    int newLoopLength;
-    calcTime();
+    float newTime = static_cast<float>(4000.0 * (1. / (bpmIn / 60.)) *
+                                       static_cast<double>(params.delayDividend.get() / params.delayDivisor.get()));
 
-    for (int s = 0; s < outputBuffer.getNumSamples(); ++s)
-    {
-        // get new length from UI
-        newLoopLength = static_cast<int>(params.delayTime.get() * (sampleRate / 1000.0));
+    if (params.delayDottedLength.getStep() == eOnOffToggle::eOn) {
+        newTime *= 1.5f;
+    }
+    if (params.delayTriplet.getStep() == eOnOffToggle::eOn) {
+        newTime *= 2.f/3.f;
+    }
+
+    return jmin(newTime, static_cast<float>(maxDelayLength));
+}
 
-        // reset the loop position according to the current delay length
-        loopPosition %= newLoopLength;
+double FxDelay::hostTempo(int endSample)
+{
+    const AudioPlayHead::CurrentPositionInfo& info = params.positionInfo[params.getGUIIndex()];
+    if (info.bpm <= 0.) {
+        return bpm;
+    }
+    if (!info.isPlaying) {
+        tempoSlope = 0.;
+        return info.bpm;
+    }
 
-        // clear old material from buffer
-        if (newLoopLength < currentDelayLength) { // TODO: this is still a bit messy
-            delayBuffer.clear(newLoopLength, delayBuffer.getNumSamples() - currentDelayLength);
+    // a new host block, the fx chain may render one block in several ranges
+    if (info.timeInSamples != lastTimeInSamples) {
+        const int64 elapsed = info.timeInSamples - lastTimeInSamples;
+        const double beats = info.ppqPosition - lastPpq;
+        tempoSlope = 0.;
+        if (elapsed > 0 && elapsed < static_cast<int64>(sampleRate) && beats > 0.) {
+            // average tempo of the last block, which is the tempo at its center during a ramp
+            const double measured = beats * 60. * sampleRate / static_cast<double>(elapsed);
+            // larger differences are tempo jumps or transport relocations
+            if (std::abs(measured - info.bpm) < .1 * info.bpm) {
+                tempoSlope = (info.bpm - measured) / (.5 * static_cast<double>(elapsed));
+            }
         }
+        lastTimeInSamples = info.timeInSamples;
+        lastPpq = info.ppqPosition;
+    }
 
-        for (int c = 0; c < outputBuffer.getNumChannels(); ++c) {
+    return jmax(1., info.bpm + tempoSlope * endSample);
+}
 
-            // get current samples
-            float currentSample = outputBuffer.getSample(c, startSample + s);
-            float delayedSample = delayBuffer.getSample(c, loopPosition);
+void FxDelay::render(AudioSampleBuffer& outputBuffer, int startSample, int numSamplesIn)
+{
+    const int bufferLength = delayBuffer.getNumSamples();
+    if (bufferLength == 0 || numSamplesIn <= 0) {
+        return;
+    }
 
-            // calc index for loop direction (reverse mode)
-            int orderPosition;
+    const bool reverse = params.delayReverse.getStep() == eOnOffToggle::eOn;
+    // in reverse mode the read head moves up to two delay lengths behind the write head
+    const float maxDelay = static_cast<float>(reverse ? (bufferLength - 3) / 2 : bufferLength - 2);
 
-            if (params.delayReverse.getStep() == eOnOffToggle::eOff) {
-                orderPosition = loopPosition;
-            } else { orderPosition = newLoopLength - loopPosition; }
+    bpm = hostTempo(startSample + numSamplesIn);
+    // the manual time is smoothed and can be modulated by the global mod bus
+    const float time = (params.delaySync.getStep() == eOnOffToggle::eOff)
+        ? params.delayTimeRamp.getRamp(startSample)[numSamplesIn - 1] : calcTime(bpm);
+    timeMs.store(time);
 
-            // add new material to buffer, filterd or not
-            delayBuffer.setSample(c, orderPosition, currentSample);
+    // glide from the current to the new delay length over this range
+    const float target = jlimit(1.f, maxDelay, time * static_cast<float>(sampleRate / 1000.0));
+    const float glide = jlimit(-maxGlideSpeed, maxGlideSpeed, (target - delaySamples) / static_cast<float>(numSamplesIn));
 
-            if (params.delayRecordFilter.getStep() == eOnOffToggle::eOn) {
-                delayedSample = filter(delayedSample);
+    const float* feedback = params.delayFeedbackRamp.getRamp(startSample);
+    const float* dryWet = params.delayDryWetRamp.getRamp(startSample);
+    const float* cutoff = params.delayCutoffRamp.getRamp(startSample);
+    const bool recordFilter = params.delayRecordFilter.getStep() == eOnOffToggle::eOn;
+    const int numChannels = jmin(outputBuffer.getNumChannels(), delayBuffer.getNumChannels());
+
+    for (int s = 0; s < numSamplesIn; ++s)
+    {
+        delaySamples = jlimit(1.f, maxDelay, delaySamples + glide);
+
+        // distance of the read head, reverse mode reads the last segment backwards
+        float readDelay = delaySamples;
+        if (reverse) {
+            if (reversePhase >= delaySamples) {
+                reversePhase -= delaySamples;
+                if (reversePhase >= delaySamples) {
+                    reversePhase = 0.f;
+                }
             }
+            readDelay = 1.f + 2.f * reversePhase;
+            reversePhase += 1.f;
+        }
 
-            delayBuffer.addSample(c, orderPosition, delayedSample * params.delayFeedback.get());
+        float readPosition = static_cast<float>(writePosition) - readDelay;
+        if (readPosition < 0.f) {
+            readPosition += static_cast<float>(bufferLength);
+        }
+        const int index0 = static_cast<int>(readPosition);
+        const int index1 = (index0 + 1 < bufferLength) ? index0 + 1 : 0;
+        const float frac = readPosition - static_cast<float>(index0);
 
-            if (params.delayRecordFilter.getStep() == eOnOffToggle::eOff) {
-                delayedSample = filter(delayedSample);
-            }
+        for (int c = 0; c < numChannels; ++c) {
+            float* delayData = delayBuffer.getWritePointer(c);
+
+            // get current samples
+            const float currentSample = outputBuffer.getSample(c, startSample + s);
+            float delayedSample = delayData[index0] + frac * (delayData[index1] - delayData[index0]);
 
-            outputBuffer.addSample(c, startSample + s, delayedSample * params.delayDryWet.get());
+            // add new material to buffer, filterd or not
+            if (recordFilter) {
+                delayedSample = filter(delayedSample, cutoff[s]);
+                delayData[writePosition] = currentSample + delayedSample * feedback[s];
+            } else {
+                delayData[writePosition] = currentSample + delayedSample * feedback[s];
+                delayedSample = filter(delayedSample, cutoff[s]);
+            }
 
+            outputBuffer.addSample(c, startSample + s, delayedSample * dryWet[s]);
         }
+
         // iterate
-        currentDelayLength = newLoopLength;
-        ++loopPosition;
+        if (++writePosition >= bufferLength) {
+            writePosition = 0;
+        }
     }
+
+    // the filter feeds back into the delay buffer
+    snapToZero(fInputDelay1);
+    snapToZero(fInputDelay2);
+    snapToZero(fOutputDelay1);
+    snapToZero(fOutputDelay2);
 }
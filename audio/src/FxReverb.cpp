@@ -0,0 +1,223 @@
+/*
+  ==============================================================================
+
+    FxReverb.cpp
+
+  ==============================================================================
+*/
+
+#include "FxReverb.h"
+
+// same condition as juce_audio_basics uses for its vector operations
+#if JUCE_INTEL && ! (JUCE_MINGW && ! defined (__SSE2__))
+ #define SYNISTER_USE_SSE 1
+ #include <xmmintrin.h>
+#else
+ #define SYNISTER_USE_SSE 0
+#endif
+
+namespace {
+    // prime line lengths in samples at 44.1 kHz for the room size 1
+    const int baseLengths[FxReverb::numLines] = { 1999, 2137, 2269, 2423, 2591, 2753, 2917, 3089 };
+    const float maxSizeFactor = 2.f;        // line length factor at full size
+    const float minSizeFactor = .2f;        // line length factor at zero size
+    const float maxPredelayMs = 200.f;      // must match the range of revPredelay
+    const float inputGain = .35f;           // about 1/sqrt(numLines)
+
+    // output taps with alternating signs to decorrelate the two channels
+    const float tapsLeft[FxReverb::numLines] = { .25f, -.25f, .25f, -.25f, .25f, -.25f, .25f, -.25f };
+    const float tapsRight[FxReverb::numLines] = { .25f, .25f, -.25f, -.25f, .25f, .25f, -.25f, -.25f };
+
+    //! four floats that are processed in parallel
+    struct Vec4 {
+#if SYNISTER_USE_SSE
+        __m128 v;
+
+        static Vec4 load(const float* p) { Vec4 r; r.v = _mm_loadu_ps(p); return r; }
+        static Vec4 fill(float f) { Vec4 r; r.v = _mm_set1_ps(f); return r; }
+        void store(float* p) const { _mm_storeu_ps(p, v); }
+
+        Vec4 operator+ (Vec4 o) const { Vec4 r; r.v = _mm_add_ps(v, o.v); return r; }
+        Vec4 operator- (Vec4 o) const { Vec4 r; r.v = _mm_sub_ps(v, o.v); return r; }
+        Vec4 operator* (Vec4 o) const { Vec4 r; r.v = _mm_mul_ps(v, o.v); return r; }
+
+        float sum() const {
+            __m128 s = _mm_add_ps(v, _mm_movehl_ps(v, v));
+            s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+            return _mm_cvtss_f32(s);
+        }
+#else
+        float v[4];
+
+        static Vec4 load(const float* p) { Vec4 r; for (int i = 0; i < 4; ++i) r.v[i] = p[i]; return r; }
+        static Vec4 fill(float f) { Vec4 r; for (int i = 0; i < 4; ++i) r.v[i] = f; return r; }
+        void store(float* p) const { for (int i = 0; i < 4; ++i) p[i] = v[i]; }
+
+        Vec4 operator+ (Vec4 o) const { Vec4 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] + o.v[i]; return r; }
+        Vec4 operator- (Vec4 o) const { Vec4 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] - o.v[i]; return r; }
+        Vec4 operator* (Vec4 o) const { Vec4 r; for (int i = 0; i < 4; ++i) r.v[i] = v[i] * o.v[i]; return r; }
+
+        float sum() const { return v[0] + v[1] + v[2] + v[3]; }
+#endif
+    };
+}
+
+void FxReverb::init(int channelsIn, double sampleRateIn)
+{
+    ignoreUnused(channelsIn);
+    sampleRate = sampleRateIn;
+
+    int longest = 0;
+    for (int l : baseLengths) {
+        longest = jmax(longest, l);
+    }
+    lineLength = static_cast<int>(std::ceil(longest * maxSizeFactor * sampleRate / 44100.)) + 1;
+    lines.allocate(static_cast<size_t>(numLines * lineLength), true);
+
+    predelayBuffer.setSize(1, static_cast<int>(maxPredelayMs / 1000.f * sampleRate) + 1);
+
+    updateLines(params.revDecay.get());
+    reset();
+}
+
+void FxReverb::reset()
+{
+    if (lineLength > 0) {
+        FloatVectorOperations::clear(lines, numLines * lineLength);
+    }
+    predelayBuffer.clear();
+    lowpassState.fill(0.f);
+    writePosition = 0;
+    predelayPosition = 0;
+}
+
+void FxReverb::updateLines(float decaySeconds)
+{
+    const float factor = minSizeFactor + (maxSizeFactor - minSizeFactor) * params.revSize.get();
+    const double scale = factor * sampleRate / 44100.;
+
+    for (int i = 0; i < numLines; ++i) {
+        delay[i] = jlimit(1, jmax(1, lineLength - 1), static_cast<int>(baseLengths[i] * scale));
+    }
+    updateGains(decaySeconds);
+}
+
+void FxReverb::updateGains(float decaySeconds)
+{
+    const double decaySamples = decaySeconds * sampleRate;
+
+    for (int i = 0; i < numLines; ++i) {
+        // -60 dB after the decay time, independent of the line length
+        gain[i] = static_cast<float>(std::pow(10., -3. * delay[i] / decaySamples));
+    }
+}
+
+void FxReverb::render(AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
+{
+    if (numSamples <= 0) {
+        return;
+    }
+
+    const float* decay = params.revDecayRamp.getRamp(startSample);
+    const float* damping = params.revDampingRamp.getRamp(startSample);
+    // size and predelay move the read taps, they follow the params once per range
+    updateLines(decay[0]);
+
+    // gains and damping only follow the ramps per sample while they run
+    const bool decayRamps = decay[0] != decay[numSamples - 1];
+    const bool dampingRamps = damping[0] != damping[numSamples - 1];
+
+    const int channels = outputBuffer.getNumChannels();
+    const float* wetness = params.revDryWetRamp.getRamp(startSample);
+    const int predelayLength = predelayBuffer.getNumSamples();
+    const int predelaySamples = jmin(predelayLength - 1,
+        static_cast<int>(params.revPredelay.get() / 1000.f * static_cast<float>(sampleRate)));
+    float* predelayData = predelayBuffer.getWritePointer(0);
+
+    Vec4 d = Vec4::fill(.95f * damping[0]);
+    Vec4 g0 = Vec4::load(&gain[0]);
+    Vec4 g1 = Vec4::load(&gain[4]);
+    const Vec4 left0 = Vec4::load(&tapsLeft[0]);
+    const Vec4 left1 = Vec4::load(&tapsLeft[4]);
+    const Vec4 right0 = Vec4::load(&tapsRight[0]);
+    const Vec4 right1 = Vec4::load(&tapsRight[4]);
+    Vec4 lp0 = Vec4::load(&lowpassState[0]);
+    Vec4 lp1 = Vec4::load(&lowpassState[4]);
+
+    float out[numLines];
+    float feedback[numLines];
+
+    for (int s = startSample; s < startSample + numSamples; ++s) {
+        if (decayRamps) {
+            updateGains(decay[s - startSample]);
+            g0 = Vec4::load(&gain[0]);
+            g1 = Vec4::load(&gain[4]);
+        }
+        if (dampingRamps) {
+            d = Vec4::fill(.95f * damping[s - startSample]);
+        }
+
+        // mono input through the predelay
+        float input = 0.f;
+        for (int c = 0; c < channels; ++c) {
+            input += outputBuffer.getSample(c, s);
+        }
+        predelayData[predelayPosition] = input / static_cast<float>(jmax(1, channels));
+        int readPosition = predelayPosition - predelaySamples;
+        if (readPosition < 0) readPosition += predelayLength;
+        const Vec4 in = Vec4::fill(predelayData[readPosition] * inputGain);
+        if (++predelayPosition >= predelayLength) predelayPosition = 0;
+
+        // read the delay lines
+        for (int i = 0; i < numLines; ++i) {
+            int pos = writePosition - delay[i];
+            if (pos < 0) pos += lineLength;
+            out[i] = lines[i * lineLength + pos];
+        }
+        const Vec4 o0 = Vec4::load(&out[0]);
+        const Vec4 o1 = Vec4::load(&out[4]);
+
+        // damping and decay
+        lp0 = o0 + d * (lp0 - o0);
+        lp1 = o1 + d * (lp1 - o1);
+        const Vec4 v0 = lp0 * g0;
+        const Vec4 v1 = lp1 * g1;
+
+        // Householder feedback matrix: v - 2/N * sum(v)
+        const Vec4 reflect = Vec4::fill((v0 + v1).sum() * (2.f / numLines));
+        (v0 - reflect + in).store(&feedback[0]);
+        (v1 - reflect + in).store(&feedback[4]);
+
+        for (int i = 0; i < numLines; ++i) {
+            lines[i * lineLength + writePosition] = feedback[i];
+        }
+        if (++writePosition >= lineLength) writePosition = 0;
+
+        // mix into the output
+        const float wetLeft = (o0 * left0 + o1 * left1).sum();
+        const float wetRight = (o0 * right0 + o1 * right1).sum();
+        const float wet = wetness[s - startSample];
+        const float dry = 1.f - wet;
+        for (int c = 0; c < channels; ++c) {
+            const float w = (channels == 1) ? .5f * (wetLeft + wetRight) : ((c % 2 == 0) ? wetLeft : wetRight);
+            outputBuffer.setSample(c, s, outputBuffer.getSample(c, s) * dry + w * wet);
+        }
+    }
+
+    lp0.store(&lowpassState[0]);
+    lp1.store(&lowpassState[4]);
+    // keep the filter states out of the denormal range
+    for (float &f : lowpassState) {
+        snapToZero(f);
+    }
+}
+
+double FxReverb::getTailLengthSeconds() const
+{
+    const float factor = minSizeFactor + (maxSizeFactor - minSizeFactor) * params.revSize.get();
+    int longest = 0;
+    for (int l : baseLengths) {
+        longest = jmax(longest, l);
+    }
+    return params.revPredelay.get() / 1000. + longest * factor / 44100. + params.revDecay.get();
+}
@@ -0,0 +1,279 @@
+/*
+  ==============================================================================
+
+    GlobalModBus.cpp
+
+  ==============================================================================
+*/
+
+#include "GlobalModBus.h"
+
+GlobalModBus::GlobalModBus(SynthParams &p)
+    : params(p)
+    , sampleRate(44100.)
+    , blockSize(0)
+{
+    for (GlobalLfo &l : lfos) {
+        l.phase = 0.;
+        l.value = 0.f;
+        l.used = false;
+    }
+    for (Destination &dest : destinations) {
+        dest.start = dest.target = 0.f;
+        dest.lfoStart.fill(0.f);
+        dest.lfoTarget.fill(0.f);
+        dest.active = false;
+    }
+}
+
+void GlobalModBus::init(double sampleRateIn, int maxNumSamples)
+{
+    sampleRate = sampleRateIn;
+    lfoBuffer.setSize(static_cast<int>(nLfos), jmax(1, maxNumSamples));
+    modBuffer.setSize(1, jmax(1, maxNumSamples));
+}
+
+void GlobalModBus::beginBlock(int numSamples)
+{
+    blockSize = numSamples;
+
+    // sum of all slots per destination, the lfo amounts are applied per sample
+    std::array<float, nDestinations> mod;
+    std::array<std::array<float, nLfos>, nDestinations> lfoMod;
+    std::array<bool, nDestinations> used;
+    mod.fill(0.f);
+    for (std::array<float, nLfos> &l : lfoMod) {
+        l.fill(0.f);
+    }
+    used.fill(false);
+    for (GlobalLfo &l : lfos) {
+        l.used = false;
+    }
+    for (const SynthParams::GlobalModSlot &slot : params.globalModSlot) {
+        const eGlobalModSource source = slot.source.getStep();
+        const size_t d = static_cast<size_t>(slot.destination.getStep());
+        if (source == eGlobalModSource::eNone || d == static_cast<size_t>(eGlobalModDest::eNone) || d >= nDestinations) {
+            continue;
+        }
+        const float amount = slot.amount.get() * .01f;
+        if (source == eGlobalModSource::eGlobalLfo1 || source == eGlobalModSource::eGlobalLfo2) {
+            const size_t l = source == eGlobalModSource::eGlobalLfo1 ? 0 : 1;
+            lfoMod[d][l] += amount;
+            lfos[l].used = true;
+        } else {
+            mod[d] += amount * getSourceValue(source);
+        }
+        used[d] = true;
+    }
+
+    for (size_t d = 1; d < nDestinations; ++d) {
+        Destination &state = destinations[d];
+        state.start = state.target;
+        state.target = mod[d];
+        state.lfoStart = state.lfoTarget;
+        state.lfoTarget = lfoMod[d];
+        // a removed slot still glides back within this block
+        bool lfoActive = false;
+        for (size_t l = 0; l < nLfos; ++l) {
+            lfoActive = lfoActive || state.lfoStart[l] != 0.f;
+            // the lfo of a removed slot is faded out with the others
+            lfos[l].used = lfos[l].used || state.lfoStart[l] != 0.f;
+        }
+        state.active = used[d] || lfoActive || state.start != 0.f;
+    }
+}
+
+void GlobalModBus::render(int startSample, int numSamples)
+{
+    numSamples = jmin(numSamples, modBuffer.getNumSamples());
+    if (blockSize <= 0 || numSamples <= 0) {
+        return;
+    }
+
+    for (size_t l = 0; l < nLfos; ++l) {
+        if (lfos[l].used) {
+            renderLfo(l, numSamples);
+        } else {
+            advanceLfo(l, numSamples);
+        }
+    }
+
+    float* values = modBuffer.getWritePointer(0);
+    for (size_t d = 1; d < nDestinations; ++d) {
+        const Destination &state = destinations[d];
+        if (!state.active) {
+            continue;
+        }
+        const eGlobalModDest dest = static_cast<eGlobalModDest>(d);
+
+        bool lfoActive = false;
+        std::array<float, nLfos> lfoStep;
+        for (size_t l = 0; l < nLfos; ++l) {
+            lfoActive = lfoActive || state.lfoStart[l] != 0.f || state.lfoTarget[l] != 0.f;
+            lfoStep[l] = (state.lfoTarget[l] - state.lfoStart[l]) / static_cast<float>(blockSize);
+        }
+
+        if (!lfoActive && state.start == state.target) {
+            FloatVectorOperations::fill(values, toRampValue(dest, jlimit(-1.f, 1.f, state.target)), numSamples);
+        } else {
+            // linear from the amounts of the last block to the new ones, the last sample of the block hits the target
+            const float step = (state.target - state.start) / static_cast<float>(blockSize);
+            for (int s = 0; s < numSamples; ++s) {
+                const float position = static_cast<float>(startSample + s + 1);
+                float mod = state.start + step * position;
+                if (lfoActive) {
+                    for (size_t l = 0; l < nLfos; ++l) {
+                        mod += (state.lfoStart[l] + lfoStep[l] * position) * lfoBuffer.getSample(static_cast<int>(l), s);
+                    }
+                }
+                values[s] = toRampValue(dest, jlimit(-1.f, 1.f, mod));
+            }
+        }
+        getRamp(dest).modulate(getMode(dest), values, numSamples);
+    }
+}
+
+void GlobalModBus::advanceLfo(size_t i, int numSamples)
+{
+    GlobalLfo &l = lfos[i];
+
+    l.phase += static_cast<double>(numSamples) * params.globalLfo[i].freq.get() / sampleRate;
+    if (l.phase >= 1. && params.globalLfo[i].wave.getStep() == eLfoWaves::eLfoSampleHold) {
+        l.value = random.nextFloat() * 2.f - 1.f;
+    }
+    l.phase -= std::floor(l.phase);
+    l.value = getLfoOutput(i, l.phase);
+}
+
+void GlobalModBus::renderLfo(size_t i, int numSamples)
+{
+    GlobalLfo &l = lfos[i];
+    const SynthParams::GlobalLfo &p = params.globalLfo[i];
+    const double delta = p.freq.get() / sampleRate;
+    const bool sampleHold = p.wave.getStep() == eLfoWaves::eLfoSampleHold;
+
+    float* out = lfoBuffer.getWritePointer(static_cast<int>(i));
+    for (int s = 0; s < numSamples; ++s) {
+        l.phase += delta;
+        if (l.phase >= 1.) {
+            l.phase -= std::floor(l.phase);
+            if (sampleHold) {
+                l.value = random.nextFloat() * 2.f - 1.f;
+            }
+        }
+        l.value = getLfoOutput(i, l.phase);
+        out[s] = l.value;
+    }
+}
+
+float GlobalModBus::getLfoOutput(size_t i, double phase) const
+{
+    switch (params.globalLfo[i].wave.getStep()) {
+    case eLfoWaves::eLfoSquare:
+        return phase < .5 ? 1.f : -1.f;
+    case eLfoWaves::eLfoSampleHold:
+        return lfos[i].value;
+    default:
+        return static_cast<float>(std::sin(2. * double_Pi * phase));
+    }
+}
+
+float GlobalModBus::getSourceValue(eGlobalModSource source) const
+{
+    switch (source) {
+    case eGlobalModSource::eGlobalLfo1:
+        return lfos[0].value;
+    case eGlobalModSource::eGlobalLfo2:
+        return lfos[1].value;
+    case eGlobalModSource::eSeqLane:
+        // the lane is rendered with the ranges, this is its value at the end of the last block
+        return params.seqModLane.getCurrent();
+    case eGlobalModSource::eModwheel:
+        return params.midiState.getNormalized(MidiState::eModwheel);
+    case eGlobalModSource::eFoot:
+        return params.midiState.getNormalized(MidiState::eFoot);
+    case eGlobalModSource::eExpPedal:
+        return params.midiState.getNormalized(MidiState::eExpPedal);
+    default:
+        return 0.f;
+    }
+}
+
+float GlobalModBus::toRampValue(eGlobalModDest dest, float mod) const
+{
+    const Param &p = getParam(dest);
+    switch (dest) {
+    case eGlobalModDest::eMasterAmp:
+    case eGlobalModDest::eClipping:
+        // the full amount spans the dB range
+        return Param::fromDb(mod * (p.getMax() - p.getMin()));
+    case eGlobalModDest::eDelayTime:
+        // the full amount spans the range in octaves
+        return std::pow(2.f, mod * std::log2(p.getMax() / p.getMin()));
+    default:
+        return mod * (p.getMax() - p.getMin());
+    }
+}
+
+const Param& GlobalModBus::getParam(eGlobalModDest dest) const
+{
+    switch (dest) {
+    case eGlobalModDest::eMasterAmp:
+        return params.masterAmp;
+    case eGlobalModDest::eMasterPan:
+        return params.masterPan;
+    case eGlobalModDest::eDelayTime:
+        return params.delayTime;
+    case eGlobalModDest::eDelayFeedback:
+        return params.delayFeedback;
+    case eGlobalModDest::eChorusDepth:
+        return params.chorModDepth;
+    case eGlobalModDest::eClipping:
+        return params.clippingFactor;
+    case eGlobalModDest::eLowFiBits:
+        return params.nBitsLowFi;
+    default:
+        jassertfalse;
+        return params.masterAmp;
+    }
+}
+
+float GlobalModBus::getNeutral(eGlobalModDest dest)
+{
+    return getMode(dest) == ParamRamp::eMode::eMultiplicative ? 1.f : 0.f;
+}
+
+ParamRamp::eMode GlobalModBus::getMode(eGlobalModDest dest)
+{
+    switch (dest) {
+    case eGlobalModDest::eMasterAmp:
+    case eGlobalModDest::eDelayTime:
+    case eGlobalModDest::eClipping:
+        return ParamRamp::eMode::eMultiplicative;
+    default:
+        return ParamRamp::eMode::eLinear;
+    }
+}
+
+ParamRamp& GlobalModBus::getRamp(eGlobalModDest dest)
+{
+    switch (dest) {
+    case eGlobalModDest::eMasterAmp:
+        return params.masterAmpRamp;
+    case eGlobalModDest::eMasterPan:
+        return params.masterPanRamp;
+    case eGlobalModDest::eDelayTime:
+        return params.delayTimeRamp;
+    case eGlobalModDest::eDelayFeedback:
+        return params.delayFeedbackRamp;
+    case eGlobalModDest::eChorusDepth:
+        return params.chorModDepthRamp;
+    case eGlobalModDest::eClipping:
+        return params.clippingFactorRamp;
+    case eGlobalModDest::eLowFiBits:
+        return params.nBitsLowFiRamp;
+    default:
+        jassertfalse;
+        return params.masterAmpRamp;
+    }
+}
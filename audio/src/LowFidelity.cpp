@@ -12,19 +12,26 @@
 
 LowFidelity::~LowFidelity() {};
 
-void LowFidelity::bitReduction(AudioSampleBuffer& outputBuffer)
+void LowFidelity::bitReduction(AudioSampleBuffer& outputBuffer, int startSample, int numSamples)
 {
-    // coeff = 2^(nBitsLowFi-1)
-    float coeff = pow(2.f, params.nBitsLowFi.get() - 1.f);
+    const float* nBits = params.nBitsLowFiRamp.getRamp(startSample);
 
     //For all the outputs
     for (int c = 0; c < outputBuffer.getNumChannels(); ++c)
     {
+        // coeff = 2^(nBitsLowFi-1), only recalculated while the bit depth moves
+        float bits = nBits[0];
+        float coeff = pow(2.f, bits - 1.f);
+
         // Bit degradation
-        for (int s = 0; s < outputBuffer.getNumSamples(); ++s)
+        for (int s = 0; s < numSamples; ++s)
         {
-            float newSampleVal = floor(coeff * (outputBuffer.getSample(c, s)) + 0.5f) / coeff;
-            outputBuffer.setSample(c, s, newSampleVal);
+            if (nBits[s] != bits) {
+                bits = nBits[s];
+                coeff = pow(2.f, bits - 1.f);
+            }
+            float newSampleVal = floor(coeff * (outputBuffer.getSample(c, startSample + s)) + 0.5f) / coeff;
+            outputBuffer.setSample(c, startSample + s, newSampleVal);
         }
 
     }
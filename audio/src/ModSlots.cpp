@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+
+    ModSlots.cpp
+
+  ==============================================================================
+*/
+
+#include "ModSlots.h"
+
+namespace {
+    const int minAmount = -100;
+    const int maxAmount = 100;
+
+    const uint8 streamFormat = 1;
+    const int streamBytesPerSlot = 1 + sizeof(uint32);
+
+    const char *slotTag = "slot";
+}
+
+ModSlots::ModSlots()
+{
+    for (std::atomic<uint32> &s : slots) {
+        s.store(pack(getEmptySlot()));
+    }
+}
+
+ModSlots::Slot ModSlots::getSlot(int slot) const
+{
+    return unpack(slots[clampSlot(slot)].load());
+}
+
+void ModSlots::setSlot(int slot, const Slot &s)
+{
+    slots[clampSlot(slot)].store(pack(s));
+}
+
+void ModSlots::clearSlot(int slot)
+{
+    setSlot(slot, getEmptySlot());
+}
+
+int ModSlots::findFreeSlot() const
+{
+    for (int i = 0; i < maxSlots; ++i) {
+        if (!isUsed(getSlot(i))) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+ModSlots::Slot ModSlots::getEmptySlot()
+{
+    Slot s;
+    s.source = eModSource::eNone;
+    s.destination = DEST_NONE;
+    s.amount = 0;
+    s.curve = eModCurve::eLinear;
+    s.polarity = eModPolarity::eSource;
+    return s;
+}
+
+bool ModSlots::isUsed(const Slot &s)
+{
+    return s.source != eModSource::eNone && s.destination != DEST_NONE && s.amount != 0;
+}
+
+void ModSlots::getData(Data &data) const
+{
+    for (int i = 0; i < maxSlots; ++i) {
+        data[i] = slots[i].load();
+    }
+}
+
+void ModSlots::setData(const Data &data)
+{
+    for (int i = 0; i < maxSlots; ++i) {
+        slots[i].store(data[i]);
+    }
+}
+
+void ModSlots::getEmptyData(Data &data)
+{
+    data.fill(pack(getEmptySlot()));
+}
+
+void ModSlots::writeToStream(OutputStream &out) const
+{
+    Data data;
+    getData(data);
+
+    int numUsed = 0;
+    for (uint32 packed : data) {
+        numUsed += isUsed(unpack(packed)) ? 1 : 0;
+    }
+
+    out.writeByte(static_cast<char>(streamFormat));
+    out.writeByte(static_cast<char>(numUsed));
+    for (int i = 0; i < maxSlots; ++i) {
+        if (isUsed(unpack(data[i]))) {
+            out.writeByte(static_cast<char>(i));
+            out.writeInt(static_cast<int>(data[i]));
+        }
+    }
+}
+
+bool ModSlots::readFromStream(InputStream &in, Data &data)
+{
+    getEmptyData(data);
+
+    if (static_cast<uint8>(in.readByte()) != streamFormat) {
+        return false;
+    }
+    const int numUsed = static_cast<uint8>(in.readByte());
+    if (numUsed > maxSlots || in.getNumBytesRemaining() < numUsed * streamBytesPerSlot) {
+        return false;
+    }
+    for (int i = 0; i < numUsed; ++i) {
+        const int slot = static_cast<uint8>(in.readByte());
+        // unpacking and packing again clamps values of other versions
+        const uint32 packed = pack(unpack(static_cast<uint32>(in.readInt())));
+        if (slot < maxSlots) {
+            data[slot] = packed;
+        }
+    }
+    return true;
+}
+
+XmlElement* ModSlots::createXml(const String &tagName) const
+{
+    XmlElement* element = new XmlElement(tagName);
+    for (int i = 0; i < maxSlots; ++i) {
+        const Slot s = getSlot(i);
+        if (isUsed(s)) {
+            XmlElement* child = new XmlElement(slotTag);
+            child->setAttribute("index", i);
+            child->setAttribute("source", static_cast<int>(s.source));
+            child->setAttribute("destination", static_cast<int>(s.destination));
+            child->setAttribute("amount", s.amount);
+            child->setAttribute("curve", static_cast<int>(s.curve));
+            child->setAttribute("polarity", static_cast<int>(s.polarity));
+            element->addChildElement(child);
+        }
+    }
+    return element;
+}
+
+void ModSlots::fromXml(const XmlElement &element, Data &data)
+{
+    getEmptyData(data);
+
+    forEachXmlChildElementWithTagName(element, child, slotTag) {
+        const int slot = child->getIntAttribute("index", -1);
+        if (slot < 0 || slot >= maxSlots) {
+            continue;
+        }
+        Slot s;
+        s.source = static_cast<eModSource>(child->getIntAttribute("source"));
+        s.destination = static_cast<destinations>(child->getIntAttribute("destination", DEST_NONE));
+        s.amount = child->getIntAttribute("amount");
+        s.curve = static_cast<eModCurve>(child->getIntAttribute("curve"));
+        s.polarity = static_cast<eModPolarity>(child->getIntAttribute("polarity"));
+        data[slot] = pack(s);
+    }
+}
+
+uint32 ModSlots::pack(const Slot &s)
+{
+    // one byte each for source, destination and amount, a nibble each for curve and polarity
+    const int source = jlimit(0, eModSource::nSteps - 1, static_cast<int>(s.source));
+    const int destination = jlimit(static_cast<int>(DEST_NONE), MAX_DESTINATIONS - 1, static_cast<int>(s.destination)) + 1;
+    const int amount = jlimit(minAmount, maxAmount, s.amount) - minAmount;
+    const int curve = jlimit(0, static_cast<int>(eModCurve::nSteps) - 1, static_cast<int>(s.curve));
+    const int polarity = jlimit(0, static_cast<int>(eModPolarity::nSteps) - 1, static_cast<int>(s.polarity));
+    return static_cast<uint32>(source | (destination << 8) | (amount << 16) | (curve << 24) | (polarity << 28));
+}
+
+ModSlots::Slot ModSlots::unpack(uint32 packed)
+{
+    Slot s;
+    s.source = static_cast<eModSource>(jmin(static_cast<int>(packed & 0xff), eModSource::nSteps - 1));
+    s.destination = static_cast<destinations>(jmin(static_cast<int>((packed >> 8) & 0xff), static_cast<int>(MAX_DESTINATIONS)) - 1);
+    s.amount = jlimit(minAmount, maxAmount, static_cast<int>((packed >> 16) & 0xff) + minAmount);
+    s.curve = static_cast<eModCurve>(jmin(static_cast<int>((packed >> 24) & 0xf), static_cast<int>(eModCurve::nSteps) - 1));
+    s.polarity = static_cast<eModPolarity>(jmin(static_cast<int>((packed >> 28) & 0xf), static_cast<int>(eModPolarity::nSteps) - 1));
+    return s;
+}
@@ -0,0 +1,47 @@
+/*
+  ==============================================================================
+
+    ModSnapshot.cpp
+
+  ==============================================================================
+*/
+
+#include "ModSnapshot.h"
+
+ModSnapshot::ModSnapshot()
+    : spare(2)
+    , writeIndex(0)
+    , readIndex(1)
+{
+    for (Values &v : slots) {
+        clear(v);
+    }
+}
+
+void ModSnapshot::publish()
+{
+    // release the written slot and continue with the spare one, which may be older
+    writeIndex = spare.exchange(writeIndex | freshBit, std::memory_order_acq_rel) & indexMask;
+}
+
+bool ModSnapshot::fetch()
+{
+    if ((spare.load(std::memory_order_relaxed) & freshBit) == 0) {
+        return false;
+    }
+    // only the writer sets the fresh bit, the exchange clears it and hands over the newest slot
+    readIndex = spare.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+    return true;
+}
+
+void ModSnapshot::clear(Values &v)
+{
+    v.voiceActive = false;
+    v.note = -1;
+    v.destinations.fill(0.f);
+    v.destinationUsed.fill(false);
+    v.lfo.fill(0.f);
+    v.lfoUsed.fill(false);
+    v.env.fill(0.f);
+    v.envUsed.fill(false);
+}
@@ -9,9 +9,16 @@
 */
 
 #include "ModulationMatrix.h"
+#include "ModSlots.h"
 
 ModulationMatrix::ModulationMatrix()
+    : numRows(0)
+    , numUserRows(0)
+    , numActiveRows(0)
 {
+    usedSources.fill(false);
+    usedDestinations.fill(false);
+
     // assertions for how the Voices and filters work
     jassert(DEST_OSC1_GAIN + 1 == DEST_OSC2_GAIN);
     jassert(DEST_OSC1_GAIN + 2 == DEST_OSC3_GAIN);
@@ -40,3 +47,68 @@ ModulationMatrix::ModulationMatrix()
 ModulationMatrix::~ModulationMatrix()
 {
 }
+
+void ModulationMatrix::compileUserSlots(const ModSlots &slots)
+{
+    static_assert(ModSlots::maxSlots <= maxRows, "every user slot needs a row");
+
+    numUserRows = 0;
+    for (int i = 0; i < ModSlots::maxSlots; ++i) {
+        const ModSlots::Slot slot = slots.getSlot(i);
+        if (!ModSlots::isUsed(slot)) {
+            continue;
+        }
+
+        UserRow &row = userRows[numUserRows++];
+        row.source = slot.source;
+        row.destination = slot.destination;
+        row.curve = slot.curve;
+        row.scale = 1.f;
+        row.offset = 0.f;
+        if (slot.polarity == eModPolarity::eUnipolar && !isUnipolar(slot.source)) {
+            row.scale = 0.5f;
+            row.offset = 0.5f;
+        } else if (slot.polarity == eModPolarity::eBipolar && isUnipolar(slot.source)) {
+            row.scale = 2.f;
+            row.offset = -1.f;
+        }
+        row.amount = slot.amount / 100.f;
+    }
+}
+
+void ModulationMatrix::compileRouting()
+{
+    usedSources.fill(false);
+    usedDestinations.fill(false);
+
+    numActiveRows = 0;
+    for (size_t r = 0; r < numRows; ++r)
+    {
+        const ModMatrixRow &row = matrixCore[r];
+        const eModSource source = row.modSrc->getStep();
+        if (source <= eModSource::eNone || source >= eModSource::nSteps
+            || row.destinationIndex <= DEST_NONE || row.destinationIndex >= MAX_DESTINATIONS) {
+            continue;
+        }
+
+        // get the min max values for the intensity for transformation
+        const float min = row.modIntensity->getMin();
+        const float max = row.modIntensity->getMax();
+
+        ActiveRow &active = activeRows[numActiveRows++];
+        active.source = source;
+        active.destination = row.destinationIndex;
+        // a unipolar source gets a bipolar intensity and vice versa
+        active.intensity = isUnipolar(source) ? toBipolar(min, max, row.modIntensity->get())
+                                              : toUnipolar(min, max, row.modIntensity->get());
+
+        usedSources[source] = true;
+        usedDestinations[row.destinationIndex] = true;
+    }
+
+    for (size_t r = 0; r < numUserRows; ++r)
+    {
+        usedSources[userRows[r].source] = true;
+        usedDestinations[userRows[r].destination] = true;
+    }
+}
@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    ParamEventQueue.cpp
+
+  ==============================================================================
+*/
+
+#include "ParamEventQueue.h"
+
+namespace {
+    const size_t mask = ParamEventQueue::capacity - 1;
+}
+
+ParamEventQueue::ParamEventQueue()
+    : enqueuePosition(0)
+    , dequeuePosition(0)
+{
+    static_assert((capacity & (capacity - 1)) == 0, "capacity must be a power of two");
+    for (size_t i = 0; i < capacity; ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool ParamEventQueue::push(const Event& e)
+{
+    size_t pos = enqueuePosition.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells[pos & mask];
+        const size_t seq = cell->sequence.load(std::memory_order_acquire);
+        const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            // the cell is free, try to claim it
+            if (enqueuePosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // full
+            return false;
+        } else {
+            // another producer was faster
+            pos = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+    cell->event = e;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool ParamEventQueue::pop(Event& e)
+{
+    const size_t pos = dequeuePosition.load(std::memory_order_relaxed);
+    Cell& cell = cells[pos & mask];
+    if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+        // empty, or the producer has not finished writing
+        return false;
+    }
+    e = cell.event;
+    cell.sequence.store(pos + capacity, std::memory_order_release);
+    dequeuePosition.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    ParamRamp.cpp
+
+  ==============================================================================
+*/
+
+#include "ParamRamp.h"
+
+ParamRamp::ParamRamp(Param &p, eMode m, float rampSeconds)
+    : param(p)
+    , mode(m)
+    , rampTime(rampSeconds)
+    , sampleRate(44100.)
+    , capacity(0)
+    , rangeStart(0)
+    , current(p.get())
+    , target(p.get())
+    , step(0.f)
+    , stepsLeft(0)
+    , multiplicative(false)
+{
+}
+
+void ParamRamp::init(double sampleRateIn, int maxNumSamples)
+{
+    sampleRate = sampleRateIn;
+    capacity = jmax(1, maxNumSamples);
+    values.allocate(static_cast<size_t>(capacity), true);
+    reset();
+}
+
+void ParamRamp::setRampTime(float seconds)
+{
+    rampTime = jmax(0.f, seconds);
+}
+
+void ParamRamp::reset()
+{
+    current = target = param.get();
+    stepsLeft = 0;
+}
+
+void ParamRamp::render(int startSample, int numSamples)
+{
+    jassert(numSamples <= capacity);
+    numSamples = jmin(numSamples, capacity);
+    rangeStart = startSample;
+
+    const float newTarget = param.get();
+    if (newTarget != target) {
+        target = newTarget;
+        stepsLeft = jmax(1, roundToInt(rampTime * sampleRate));
+        // linear also for multiplicative ramps that start or end at zero
+        multiplicative = mode == eMode::eMultiplicative && current > 0.f && target > 0.f;
+        if (multiplicative) {
+            step = std::pow(target / current, 1.f / static_cast<float>(stepsLeft));
+        } else {
+            step = (target - current) / static_cast<float>(stepsLeft);
+        }
+    }
+
+    int s = 0;
+    if (stepsLeft > 0) {
+        const int rampSamples = jmin(stepsLeft, numSamples);
+        for (; s < rampSamples; ++s) {
+            current = multiplicative ? current * step : current + step;
+            values[s] = current;
+        }
+        stepsLeft -= rampSamples;
+        if (stepsLeft == 0) {
+            // no rounding errors at the end of the ramp
+            current = target;
+        }
+    }
+    if (s < numSamples) {
+        FloatVectorOperations::fill(values + s, current, numSamples - s);
+    }
+}
+
+void ParamRamp::modulate(eMode m, const float* mod, int numSamples)
+{
+    numSamples = jmin(numSamples, capacity);
+    if (m == eMode::eMultiplicative) {
+        FloatVectorOperations::multiply(values, mod, numSamples);
+    } else {
+        FloatVectorOperations::add(values, mod, numSamples);
+    }
+    // fromUI maps the range of ParamDb to gains
+    const float lo = param.fromUI(param.getMin());
+    const float hi = param.fromUI(param.getMax());
+    FloatVectorOperations::clip(values, values, lo, hi, numSamples);
+}
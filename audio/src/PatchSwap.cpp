@@ -0,0 +1,159 @@
+/*
+  ==============================================================================
+
+    PatchSwap.cpp
+
+  ==============================================================================
+*/
+
+#include "PatchSwap.h"
+
+namespace {
+    const float fadeSeconds = .01f;     // length of the fade out and of the fade in
+    const int pollIntervalMs = 10;      // how often the message thread looks for applied snapshots
+}
+
+PatchSwap::PatchSwap()
+    : transition(eTransition::eFade)
+    , audioActive(false)
+    , published(nullptr)
+    , retired(nullptr)
+    , gain(1.f)
+    , fadeStep(1.f)
+    , fadeDirection(0)
+{
+}
+
+PatchSwap::~PatchSwap()
+{
+    stopTimer();
+    // the audio thread is gone, a retired snapshot is the published one
+    delete published.exchange(nullptr);
+}
+
+void PatchSwap::prepare(double sampleRate)
+{
+    fadeStep = 1.f / jmax(1.f, static_cast<float>(sampleRate) * fadeSeconds);
+    gain = 1.f;
+    fadeDirection = 0;
+    audioActive.store(true);
+}
+
+void PatchSwap::release()
+{
+    audioActive.store(false);
+    stopTimer();
+
+    const ScopedLock lock(waitingLock);
+    PatchSnapshot* s = published.exchange(nullptr);
+    if (s != nullptr && retired.exchange(nullptr) == s) {
+        // applied already, only the listeners are missing
+        s->notifyListeners();
+        delete s;
+    } else if (s != nullptr) {
+        applyNow(s);
+    }
+    while (waiting.size() > 0) {
+        applyNow(waiting.removeAndReturn(0));
+    }
+    gain = 1.f;
+    fadeDirection = 0;
+}
+
+void PatchSwap::post(PatchSnapshot* snapshot)
+{
+    if (!audioActive.load()) {
+        applyNow(snapshot);
+        return;
+    }
+    {
+        const ScopedLock lock(waitingLock);
+        waiting.add(snapshot);
+    }
+    exchange();
+    startTimer(pollIntervalMs);
+}
+
+void PatchSwap::applyNow(PatchSnapshot* snapshot)
+{
+    const ScopedPointer<PatchSnapshot> owner(snapshot);
+    snapshot->apply();
+    snapshot->notifyListeners();
+}
+
+void PatchSwap::exchange()
+{
+    const ScopedLock lock(waitingLock);
+    PatchSnapshot* s = published.load();
+    if (s != nullptr && retired.load() == s) {
+        // published first, so the audio thread never sees the pointer without the retired mark
+        published.store(nullptr);
+        retired.store(nullptr);
+        s->notifyListeners();
+        delete s;
+    }
+    if (published.load() == nullptr) {
+        if (waiting.size() > 0) {
+            published.store(waiting.removeAndReturn(0));
+        } else {
+            stopTimer();
+        }
+    }
+}
+
+void PatchSwap::timerCallback()
+{
+    exchange();
+}
+
+PatchSwap::eAction PatchSwap::beginBlock()
+{
+    // retired before published, see exchange()
+    const PatchSnapshot* r = retired.load();
+    PatchSnapshot* s = published.load();
+    if (s == nullptr || s == r) {
+        if (fadeDirection < 0) {
+            // nothing to wait for
+            fadeDirection = 1;
+        }
+        return eAction::eNone;
+    }
+
+    const eTransition t = transition.load();
+    if (t == eTransition::eImmediate) {
+        s->apply();
+        retired.store(s);
+        fadeDirection = gain < 1.f ? 1 : 0;
+        return eAction::eApplied;
+    }
+    if (gain > 0.f) {
+        // the switch happens in the first block after the fade out
+        fadeDirection = -1;
+        return eAction::eNone;
+    }
+    s->apply();
+    retired.store(s);
+    fadeDirection = 1;
+    return t == eTransition::eReleaseVoices ? eAction::eReleaseVoices : eAction::eAppliedSilent;
+}
+
+void PatchSwap::endBlock(AudioSampleBuffer& buffer, int numSamples)
+{
+    if (fadeDirection == 0) {
+        return;
+    }
+
+    const float delta = static_cast<float>(fadeDirection) * fadeStep;
+    for (int c = 0; c < buffer.getNumChannels(); ++c) {
+        float* samples = buffer.getWritePointer(c);
+        float g = gain;
+        for (int s = 0; s < numSamples; ++s) {
+            g = jlimit(0.f, 1.f, g + delta);
+            samples[s] *= g;
+        }
+    }
+    gain = jlimit(0.f, 1.f, gain + delta * static_cast<float>(numSamples));
+    if (fadeDirection > 0 && gain >= 1.f) {
+        fadeDirection = 0;
+    }
+}
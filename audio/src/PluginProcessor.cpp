@@ -12,17 +12,26 @@
 #include "Voice.h"
 #include "HostParam.h"
 
+namespace {
+    // parameter changes closer together are applied at the same sample
+    const int minSubBlockSize = 32;
+}
+
 // UI header, should be hidden behind a factory
 #include <PluginEditor.h>
 
 //==============================================================================
 PluginAudioProcessor::PluginAudioProcessor()
-    : delay(*this)
+    : synth(midiState)
+    , fxChain(*this)
     , stepSeq(*this)
-    , chorus(*this)
-    , clip(*this)
-    , lowFi(*this)
-    , synth(midiState)
+    , arpeggiator(*this)
+    , globalModBus(*this)
+    , programBank(*this)
+    , paramEventsActive(false)
+    , audioThreadId(nullptr)
+    , lastBlockTicks(0)
+    , maxRangeSize(minSubBlockSize)
 {
     for (size_t i = 0; i < osc.size(); ++i) {
         addParameter(new HostParam<Param>(osc[i].fine));
@@ -73,56 +82,92 @@ PluginAudioProcessor::PluginAudioProcessor()
     addParameter(new HostParam<Param>(chorDelayLength));
     addParameter(new HostParam<Param>(chorModRate));
 
+    addParameter(new HostParam<ParamStepped<eOnOffToggle>>(revActivation));
+    addParameter(new HostParam<Param>(revDryWet));
+    addParameter(new HostParam<Param>(revSize));
+    addParameter(new HostParamLog<Param>(revDecay, 2.f));
+    addParameter(new HostParam<Param>(revDamping));
+    addParameter(new HostParam<Param>(revPredelay));
+
+    addParameter(new HostParam<ParamStepped<eOnOffToggle>>(convActivation));
+    addParameter(new HostParam<Param>(convDryWet));
+
     addParameter(new HostParam<ParamStepped<eOnOffToggle>>(lowFiActivation));
     addParameter(new HostParam<Param>(nBitsLowFi));
 
     addParameter(new HostParam<ParamStepped<eOnOffToggle>>(clippingActivation));
     addParameter(new HostParam<Param>(clippingFactor));
 
+    addParameter(new HostParam<ParamStepped<eFxSlots>>(fxSlot0));
+    addParameter(new HostParam<ParamStepped<eFxSlots>>(fxSlot1));
+    addParameter(new HostParam<ParamStepped<eFxSlots>>(fxSlot2));
+    addParameter(new HostParam<ParamStepped<eFxSlots>>(fxSlot3));
+    addParameter(new HostParam<ParamStepped<eFxSlots>>(fxSlot4));
+    addParameter(new HostParam<ParamStepped<eFxSlots>>(fxSlot5));
+
+    addParameter(new HostParam<ParamStepped<eOnOffToggle>>(arpActivation));
+    addParameter(new HostParam<ParamStepped<eArpModes>>(arpMode));
+    addParameter(new HostParam<Param>(arpOctaves));
+    addParameter(new HostParam<Param>(arpSpeed));
+    addParameter(new HostParam<Param>(arpGate));
+
+    addParameter(new HostParam<ParamStepped<eOnOffToggle>>(mpeActivation));
+
+    for (size_t i = 0; i < globalLfo.size(); ++i) {
+        addParameter(new HostParam<ParamStepped<eLfoWaves>>(globalLfo[i].wave));
+        addParameter(new HostParamLog<Param>(globalLfo[i].freq, 1.f));
+    }
+    for (size_t i = 0; i < globalModSlot.size(); ++i) {
+        addParameter(new HostParam<ParamStepped<eGlobalModSource>>(globalModSlot[i].source));
+        addParameter(new HostParam<ParamStepped<eGlobalModDest>>(globalModSlot[i].destination));
+        addParameter(new HostParam<Param>(globalModSlot[i].amount));
+    }
+
     positionInfo[0].resetToDefault();
     positionInfo[1].resetToDefault();
 
+    pendingParamEvents = std::vector<std::atomic<int>>(static_cast<size_t>(getNumParameters()));
+
+    programBank.addChangeListener(this);
+
 
     /*Create ModMatrixRows here*/
     for (size_t f = 0; f < filter.size(); ++f) {
-        String boxName = String::formatted("filter %u", f + 1);
-        globalModMatrix.addModMatrixRow(&filter[f].lpCutModSrc1, static_cast<destinations>(DEST_FILTER1_LC + f), &filter[f].lpModAmount1, boxName + " lpModSrcBox1");
-        globalModMatrix.addModMatrixRow(&filter[f].lpCutModSrc2, static_cast<destinations>(DEST_FILTER1_LC + f), &filter[f].lpModAmount2, boxName + " lpModSrcBox2");
-        globalModMatrix.addModMatrixRow(&filter[f].hpCutModSrc1, static_cast<destinations>(DEST_FILTER1_HC + f), &filter[f].hpModAmount1, boxName + " hpModSrcBox1");
-        globalModMatrix.addModMatrixRow(&filter[f].hpCutModSrc2, static_cast<destinations>(DEST_FILTER1_HC + f), &filter[f].hpModAmount2, boxName + " hpModSrcBox2");
-        globalModMatrix.addModMatrixRow(&filter[f].resonanceModSrc1, static_cast<destinations>(DEST_FILTER1_RES + f), &filter[f].resModAmount1, boxName + " resModSrcBox1");
-        globalModMatrix.addModMatrixRow(&filter[f].resonanceModSrc2, static_cast<destinations>(DEST_FILTER1_RES + f), &filter[f].resModAmount2, boxName + " resModSrcBox2");
+        globalModMatrix.addModMatrixRow(&filter[f].lpCutModSrc1, static_cast<destinations>(DEST_FILTER1_LC + f), &filter[f].lpModAmount1);
+        globalModMatrix.addModMatrixRow(&filter[f].lpCutModSrc2, static_cast<destinations>(DEST_FILTER1_LC + f), &filter[f].lpModAmount2);
+        globalModMatrix.addModMatrixRow(&filter[f].hpCutModSrc1, static_cast<destinations>(DEST_FILTER1_HC + f), &filter[f].hpModAmount1);
+        globalModMatrix.addModMatrixRow(&filter[f].hpCutModSrc2, static_cast<destinations>(DEST_FILTER1_HC + f), &filter[f].hpModAmount2);
+        globalModMatrix.addModMatrixRow(&filter[f].resonanceModSrc1, static_cast<destinations>(DEST_FILTER1_RES + f), &filter[f].resModAmount1);
+        globalModMatrix.addModMatrixRow(&filter[f].resonanceModSrc2, static_cast<destinations>(DEST_FILTER1_RES + f), &filter[f].resModAmount2);
     }
     for (size_t o = 0; o < osc.size(); ++o) {
-        String boxName = String::formatted("osc %u", o + 1);
-        globalModMatrix.addModMatrixRow(&osc[o].gainModSrc1, static_cast<destinations>(DEST_OSC1_GAIN + o), &osc[o].gainModAmount1, boxName + " GainModSrc1");
-        globalModMatrix.addModMatrixRow(&osc[o].gainModSrc2, static_cast<destinations>(DEST_OSC1_GAIN + o), &osc[o].gainModAmount2, boxName + " GainModSrc2");
-        globalModMatrix.addModMatrixRow(&osc[o].panModSrc1, static_cast<destinations>(DEST_OSC1_PAN + o), &osc[o].panModAmount1, boxName + " PanModSrc1");
-        globalModMatrix.addModMatrixRow(&osc[o].panModSrc2, static_cast<destinations>(DEST_OSC1_PAN + o), &osc[o].panModAmount2, boxName + " PanModSrc2");
-        globalModMatrix.addModMatrixRow(&osc[o].pitchModSrc1, static_cast<destinations>(DEST_OSC1_PI + o), &osc[o].pitchModAmount1, boxName + " oscPitchModSrc1");
-        globalModMatrix.addModMatrixRow(&osc[o].pitchModSrc2, static_cast<destinations>(DEST_OSC1_PI + o), &osc[o].pitchModAmount2, boxName + " oscPitchModSrc2");
-        globalModMatrix.addModMatrixRow(&osc[o].shapeModSrc1, static_cast<destinations>(DEST_OSC1_PW + o), &osc[o].shapeModAmount1, boxName + " WidthModSrc1");
-        globalModMatrix.addModMatrixRow(&osc[o].shapeModSrc2, static_cast<destinations>(DEST_OSC1_PW + o), &osc[o].shapeModAmount2, boxName + " WidthModSrc2");
+        globalModMatrix.addModMatrixRow(&osc[o].gainModSrc1, static_cast<destinations>(DEST_OSC1_GAIN + o), &osc[o].gainModAmount1);
+        globalModMatrix.addModMatrixRow(&osc[o].gainModSrc2, static_cast<destinations>(DEST_OSC1_GAIN + o), &osc[o].gainModAmount2);
+        globalModMatrix.addModMatrixRow(&osc[o].panModSrc1, static_cast<destinations>(DEST_OSC1_PAN + o), &osc[o].panModAmount1);
+        globalModMatrix.addModMatrixRow(&osc[o].panModSrc2, static_cast<destinations>(DEST_OSC1_PAN + o), &osc[o].panModAmount2);
+        globalModMatrix.addModMatrixRow(&osc[o].pitchModSrc1, static_cast<destinations>(DEST_OSC1_PI + o), &osc[o].pitchModAmount1);
+        globalModMatrix.addModMatrixRow(&osc[o].pitchModSrc2, static_cast<destinations>(DEST_OSC1_PI + o), &osc[o].pitchModAmount2);
+        globalModMatrix.addModMatrixRow(&osc[o].shapeModSrc1, static_cast<destinations>(DEST_OSC1_PW + o), &osc[o].shapeModAmount1);
+        globalModMatrix.addModMatrixRow(&osc[o].shapeModSrc2, static_cast<destinations>(DEST_OSC1_PW + o), &osc[o].shapeModAmount2);
     }
 
     for (size_t e = 0; e < env.size(); ++e) {
-        String boxName = String::formatted("env %u", e + 2);
-        globalModMatrix.addModMatrixRow(&env[e].speedModSrc1, static_cast<destinations>(DEST_ENV2_SPEED + e), &env[e].speedModAmount1, boxName + " envSpeedModSrcBox1");
-        globalModMatrix.addModMatrixRow(&env[e].speedModSrc2, static_cast<destinations>(DEST_ENV2_SPEED + e), &env[e].speedModAmount2, boxName + " envSpeedModSrcBox2");
+        globalModMatrix.addModMatrixRow(&env[e].speedModSrc1, static_cast<destinations>(DEST_ENV2_SPEED + e), &env[e].speedModAmount1);
+        globalModMatrix.addModMatrixRow(&env[e].speedModSrc2, static_cast<destinations>(DEST_ENV2_SPEED + e), &env[e].speedModAmount2);
     }
-    globalModMatrix.addModMatrixRow(&envVol[0].speedModSrc1, static_cast<destinations>(DEST_VOL_ENV_SPEED), &envVol[0].speedModAmount1, "env vol envSpeedModSrcBox1");
-    globalModMatrix.addModMatrixRow(&envVol[0].speedModSrc2, static_cast<destinations>(DEST_VOL_ENV_SPEED), &envVol[0].speedModAmount2, "env vol envSpeedModSrcBox1");
+    globalModMatrix.addModMatrixRow(&envVol[0].speedModSrc1, static_cast<destinations>(DEST_VOL_ENV_SPEED), &envVol[0].speedModAmount1);
+    globalModMatrix.addModMatrixRow(&envVol[0].speedModSrc2, static_cast<destinations>(DEST_VOL_ENV_SPEED), &envVol[0].speedModAmount2);
 
     for (size_t l = 0; l < lfo.size(); ++l) {
-        String boxName = String::formatted("lfo %u", l + 1);
-        globalModMatrix.addModMatrixRow(&lfo[l].freqModSrc1, static_cast<destinations>(DEST_LFO1_FREQ + l), &lfo[l].freqModAmount1, boxName + " freqModSrc1");
-        globalModMatrix.addModMatrixRow(&lfo[l].freqModSrc2, static_cast<destinations>(DEST_LFO1_FREQ + l), &lfo[l].freqModAmount2, boxName + " freqModSrc2");
+        globalModMatrix.addModMatrixRow(&lfo[l].freqModSrc1, static_cast<destinations>(DEST_LFO1_FREQ + l), &lfo[l].freqModAmount1);
+        globalModMatrix.addModMatrixRow(&lfo[l].freqModSrc2, static_cast<destinations>(DEST_LFO1_FREQ + l), &lfo[l].freqModAmount2);
         // LFO Gain is handled in directly @ voice.renderModulation()
     }
 }
 
 PluginAudioProcessor::~PluginAudioProcessor()
 {
+    programBank.removeChangeListener(this);
 }
 
 //==============================================================================
@@ -183,29 +228,33 @@ bool PluginAudioProcessor::silenceInProducesSilenceOut() const
 
 double PluginAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // release of the voices plus whatever the activated effects add to it
+    return envVol[0].release.get() + fxChain.getTailLengthSeconds();
 }
 
 int PluginAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    // NB: some hosts don't cope very well if you tell them there are 0 programs
+    return jmax(1, programBank.getNumPrograms());
 }
 
 int PluginAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return jmax(0, programBank.getCurrentProgram());
 }
 
 void PluginAudioProcessor::setCurrentProgram (int index)
 {
-    ignoreUnused(index);
+    if (paramEventsActive.load()) {
+        programBank.requestProgram(index);
+    } else {
+        programBank.applyProgram(index);
+    }
 }
 
 const String PluginAudioProcessor::getProgramName (int index)
 {
-    ignoreUnused(index);
-    return String();
+    return programBank.getProgramName(index);
 }
 
 void PluginAudioProcessor::changeProgramName (int index, const String& newName)
@@ -213,32 +262,130 @@ void PluginAudioProcessor::changeProgramName (int index, const String& newName)
     ignoreUnused(index,newName);
 }
 
+void PluginAudioProcessor::changeListenerCallback(ChangeBroadcaster* source)
+{
+    ignoreUnused(source);
+    updateHostDisplay();
+}
+
 //==============================================================================
 void PluginAudioProcessor::prepareToPlay (double sRate, int samplesPerBlock)
 {
-    ignoreUnused(samplesPerBlock);
     synth.setCurrentPlaybackSampleRate(sRate);
     synth.clearVoices();
+    voices.clear();
 
     for (int i = 8; --i >= 0;)
     {
-        synth.addVoice(new Voice(*this, samplesPerBlock));
+        voices.push_back(new Voice(*this, samplesPerBlock));
+        synth.addVoice(voices.back());
     }
     synth.clearSounds();
     synth.addSound(new Sound());
 
-    delay.init(getNumOutputChannels(), sRate);
-    chorus.init(getNumOutputChannels(), sRate);
+    fxChain.init(getNumOutputChannels(), sRate, samplesPerBlock);
+
+    maxRangeSize = jmax(minSubBlockSize, samplesPerBlock);
+    for (ParamRamp* r : rampParams) {
+        r->init(sRate, maxRangeSize);
+    }
+    seqModLane.init(sRate, maxRangeSize);
+    globalModBus.init(sRate, maxRangeSize);
+    programBank.prepare();
+    arpeggiator.prepare();
+    panGains.setSize(2, maxRangeSize);
+
+    // the audio thread is not running yet, so the queue can be emptied here
+    flushParamEvents();
+    lastBlockTicks = Time::getHighResolutionTicks();
+    paramEventsActive.store(true);
+    patchSwap.prepare(sRate);
 }
 
 void PluginAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    paramEventsActive.store(false);
+    flushParamEvents();
+    patchSwap.release();
+}
+
+void PluginAudioProcessor::setParameter(int index, float newValue)
+{
+    // changes that are already in effect, e.g. edits in the UI, need no scheduling. Not while
+    // changes of the param are queued, getParameter() still returns the value before them
+    std::atomic<int> &pending = pendingParamEvents[static_cast<size_t>(index)];
+    if (!paramEventsActive.load() || (pending.load() == 0 && getParameter(index) == newValue)) {
+        AudioProcessor::setParameter(index, newValue);
+        return;
+    }
+
+    ParamEventQueue::Event e;
+    e.index = index;
+    e.value = newValue;
+    e.ticks = Time::getHighResolutionTicks();
+    e.immediate = Thread::getCurrentThreadId() == audioThreadId.load();
+    // counted before the audio thread can apply it
+    ++pending;
+    if (!paramEvents.push(e)) {
+        // queue full, better late than never
+        --pending;
+        AudioProcessor::setParameter(index, newValue);
+    }
+}
+
+int PluginAudioProcessor::collectParamEvents(int numSamples)
+{
+    // the changes that arrived while the last block was rendered are spread over this block
+    // in the same relative timing. Changes from the audio thread itself come right before
+    // the block and apply at its start.
+    const int64 now = Time::getHighResolutionTicks();
+    const int64 span = now - lastBlockTicks;
+
+    int numEvents = 0;
+    ParamEventQueue::Event e;
+    while (numEvents < static_cast<int>(scheduledEvents.size()) && paramEvents.pop(e)) {
+        int offset = 0;
+        if (!e.immediate && span > 0 && e.ticks > lastBlockTicks) {
+            offset = jlimit(0, numSamples - 1, static_cast<int>((e.ticks - lastBlockTicks) * numSamples / span));
+        }
+
+        // insertion sort, the events are almost in order already
+        int i = numEvents++;
+        while (i > 0 && scheduledEvents[static_cast<size_t>(i - 1)].offset > offset) {
+            scheduledEvents[static_cast<size_t>(i)] = scheduledEvents[static_cast<size_t>(i - 1)];
+            --i;
+        }
+        scheduledEvents[static_cast<size_t>(i)] = { offset, e.index, e.value };
+    }
+
+    lastBlockTicks = now;
+    return numEvents;
+}
+
+void PluginAudioProcessor::flushParamEvents()
+{
+    ParamEventQueue::Event e;
+    while (paramEvents.pop(e)) {
+        applyParamEvent(e.index, e.value);
+    }
+}
+
+void PluginAudioProcessor::applyParamEvent(int index, float value)
+{
+    AudioProcessor::setParameter(index, value);
+    --pendingParamEvents[static_cast<size_t>(index)];
 }
 
 void PluginAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages)
 {
+    // no denormals in any of the feedback paths, restored after the block
+    const ScopedFlushDenormals flushDenormals;
+    // reports allocations and locks in debug builds
+    const RealtimeGuard::Scope realtimeScope;
+
+    audioThreadId.store(Thread::getCurrentThreadId());
     updateHostInfo();
 
     // In case we have more outputs than inputs, this code clears any output
@@ -250,7 +397,22 @@ void PluginAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer&
     for (int i = getNumInputChannels(); i < getNumOutputChannels(); ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    stepSeq.runSeq(midiMessages, buffer.getNumSamples(), getSampleRate());
+    // program changes and loaded patches take effect here as a whole
+    programBank.beginBlock(midiMessages);
+    switch (patchSwap.beginBlock()) {
+    case PatchSwap::eAction::eReleaseVoices:
+        synth.allNotesOff(0, false);
+        // fall through
+    case PatchSwap::eAction::eAppliedSilent:
+        // nothing is audible, no need to glide to the new values
+        for (ParamRamp* r : rampParams) {
+            r->reset();
+        }
+        break;
+    default:
+        break;
+    }
+    globalModMatrix.compileUserSlots(modSlots);
 
     // pass these messages to the keyboard state so that it can update the component
     // to show on-screen which keys are being pressed on the physical midi keyboard.
@@ -258,54 +420,94 @@ void PluginAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer&
     // the mouse-clicking on the on-screen keyboard.
     keyboardState.processNextMidiBuffer(midiMessages, 0, buffer.getNumSamples(), true);
 
-    // and now get the synth to process the midi events and generate its output.
-    synth.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
-
-    // Low fidelity effect
-    //////////////////////
-    // If the effect is activated, the algorithm is applied
-    if (lowFiActivation.getStep() == eOnOffToggle::eOn) {
-        lowFi.bitReduction(buffer);
-    }
-
-    if (clippingActivation.getStep() == eOnOffToggle::eOn) {
-        clip.clipSignal(buffer, 0, buffer.getNumSamples());
+    // the held keys, including the on-screen ones, become the arpeggio
+    arpeggiator.run(midiMessages, buffer.getNumSamples(), getSampleRate());
+    stepSeq.runSeq(midiMessages, buffer.getNumSamples(), getSampleRate());
+    // the fx and master modulation sources are read once per block, the global lfos run per sample
+    globalModBus.beginBlock(buffer.getNumSamples());
+
+    // split the block at the parameter changes. A range is only shorter than minSubBlockSize
+    // if the block is, or if the host exceeds the announced block size
+    const int numSamples = buffer.getNumSamples();
+    const int numEvents = collectParamEvents(numSamples);
+    int startSample = 0;
+    int e = 0;
+    while (startSample < numSamples) {
+        while (e < numEvents && scheduledEvents[static_cast<size_t>(e)].offset < startSample + minSubBlockSize) {
+            const ScheduledEvent& event = scheduledEvents[static_cast<size_t>(e++)];
+            applyParamEvent(event.index, event.value);
+        }
+        int endSample = (e < numEvents) ? jmin(numSamples, scheduledEvents[static_cast<size_t>(e)].offset) : numSamples;
+        // a shorter last range is merged into this one
+        if (numSamples - endSample < minSubBlockSize) {
+            endSample = numSamples;
+        }
+        // hosts may exceed the announced block size, the ramp buffers are never resized here
+        endSample = jmin(endSample, startSample + maxRangeSize);
+        renderRange(buffer, midiMessages, startSample, endSample - startSample);
+        startSample = endSample;
     }
-    // fx
-    // delay
-    if (delayActivation.getStep() == eOnOffToggle::eOn) {
-        delay.render(buffer, 0, buffer.getNumSamples()); // adds the delay to the outputBuffer
+    // the changes of a merged last range take effect with the next block
+    while (e < numEvents) {
+        const ScheduledEvent& event = scheduledEvents[static_cast<size_t>(e++)];
+        applyParamEvent(event.index, event.value);
     }
-    // chorus
-    if (chorActivation.getStep() == eOnOffToggle::eOn) {
-        chorus.render(buffer, 0); // adds the chorus to the outputBuffer
+    patchSwap.endBlock(buffer, numSamples);
+    publishModSnapshot();
+
+    //midiMessages.clear(); // NOTE: for now so debugger does not complain
+                          // should we set the JucePlugin_ProducesMidiOutput macro to 1 ?
+}
+
+void PluginAudioProcessor::renderRange(AudioSampleBuffer& buffer, MidiBuffer& midiMessages, int startSample, int numSamples)
+{
+    // smoothed param values for this range
+    for (ParamRamp* r : rampParams) {
+        r->render(startSample, numSamples);
     }
+    globalModBus.render(startSample, numSamples);
+    // the sequencer mod source, shared by all voices
+    seqModLane.render(startSample, numSamples);
+
+    // the voices only render the mod sources and destinations of the active rows
+    globalModMatrix.compileRouting();
+
+    // and now get the synth to process the midi events and generate its output.
+    synth.renderNextBlock(buffer, midiMessages, startSample, numSamples);
+    sentinel.check(NonFiniteSentinel::eVoices, buffer, startSample, numSamples);
+
+    // fx, in the order set by the fxSlot params
+    fxChain.render(buffer, startSample, numSamples);
+    sentinel.check(NonFiniteSentinel::eFx, buffer, startSample, numSamples);
 
     // master volume
+    const float* amp = masterAmpRamp.getRamp(startSample);
     for (int c = 0; c < buffer.getNumChannels(); ++c)
     {
-        FloatVectorOperations::multiply(buffer.getWritePointer(c, 0), Param::fromDb(masterAmp.getUI()), buffer.getNumSamples());
+        FloatVectorOperations::multiply(buffer.getWritePointer(c, startSample), amp, numSamples);
     }
 
     // master pan
     if (buffer.getNumChannels() == 2)
     {
-        // Linear pan
-        float rightGain = ( (masterPan.get() / 100.f) + 1.f) / 2.f;
-        float leftGain = 1.f - rightGain;
+        // Linear pan: right = (pan / 100 + 1) / 2, left = 1 - right
+        float* rightGain = panGains.getWritePointer(1);
+        float* leftGain = panGains.getWritePointer(0);
+        FloatVectorOperations::copyWithMultiply(rightGain, masterPanRamp.getRamp(startSample), .005f, numSamples);
+        FloatVectorOperations::add(rightGain, .5f, numSamples);
+        FloatVectorOperations::fill(leftGain, 1.f, numSamples);
+        FloatVectorOperations::subtract(leftGain, rightGain, numSamples);
         // Constant power pan
         //float p = (float_Pi * ((masterPan.get() / 100.f) + 1.f)) / 4.f;
         //float rightGain = sin(p);
         //float leftGain = cos(p);
 
         // left
-        FloatVectorOperations::multiply(buffer.getWritePointer(0, 0), leftGain, buffer.getNumSamples());
+        FloatVectorOperations::multiply(buffer.getWritePointer(0, startSample), leftGain, numSamples);
         // right
-        FloatVectorOperations::multiply(buffer.getWritePointer(1, 0), rightGain, buffer.getNumSamples());
+        FloatVectorOperations::multiply(buffer.getWritePointer(1, startSample), rightGain, numSamples);
     }
-
-    //midiMessages.clear(); // NOTE: for now so debugger does not complain
-                          // should we set the JucePlugin_ProducesMidiOutput macro to 1 ?
+    sentinel.check(NonFiniteSentinel::eMaster, buffer, startSample, numSamples);
 }
 
 void PluginAudioProcessor::updateHostInfo()
@@ -321,6 +523,26 @@ void PluginAudioProcessor::updateHostInfo()
     positionInfo[getAudioIndex()].resetToDefault();
 }
 
+void PluginAudioProcessor::publishModSnapshot()
+{
+    // the voice started last, as long as it sounds
+    const Voice* newest = nullptr;
+    for (const Voice* v : voices) {
+        if (v->isVoiceActive() && (newest == nullptr || newest->wasStartedBefore(*v))) {
+            newest = v;
+        }
+    }
+
+    ModSnapshot::Values &values = modSnapshot.beginWrite();
+    if (newest) {
+        newest->fillSnapshot(values);
+    }
+    else {
+        ModSnapshot::clear(values);
+    }
+    modSnapshot.publish();
+}
+
 //==============================================================================
 bool PluginAudioProcessor::hasEditor() const
 {
@@ -335,12 +557,27 @@ AudioProcessorEditor* PluginAudioProcessor::createEditor()
 //==============================================================================
 void PluginAudioProcessor::getStateInformation (MemoryBlock& destData)
 {
-    SynthParams::writeXMLPatchHost(destData, eSerializationParams::eAll);
+    SynthParams::writeBinaryPatchHost(destData);
 }
 
 void PluginAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    SynthParams::readXMLPatchHost(data, sizeInBytes, eSerializationParams::eAll);
+    // states of older versions are XML
+    if (!SynthParams::readBinaryPatchHost(data, sizeInBytes)) {
+        SynthParams::readXMLPatchHost(data, sizeInBytes, eSerializationParams::eAll);
+    }
+}
+
+void PluginAudioProcessor::applyPatch(PatchSnapshot* snapshot)
+{
+    patchSwap.post(snapshot);
+}
+
+void PluginAudioProcessor::loadImpulseResponse(const String& path)
+{
+    SynthParams::loadImpulseResponse(path);
+    // an empty or relative path clears the impulse response, like an unreadable file
+    fxChain.loadImpulseResponse(File::isAbsolutePath(path) ? File(path) : File());
 }
 
 //==============================================================================
@@ -0,0 +1,461 @@
+/*
+  ==============================================================================
+
+    PresetLibrary.cpp
+
+  ==============================================================================
+*/
+
+#include "PresetLibrary.h"
+
+namespace {
+    const uint32 indexMagic = 0x584e5953;   // "SYNX"
+    const uint32 indexVersion = 1;
+    const int rescanIntervalMs = 2000;      // how often the folder is compared with the index
+    const int indexPriority = 2;            // below the message thread, 0 is lowest
+    const char* const indexName = "presets";
+    const char* const indexExtension = ".index";
+
+    // files are named presets.<generation>.index
+    int64 getGeneration(const File& indexFile) {
+        return indexFile.getFileNameWithoutExtension().fromLastOccurrenceOf(".", false, false).getLargeIntValue();
+    }
+
+    File getIndexDirectory() {
+        return File::getSpecialLocation(File::userApplicationDataDirectory).getChildFile("Synister");
+    }
+
+    Array<File> findIndexFiles() {
+        Array<File> files;
+        getIndexDirectory().findChildFiles(files, File::findFiles, false, String(indexName) + ".*" + indexExtension);
+        return files;
+    }
+
+    enum eEntryFlags : uint32 {
+        eValidPatch = 1
+    };
+
+    // index order, "Pad 2" before "Pad 10"
+    struct PathOrder {
+        static int compareElements(const String& a, const String& b) {
+            return a.compareNatural(b);
+        }
+    };
+
+    uint64 hashContent(const MemoryBlock& content) {
+        uint64 hash = 14695981039346656037ull;
+        const uint8* bytes = static_cast<const uint8*>(content.getData());
+        for (size_t i = 0; i < content.getSize(); ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+        return hash;
+    }
+}
+
+//! start of the index file, followed by the entries and the string table
+struct PresetLibrary::Header {
+    uint32 magic;
+    uint32 version;
+    uint32 numEntries;
+    uint32 numKeyParams;
+    uint32 entrySize;
+    uint32 entriesOffset;
+    uint32 stringsOffset;
+    uint32 stringsSize;
+};
+
+//! one patch file in the index, strings are offsets into the string table
+struct PresetLibrary::Entry {
+    uint32 pathOffset;      //!< path relative to the preset folder
+    uint32 nameOffset;
+    uint32 tagsOffset;
+    uint32 searchOffset;    //!< lower case name, tags and path
+    uint32 flags;
+    uint32 reserved;
+    int64 modificationTime; //!< milliseconds, to detect changed files
+    int64 fileSize;
+    uint64 contentHash;
+    float keyValues[nKeyParams];
+};
+
+//! serialises the index checks, shared by the instances of a process
+struct PresetLibrary::WriterLock {
+    WriterLock() : interProcess("SynisterPresetIndex") {}
+    CriticalSection inProcess;      //!< an InterProcessLock is reentrant within one process
+    InterProcessLock interProcess;
+};
+
+//! an entry while the index is built
+struct PresetLibrary::NewEntry {
+    String path;
+    String name;
+    String tags;
+    uint32 flags;
+    int64 modificationTime;
+    int64 fileSize;
+    uint64 contentHash;
+    float keyValues[nKeyParams];
+};
+
+PresetLibrary::PresetLibrary(const std::array<const Param*, nKeyParams> &keyParams_)
+    : Thread("Synister preset library")
+    , keyParams(keyParams_)
+    , data(nullptr)
+    , dataSize(0)
+    , numEntries(0)
+{
+}
+
+PresetLibrary::~PresetLibrary()
+{
+    stopThread(5000);
+}
+
+File PresetLibrary::getPresetDirectory()
+{
+    return File::getSpecialLocation(File::commonDocumentsDirectory).getChildFile("Synister");
+}
+
+File PresetLibrary::getIndexFile()
+{
+    File newest;
+    for (const File& f : findIndexFiles()) {
+        if (newest == File() || getGeneration(f) > getGeneration(newest)) {
+            newest = f;
+        }
+    }
+    return newest;
+}
+
+void PresetLibrary::startIndexing()
+{
+    if (isThreadRunning()) {
+        return;
+    }
+    keyParamIds.clearQuick();
+    for (const Param* p : keyParams) {
+        keyParamIds.add(p->getID());
+    }
+    {
+        const ScopedLock lock(indexLock);
+        mapIndex(getIndexFile());
+    }
+    sendChangeMessage();
+    startThread(indexPriority);
+}
+
+void PresetLibrary::mapIndex(const File &indexFile)
+{
+    mappedFile = indexFile;
+    mappedIndex = new MemoryMappedFile(indexFile, MemoryMappedFile::readOnly);
+    data = static_cast<const char*>(mappedIndex->getData());
+    dataSize = mappedIndex->getSize();
+    numEntries = 0;
+
+    // a broken or outdated index is rebuilt by the thread
+    const Header* h = reinterpret_cast<const Header*>(data);
+    if (data == nullptr || dataSize < sizeof(Header)
+        || h->magic != indexMagic || h->version != indexVersion
+        || h->numKeyParams != nKeyParams || h->entrySize != sizeof(Entry)
+        || h->entriesOffset % alignof(Entry) != 0
+        || static_cast<uint64>(h->entriesOffset) + static_cast<uint64>(h->numEntries) * sizeof(Entry) > h->stringsOffset
+        || static_cast<uint64>(h->stringsOffset) + h->stringsSize > dataSize
+        || h->stringsSize == 0 || data[h->stringsOffset + h->stringsSize - 1] != 0) {
+        mappedIndex = nullptr;
+        data = nullptr;
+        dataSize = 0;
+        return;
+    }
+    numEntries = static_cast<int>(h->numEntries);
+}
+
+const PresetLibrary::Entry* PresetLibrary::getEntry(int index) const
+{
+    jassert(index >= 0 && index < numEntries);
+    const Header* h = reinterpret_cast<const Header*>(data);
+    return reinterpret_cast<const Entry*>(data + h->entriesOffset) + index;
+}
+
+const char* PresetLibrary::getString(uint32 offset) const
+{
+    const Header* h = reinterpret_cast<const Header*>(data);
+    // the string table ends with a terminator, see mapIndex
+    return data + h->stringsOffset + jmin(offset, h->stringsSize - 1);
+}
+
+int PresetLibrary::getNumPresets() const
+{
+    const ScopedLock lock(indexLock);
+    return numEntries;
+}
+
+bool PresetLibrary::isValid(int index) const
+{
+    const ScopedLock lock(indexLock);
+    return index >= 0 && index < numEntries && (getEntry(index)->flags & eValidPatch) != 0;
+}
+
+String PresetLibrary::getName(int index) const
+{
+    const ScopedLock lock(indexLock);
+    return index >= 0 && index < numEntries ? String::fromUTF8(getString(getEntry(index)->nameOffset)) : String();
+}
+
+String PresetLibrary::getTags(int index) const
+{
+    const ScopedLock lock(indexLock);
+    return index >= 0 && index < numEntries ? String::fromUTF8(getString(getEntry(index)->tagsOffset)) : String();
+}
+
+File PresetLibrary::getFile(int index) const
+{
+    const ScopedLock lock(indexLock);
+    return index >= 0 && index < numEntries ? getPresetDirectory().getChildFile(String::fromUTF8(getString(getEntry(index)->pathOffset))) : File();
+}
+
+uint64 PresetLibrary::getContentHash(int index) const
+{
+    const ScopedLock lock(indexLock);
+    return index >= 0 && index < numEntries ? getEntry(index)->contentHash : 0;
+}
+
+float PresetLibrary::getKeyValue(int index, eKeyParam keyParam) const
+{
+    const ScopedLock lock(indexLock);
+    return index >= 0 && index < numEntries ? getEntry(index)->keyValues[keyParam] : std::numeric_limits<float>::quiet_NaN();
+}
+
+void PresetLibrary::search(const String &query, Array<int> &results) const
+{
+    StringArray words;
+    words.addTokens(query.toLowerCase(), " ", "\"");
+    words.removeEmptyStrings();
+
+    // plain byte comparisons on the lower case search strings, nothing is decoded
+    std::vector<const char*> rawWords;
+    for (const String& w : words) {
+        rawWords.push_back(w.toRawUTF8());
+    }
+
+    results.clearQuick();
+    const ScopedLock lock(indexLock);
+    results.ensureStorageAllocated(numEntries);
+    for (int i = 0; i < numEntries; ++i) {
+        const Entry* e = getEntry(i);
+        if ((e->flags & eValidPatch) == 0) {
+            continue;
+        }
+        const char* text = getString(e->searchOffset);
+        bool found = true;
+        for (const char* w : rawWords) {
+            if (std::strstr(text, w) == nullptr) {
+                found = false;
+                break;
+            }
+        }
+        if (found) {
+            results.add(i);
+        }
+    }
+}
+
+void PresetLibrary::run()
+{
+    while (!threadShouldExit()) {
+        if (update()) {
+            sendChangeMessage();
+        }
+        wait(rescanIntervalMs);
+    }
+}
+
+bool PresetLibrary::update()
+{
+    const ScopedLock inProcessLock(writerLock->inProcess);
+    const InterProcessLock::ScopedLockType interProcessLock(writerLock->interProcess);
+    if (!interProcessLock.isLocked()) {
+        return false;
+    }
+
+    // another instance may have written a newer index meanwhile
+    bool remapped = false;
+    const File newest = getIndexFile();
+    if (newest != mappedFile) {
+        const ScopedLock lock(indexLock);
+        mapIndex(newest);
+        remapped = true;
+    }
+
+    const File directory = getPresetDirectory();
+    StringArray paths;
+    if (directory.isDirectory()) {
+        Array<File> files;
+        directory.findChildFiles(files, File::findFiles, true, "*.xml");
+        for (const File& f : files) {
+            paths.add(f.getRelativePathFrom(directory));
+        }
+    }
+    PathOrder order;
+    paths.strings.sort(order);
+
+    // entries of the current index by path
+    HashMap<String, int> known;
+    {
+        const ScopedLock lock(indexLock);
+        for (int i = 0; i < numEntries; ++i) {
+            known.set(String::fromUTF8(getString(getEntry(i)->pathOffset)), i);
+        }
+    }
+
+    bool changed = paths.size() != known.size();
+    std::vector<NewEntry> entries;
+    entries.reserve(static_cast<size_t>(paths.size()));
+    for (int i = 0; i < paths.size(); ++i) {
+        if (threadShouldExit()) {
+            return remapped;
+        }
+        const File file = directory.getChildFile(paths[i]);
+        const int64 modificationTime = file.getLastModificationTime().toMilliseconds();
+        const int64 fileSize = file.getSize();
+
+        if (known.contains(paths[i])) {
+            const ScopedLock lock(indexLock);
+            const int index = known[paths[i]];
+            // the mapping may have changed, but only this thread rewrites the index
+            const Entry* e = getEntry(index);
+            if (e->modificationTime == modificationTime && e->fileSize == fileSize) {
+                NewEntry n;
+                n.path = paths[i];
+                n.name = String::fromUTF8(getString(e->nameOffset));
+                n.tags = String::fromUTF8(getString(e->tagsOffset));
+                n.flags = e->flags;
+                n.modificationTime = e->modificationTime;
+                n.fileSize = e->fileSize;
+                n.contentHash = e->contentHash;
+                std::copy(e->keyValues, e->keyValues + nKeyParams, n.keyValues);
+                entries.push_back(n);
+                changed = changed || index != i;
+                continue;
+            }
+        }
+        entries.push_back(readPatch(file, directory));
+        changed = true;
+    }
+
+    if (changed) {
+        writeIndex(entries);
+        deleteOldIndices();
+    }
+    return changed || remapped;
+}
+
+PresetLibrary::NewEntry PresetLibrary::readPatch(const File &file, const File &directory) const
+{
+    NewEntry n;
+    n.path = file.getRelativePathFrom(directory);
+    n.name = file.getFileNameWithoutExtension();
+    n.flags = 0;
+    n.modificationTime = file.getLastModificationTime().toMilliseconds();
+    n.fileSize = file.getSize();
+    std::fill(n.keyValues, n.keyValues + nKeyParams, std::numeric_limits<float>::quiet_NaN());
+
+    MemoryBlock content;
+    file.loadFileAsData(content);
+    n.contentHash = hashContent(content);
+
+    // subfolders are tags
+    StringArray tags;
+    for (File f = file.getParentDirectory(); f.isAChildOf(directory); f = f.getParentDirectory()) {
+        tags.insert(0, f.getFileName());
+    }
+
+    const ScopedPointer<XmlElement> patch = XmlDocument::parse(content.toString());
+    if (patch != nullptr && patch->getTagName() == "patch") {
+        n.flags |= eValidPatch;
+        if (patch->getStringAttribute("patchname").isNotEmpty()) {
+            n.name = patch->getStringAttribute("patchname");
+        }
+        tags.addTokens(patch->getStringAttribute("tags"), ",", "\"");
+        for (int k = 0; k < nKeyParams; ++k) {
+            if (const XmlElement* e = patch->getChildByName(keyParamIds[k])) {
+                n.keyValues[k] = static_cast<float>(e->getDoubleAttribute("value"));
+            }
+        }
+    }
+
+    tags.trim();
+    tags.removeEmptyStrings();
+    tags.removeDuplicates(true);
+    n.tags = tags.joinIntoString(", ");
+    return n;
+}
+
+void PresetLibrary::writeIndex(const std::vector<NewEntry> &entries)
+{
+    MemoryOutputStream strings;
+    // offset 0 is the empty string
+    strings.writeByte(0);
+    auto addString = [&strings](const String& s) {
+        const uint32 offset = static_cast<uint32>(strings.getPosition());
+        strings.write(s.toRawUTF8(), s.getNumBytesAsUTF8() + 1);
+        return offset;
+    };
+
+    std::vector<Entry> records(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const NewEntry& n = entries[i];
+        Entry& e = records[i];
+        e.pathOffset = addString(n.path);
+        e.nameOffset = addString(n.name);
+        e.tagsOffset = addString(n.tags);
+        e.searchOffset = addString((n.name + " " + n.tags + " " + n.path).toLowerCase());
+        e.flags = n.flags;
+        e.reserved = 0;
+        e.modificationTime = n.modificationTime;
+        e.fileSize = n.fileSize;
+        e.contentHash = n.contentHash;
+        std::copy(n.keyValues, n.keyValues + nKeyParams, e.keyValues);
+    }
+
+    Header h;
+    h.magic = indexMagic;
+    h.version = indexVersion;
+    h.numEntries = static_cast<uint32>(records.size());
+    h.numKeyParams = nKeyParams;
+    h.entrySize = sizeof(Entry);
+    h.entriesOffset = static_cast<uint32>(sizeof(Header) + (alignof(Entry) - sizeof(Header) % alignof(Entry)) % alignof(Entry));
+    h.stringsOffset = h.entriesOffset + static_cast<uint32>(records.size() * sizeof(Entry));
+    h.stringsSize = static_cast<uint32>(strings.getDataSize());
+
+    MemoryBlock index(h.stringsOffset + h.stringsSize, true);
+    index.copyFrom(&h, 0, sizeof(Header));
+    if (!records.empty()) {
+        index.copyFrom(records.data(), h.entriesOffset, records.size() * sizeof(Entry));
+    }
+    index.copyFrom(strings.getData(), h.stringsOffset, strings.getDataSize());
+
+    // a new file, the current one may be mapped by other processes
+    getIndexDirectory().createDirectory();
+    const int64 generation = getGeneration(getIndexFile()) + 1;
+    const File indexFile = getIndexDirectory().getChildFile(String(indexName) + "." + String(generation) + indexExtension);
+
+    // written completely before it gets its name, so that no reader maps half a file
+    TemporaryFile temp(indexFile, getIndexDirectory().getNonexistentChildFile(indexName, ".tmp", false));
+    if (!temp.getFile().replaceWithData(index.getData(), index.getSize()) || !temp.overwriteTargetFileWithTemporary()) {
+        return;
+    }
+
+    const ScopedLock lock(indexLock);
+    mapIndex(indexFile);
+}
+
+void PresetLibrary::deleteOldIndices() const
+{
+    // the previous index stays, another instance may be about to map it
+    const int64 generation = getGeneration(mappedFile);
+    for (const File& f : findIndexFiles()) {
+        if (getGeneration(f) < generation - 1) {
+            f.deleteFile();
+        }
+    }
+}
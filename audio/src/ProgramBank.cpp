@@ -0,0 +1,206 @@
+/*
+  ==============================================================================
+
+    ProgramBank.cpp
+
+  ==============================================================================
+*/
+
+#include "ProgramBank.h"
+
+namespace {
+    const int pollIntervalMs = 30;  // how often the message thread looks for applied programs
+    const int scanPriority = 2;     // below the message thread, 0 is lowest
+
+    // program order, "Pad 2" before "Pad 10"
+    struct FileNameOrder {
+        static int compareElements(const File& a, const File& b) {
+            return a.getFileName().compareNatural(b.getFileName());
+        }
+    };
+}
+
+ProgramBank::ProgramBank(SynthParams &p)
+    : params(p)
+    , started(false)
+    , currentProgram(-1)
+    , requestedProgram(-1)
+    , undecodedProgram(-1)
+    , appliedProgram(-1)
+{
+    for (std::atomic<PatchSnapshot*> &s : snapshots) {
+        s.store(nullptr);
+    }
+    presets->addChangeListener(this);
+}
+
+ProgramBank::~ProgramBank()
+{
+    stopTimer();
+    presets->removeChangeListener(this);
+    for (std::atomic<PatchSnapshot*> &s : snapshots) {
+        delete s.exchange(nullptr);
+    }
+}
+
+int ProgramBank::getNumPrograms()
+{
+    start();
+    return presets->getNumPrograms();
+}
+
+String ProgramBank::getProgramName(int index)
+{
+    if (index < 0 || index >= getNumPrograms()) {
+        return String();
+    }
+    return presets->getProgram(index).name;
+}
+
+void ProgramBank::applyProgram(int index)
+{
+    if (index < 0 || index >= getNumPrograms()) {
+        return;
+    }
+    getSnapshot(index).apply();
+    currentProgram.store(index);
+    completeProgramChange(index);
+}
+
+void ProgramBank::prepare()
+{
+    start();
+}
+
+void ProgramBank::beginBlock(const MidiBuffer &midiMessages)
+{
+    int index = requestedProgram.exchange(-1);
+
+    // raw data, a MidiMessage could allocate for long sysex messages
+    MidiBuffer::Iterator it(midiMessages);
+    const uint8* data;
+    int numBytes;
+    int position;
+    while (it.getNextEvent(data, numBytes, position)) {
+        if (numBytes == 2 && (data[0] & 0xf0) == 0xc0) {
+            index = data[1];
+        }
+    }
+
+    if (index < 0 || index >= presets->getNumPrograms()) {
+        return;
+    }
+    const PatchSnapshot* snapshot = snapshots[static_cast<size_t>(index)].load();
+    if (snapshot == nullptr) {
+        // decoding allocates, the message thread decodes it and requests it again
+        undecodedProgram.store(index);
+        return;
+    }
+    snapshot->apply();
+    currentProgram.store(index);
+    appliedProgram.store(index);
+}
+
+void ProgramBank::start()
+{
+    if (!started.exchange(true)) {
+        presets->scan();
+        startTimer(pollIntervalMs);
+    }
+}
+
+const PatchSnapshot& ProgramBank::getSnapshot(int index)
+{
+    std::atomic<PatchSnapshot*> &slot = snapshots[static_cast<size_t>(index)];
+    if (slot.load() == nullptr) {
+        slot.store(params.decodeXMLPatch(*presets->getProgram(index).patch, eSerializationParams::eAll));
+    }
+    return *slot.load();
+}
+
+void ProgramBank::completeProgramChange(int index)
+{
+    const Program &program = presets->getProgram(index);
+    params.patchName = program.name;
+    params.patchNameDirty = true;
+    // reloading the same impulse response would only cost time
+    if (program.convIr != params.convIrPath) {
+        params.loadImpulseResponse(program.convIr);
+    }
+    getSnapshot(index).notifyListeners();
+    sendChangeMessage();
+}
+
+void ProgramBank::timerCallback()
+{
+    const int undecoded = undecodedProgram.exchange(-1);
+    if (undecoded >= 0) {
+        getSnapshot(undecoded);
+        // unless the host or MIDI asked for another program meanwhile
+        int none = -1;
+        requestedProgram.compare_exchange_strong(none, undecoded);
+    }
+
+    const int index = appliedProgram.exchange(-1);
+    if (index >= 0) {
+        completeProgramChange(index);
+    }
+}
+
+void ProgramBank::changeListenerCallback(ChangeBroadcaster* source)
+{
+    ignoreUnused(source);
+    // hosts query the program names again
+    sendChangeMessage();
+}
+
+//==============================================================================
+ProgramBank::Presets::Presets()
+    : Thread("Synister program bank")
+    , numPrograms(0)
+    , scanStarted(false)
+{
+}
+
+ProgramBank::Presets::~Presets()
+{
+    stopThread(5000);
+}
+
+void ProgramBank::Presets::scan()
+{
+    if (!scanStarted.exchange(true)) {
+        startThread(scanPriority);
+    }
+}
+
+void ProgramBank::Presets::run()
+{
+    Array<File> files;
+    PresetLibrary::getPresetDirectory().findChildFiles(files, File::findFiles, false, "*.xml");
+    FileNameOrder order;
+    files.sort(order);
+
+    for (int i = 0; i < files.size() && numPrograms.load() < maxPrograms; ++i) {
+        if (threadShouldExit()) {
+            return;
+        }
+        ScopedPointer<XmlElement> patch = XmlDocument::parse(files[i]);
+        if (patch == nullptr || patch->getTagName() != "patch") {
+            continue;
+        }
+
+        Program* program = new Program();
+        program->name = patch->getStringAttribute("patchname");
+        if (program->name.isEmpty()) {
+            program->name = files[i].getFileNameWithoutExtension();
+        }
+        program->convIr = patch->getStringAttribute("convIr");
+        program->patch = patch.release();
+
+        const int index = numPrograms.load();
+        programs[static_cast<size_t>(index)] = program;
+        numPrograms.store(index + 1);
+    }
+    sendChangeMessage();
+}
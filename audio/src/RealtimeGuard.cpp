@@ -0,0 +1,240 @@
+/*
+  ==============================================================================
+
+    RealtimeGuard.cpp
+
+  ==============================================================================
+*/
+
+#include "RealtimeGuard.h"
+
+#if SYNISTER_REALTIME_CHECKS
+
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// the allocator is only replaced in the executable, never inside a host
+#define SYNISTER_REALTIME_HOOKS JUCE_STANDALONE_APPLICATION
+// malloc and pthread_mutex_lock can only be interposed reliably from the executable
+#define SYNISTER_REALTIME_HOOK_LIBC (JUCE_LINUX && SYNISTER_REALTIME_HOOKS)
+
+#if JUCE_LINUX
+ #include <execinfo.h>
+ #include <unistd.h>
+#endif
+#if SYNISTER_REALTIME_HOOK_LIBC
+ #include <dlfcn.h>
+ #include <pthread.h>
+#endif
+
+namespace {
+    const int maxFrames = 32;           //!< stack depth of a report
+    const size_t maxSites = 256;        //!< reported call sites that are remembered
+
+    const char* violationNames[] = { "allocation", "deallocation", "lock" };
+
+    // plain types only, the hooks may run before any constructor
+    thread_local int scopeDepth = 0;    //!< nesting of Scopes on this thread
+    thread_local int allowDepth = 0;    //!< nesting of ScopedAllows on this thread
+    thread_local bool reporting = false;//!< a report of this thread is running
+
+    std::atomic<int> numViolations(0);
+    std::array<std::atomic<uint64>, maxSites> reportedSites;
+
+    const bool abortOnViolation = std::getenv("SYNISTER_RT_ABORT") != nullptr;
+
+    //! remembers the call site, returns false if it was reported before
+    bool isNewSite(uint64 hash)
+    {
+        hash |= 1; // 0 marks a free slot
+        for (size_t i = 0; i < maxSites; ++i) {
+            std::atomic<uint64>& slot = reportedSites[(hash + i) % maxSites];
+            uint64 expected = 0;
+            if (slot.compare_exchange_strong(expected, hash) || expected == hash) {
+                return expected == 0;
+            }
+        }
+        // table full, keep reporting
+        return true;
+    }
+}
+
+int RealtimeGuard::getNumViolations()
+{
+    return numViolations.load();
+}
+
+void RealtimeGuard::enter()
+{
+    ++scopeDepth;
+}
+
+void RealtimeGuard::leave()
+{
+    jassert(scopeDepth > 0);
+    --scopeDepth;
+}
+
+void RealtimeGuard::allow(bool allowed)
+{
+    allowDepth += allowed ? 1 : -1;
+    jassert(allowDepth >= 0);
+}
+
+bool RealtimeGuard::isActive()
+{
+    return scopeDepth > 0 && allowDepth == 0 && !reporting;
+}
+
+void RealtimeGuard::report(eViolation type)
+{
+    // everything below may allocate or lock itself
+    reporting = true;
+    numViolations.fetch_add(1);
+
+#if JUCE_LINUX
+    void* frames[maxFrames];
+    const int numFrames = backtrace(frames, maxFrames);
+    uint64 hash = static_cast<uint64>(type);
+    for (int i = 1; i < numFrames; ++i) {
+        hash = hash * 31 + reinterpret_cast<uint64>(frames[i]);
+    }
+    if (isNewSite(hash)) {
+        std::fprintf(stderr, "RealtimeGuard: %s on the audio thread\n", violationNames[type]);
+        // first frame is report() itself
+        backtrace_symbols_fd(frames + 1, numFrames - 1, STDERR_FILENO);
+    }
+#else
+    const String stack = SystemStats::getStackBacktrace();
+    if (isNewSite(static_cast<uint64>(stack.hashCode64()) * 31 + static_cast<uint64>(type))) {
+        std::fprintf(stderr, "RealtimeGuard: %s on the audio thread\n%s\n", violationNames[type], stack.toRawUTF8());
+    }
+#endif
+
+    if (abortOnViolation) {
+        std::abort();
+    }
+    reporting = false;
+}
+
+//==============================================================================
+#if SYNISTER_REALTIME_HOOK_LIBC
+
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t num, size_t size);
+    void* __libc_realloc(void* ptr, size_t size);
+    void __libc_free(void* ptr);
+
+    void* malloc(size_t size)
+    {
+        RealtimeGuard::check(RealtimeGuard::eAllocation);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t num, size_t size)
+    {
+        RealtimeGuard::check(RealtimeGuard::eAllocation);
+        return __libc_calloc(num, size);
+    }
+
+    void* realloc(void* ptr, size_t size)
+    {
+        RealtimeGuard::check(RealtimeGuard::eAllocation);
+        return __libc_realloc(ptr, size);
+    }
+
+    void free(void* ptr)
+    {
+        if (ptr != nullptr) {
+            RealtimeGuard::check(RealtimeGuard::eDeallocation);
+        }
+        __libc_free(ptr);
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        typedef int (*LockFunction)(pthread_mutex_t*);
+        // no function static, its guard could lock
+        static LockFunction realLock = nullptr;
+        if (realLock == nullptr) {
+            realLock = reinterpret_cast<LockFunction>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        }
+        RealtimeGuard::check(RealtimeGuard::eLock);
+        return realLock(mutex);
+    }
+}
+
+#elif SYNISTER_REALTIME_HOOKS
+
+// operator new and delete end up in malloc and free when those are interposed
+void* operator new(size_t size)
+{
+    RealtimeGuard::check(RealtimeGuard::eAllocation);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    RealtimeGuard::check(RealtimeGuard::eAllocation);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& nt) noexcept
+{
+    return operator new(size, nt);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr != nullptr) {
+        RealtimeGuard::check(RealtimeGuard::eDeallocation);
+    }
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+#endif  // SYNISTER_REALTIME_HOOK_LIBC
+
+#else
+
+int RealtimeGuard::getNumViolations()
+{
+    return 0;
+}
+
+#endif  // SYNISTER_REALTIME_CHECKS
@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    SeqModLane.cpp
+
+  ==============================================================================
+*/
+
+#include "SeqModLane.h"
+
+namespace {
+    //! time constant of the smoothing, short enough to keep the steps sharp
+    const double smoothingSeconds = .002;
+    //! closer than this the smoothed value snaps to the target
+    const float snapDistance = 1e-5f;
+}
+
+SeqModLane::SeqModLane()
+    : capacity(0)
+    , rangeStart(0)
+    , current(0.f)
+    , target(0.f)
+    , coeff(1.f)
+    , numSteps(0)
+    , nextStep(0)
+{
+}
+
+void SeqModLane::init(double sampleRate, int maxNumSamples)
+{
+    capacity = jmax(1, maxNumSamples);
+    // one more for the value after the range, the voices advance their source pointers past the end
+    values.allocate(static_cast<size_t>(capacity + 1), true);
+    rangeStart = 0;
+    current = target = 0.f;
+    coeff = static_cast<float>(1.0 - std::exp(-1.0 / (smoothingSeconds * sampleRate)));
+    numSteps = nextStep = 0;
+}
+
+void SeqModLane::beginBlock()
+{
+    numSteps = nextStep = 0;
+}
+
+void SeqModLane::addStep(int sample, float value)
+{
+    // too many steps in one block, only the last one lasts longer than a few samples anyway
+    if (numSteps == maxStepsPerBlock) {
+        --numSteps;
+    }
+    steps[numSteps++] = { sample, jlimit(-1.f, 1.f, value) };
+}
+
+void SeqModLane::render(int startSample, int numSamples)
+{
+    jassert(numSamples <= capacity);
+    numSamples = jmin(numSamples, capacity);
+    rangeStart = startSample;
+
+    int s = 0;
+    while (s < numSamples) {
+        // the target changes at the next step edge
+        int end = numSamples;
+        if (nextStep < numSteps) {
+            end = jlimit(s, numSamples, steps[nextStep].sample - startSample);
+            if (end == s) {
+                target = steps[nextStep++].value;
+                continue;
+            }
+        }
+
+        for (; s < end && current != target; ++s) {
+            current += (target - current) * coeff;
+            if (std::abs(target - current) < snapDistance) {
+                current = target;
+            }
+            values[s] = current;
+        }
+        if (s < end) {
+            FloatVectorOperations::fill(values + s, current, end - s);
+            s = end;
+        }
+    }
+    values[numSamples] = current;
+}
@@ -0,0 +1,210 @@
+/*
+  ==============================================================================
+
+    SeqPattern.cpp
+
+  ==============================================================================
+*/
+
+#include "SeqPattern.h"
+
+namespace {
+    const int laneMin[SeqPattern::nLanes] = { 0, 1, 1, 0, -100 };
+    const int laneMax[SeqPattern::nLanes] = { 127, 127, 100, 100, 100 };
+    const int defaultNotes[8] = { 60, 62, 64, 65, 67, 69, 71, 72 };
+
+    // velocity 64 is the 0.5 the sequencer always played with
+    const int defaultVelocity = 64;
+
+    const int activeBit = 8 * SeqPattern::nLanes;
+
+    const uint8 streamFormat = 1;
+    const int streamBytesPerStep = SeqPattern::nLanes;
+}
+
+SeqPattern::SeqPattern()
+{
+    for (int i = 0; i < maxSteps; ++i) {
+        steps[i].store(pack(getDefaultStep(i)));
+    }
+}
+
+SeqPattern::Step SeqPattern::getStep(int step) const
+{
+    return unpack(steps[clampStep(step)].load());
+}
+
+void SeqPattern::setStep(int step, const Step &s)
+{
+    steps[clampStep(step)].store(pack(s));
+}
+
+int SeqPattern::getValue(int step, eLane lane) const
+{
+    return getStep(step).lanes[lane];
+}
+
+void SeqPattern::setValue(int step, eLane lane, int value)
+{
+    std::atomic<uint64> &packed = steps[clampStep(step)];
+    uint64 expected = packed.load();
+    for (;;) {
+        Step s = unpack(expected);
+        const int clamped = jlimit(getMinValue(lane), getMaxValue(lane), value);
+        if (s.lanes[lane] == clamped) {
+            return;
+        }
+        s.lanes[lane] = clamped;
+        // another thread may have changed a different lane meanwhile
+        if (packed.compare_exchange_weak(expected, pack(s))) {
+            return;
+        }
+    }
+}
+
+bool SeqPattern::isActive(int step) const
+{
+    return getStep(step).active;
+}
+
+void SeqPattern::setActive(int step, bool active)
+{
+    const uint64 bit = static_cast<uint64>(1) << activeBit;
+    if (active) {
+        steps[clampStep(step)].fetch_or(bit);
+    } else {
+        steps[clampStep(step)].fetch_and(~bit);
+    }
+}
+
+int SeqPattern::getMinValue(eLane lane)
+{
+    return laneMin[lane];
+}
+
+int SeqPattern::getMaxValue(eLane lane)
+{
+    return laneMax[lane];
+}
+
+SeqPattern::Step SeqPattern::getDefaultStep(int step)
+{
+    Step s;
+    s.lanes[eNote] = defaultNotes[clampStep(step) % 8];
+    s.lanes[eVelocity] = defaultVelocity;
+    s.lanes[eGate] = 100;
+    s.lanes[eProbability] = 100;
+    s.lanes[eMod] = 0;
+    s.active = true;
+    return s;
+}
+
+void SeqPattern::getData(Data &data) const
+{
+    for (int i = 0; i < maxSteps; ++i) {
+        data[i] = steps[i].load();
+    }
+}
+
+void SeqPattern::setData(const Data &data)
+{
+    for (int i = 0; i < maxSteps; ++i) {
+        steps[i].store(data[i]);
+    }
+}
+
+void SeqPattern::getDefaultData(Data &data)
+{
+    for (int i = 0; i < maxSteps; ++i) {
+        data[i] = pack(getDefaultStep(i));
+    }
+}
+
+void SeqPattern::writeToStream(OutputStream &out) const
+{
+    Data data;
+    getData(data);
+
+    int numStored = maxSteps;
+    while (numStored > 0 && data[numStored - 1] == pack(getDefaultStep(numStored - 1))) {
+        --numStored;
+    }
+
+    out.writeByte(static_cast<char>(streamFormat));
+    out.writeByte(static_cast<char>(numStored));
+    for (int i = 0; i < numStored; ++i) {
+        const Step s = unpack(data[i]);
+        // the note needs only 7 bits, the active flag takes the eighth
+        out.writeByte(static_cast<char>(s.lanes[eNote] | (s.active ? 0x80 : 0)));
+        for (int lane = eVelocity; lane < nLanes; ++lane) {
+            out.writeByte(static_cast<char>(s.lanes[lane] - laneMin[lane]));
+        }
+    }
+}
+
+bool SeqPattern::readFromStream(InputStream &in, Data &data)
+{
+    getDefaultData(data);
+
+    if (static_cast<uint8>(in.readByte()) != streamFormat) {
+        return false;
+    }
+    const int numStored = static_cast<uint8>(in.readByte());
+    if (numStored > maxSteps || in.getNumBytesRemaining() < numStored * streamBytesPerStep) {
+        return false;
+    }
+    for (int i = 0; i < numStored; ++i) {
+        Step s;
+        const uint8 noteAndActive = static_cast<uint8>(in.readByte());
+        s.lanes[eNote] = noteAndActive & 0x7f;
+        s.active = (noteAndActive & 0x80) != 0;
+        for (int lane = eVelocity; lane < nLanes; ++lane) {
+            const int value = static_cast<uint8>(in.readByte()) + laneMin[lane];
+            s.lanes[lane] = jlimit(laneMin[lane], laneMax[lane], value);
+        }
+        data[i] = pack(s);
+    }
+    return true;
+}
+
+String SeqPattern::toBase64() const
+{
+    MemoryOutputStream out;
+    writeToStream(out);
+    return out.getMemoryBlock().toBase64Encoding();
+}
+
+bool SeqPattern::fromBase64(const String &text, Data &data)
+{
+    MemoryBlock block;
+    if (!block.fromBase64Encoding(text)) {
+        getDefaultData(data);
+        return false;
+    }
+    MemoryInputStream in(block, false);
+    return readFromStream(in, data);
+}
+
+uint64 SeqPattern::pack(const Step &s)
+{
+    // one byte per lane, offset to be positive
+    uint64 packed = 0;
+    for (int lane = 0; lane < nLanes; ++lane) {
+        const int value = jlimit(laneMin[lane], laneMax[lane], s.lanes[lane]) - laneMin[lane];
+        packed |= static_cast<uint64>(value) << (8 * lane);
+    }
+    if (s.active) {
+        packed |= static_cast<uint64>(1) << activeBit;
+    }
+    return packed;
+}
+
+SeqPattern::Step SeqPattern::unpack(uint64 packed)
+{
+    Step s;
+    for (int lane = 0; lane < nLanes; ++lane) {
+        s.lanes[lane] = static_cast<int>((packed >> (8 * lane)) & 0xff) + laneMin[lane];
+    }
+    s.active = ((packed >> activeBit) & 1) != 0;
+    return s;
+}
@@ -11,6 +11,13 @@
 #include "StepSequencer.h"
 #include "SynthParams.h"
 
+namespace {
+    //! fraction of a step a position may lie before a step and still count as on it
+    const double stepEpsilon = 1e-6;
+    //! deviations of the host position from the expected one up to this are drift, not a jump
+    const double maxDriftSamples = 16.0;
+}
+
 //==============================================================================
 // PUBLIC
 //==============================================================================
@@ -18,16 +25,16 @@
 StepSequencer::StepSequencer(SynthParams &p)
     : params(p)
     , currSeqNote(0)
-    , lastPlayedNote(0)
-    , seqNoteAdd(1)
-    , seqNextStep(0.0)
-    , stopNoteTime(0.0)
-    , lastPlayHeadPosition(0.0)
-    , nextPlaySample(0)
-    , noteOffSample(0)
+    , lastPlayedNote(-1)
+    , nextStepCount(0)
+    , noteOffPpq(0.0)
+    , expectedPpq(0.0)
+    , lastStepSpeed(0.0f)
     , seqNoteIsPlaying(false)
     , seqStopped(true)
 {
+    random.setSeedRandomly();
+
     // save some params in arrays for easier access
     currMidiStepSeq = { &params.seqStep0,
                         &params.seqStep1,
@@ -46,12 +53,6 @@ StepSequencer::StepSequencer(SynthParams &p)
                       &params.seqStepActive5,
                       &params.seqStepActive6,
                       &params.seqStepActive7 };
-    for (int i = 0; i < 8; ++i)
-    {
-        prevMidiStepSeq[i] = static_cast<int>(currMidiStepSeq[i]->get());
-        prevStepOnOff[i] = currStepOnOff[i]->getStep();
-    }
-
     // get GUI params
     seqStepSpeed = 4.0f / params.seqStepSpeed.get(); // internally working with 1/4 = 1.0f
     seqStepLength = jmin(4.0f / params.seqStepLength.get(), seqStepSpeed);
@@ -64,6 +65,9 @@ StepSequencer::~StepSequencer()
 //==============================================================================
 void StepSequencer::runSeq(MidiBuffer & midiMessages, int bufferSize, double sampleRate)
 {
+    params.updateSeqPattern();
+    params.seqModLane.beginBlock();
+
     // get GUI params
     seqStepSpeed = 4.0f / params.seqStepSpeed.get(); // internally working with 1/4 = 1.0f
     seqStepLength = jmin(4.0f / params.seqStepLength.get(), seqStepSpeed);
@@ -82,7 +86,7 @@ void StepSequencer::runSeq(MidiBuffer & midiMessages, int bufferSize, double sam
 
     if (params.seqPlaySyncHost.getStep() == eOnOffToggle::eOn)
     {
-        seqHostSync(midiMessages);
+        seqHostSync(midiMessages, bufferSize, sampleRate);
     }
     else if (params.seqPlayNoHost.getStep() == eOnOffToggle::eOn)
     {
@@ -136,7 +140,7 @@ void StepSequencer::playRandom(bool play)
 //==============================================================================
 void StepSequencer::generateRandomSeq()
 {
-    for (int i = 0; i < 8; ++i)
+    for (int i = 0; i < SeqPattern::maxSteps; ++i)
     {
         setStepRandom(i);
     }
@@ -147,28 +151,46 @@ void StepSequencer::setStepRandom(int step)
     float min = params.seqRandomMin.get();
     float max = params.seqRandomMax.get();
 
-    Random r = Random();
-    r.setSeedRandomly();
-    currMidiStepSeq[step]->set(r.nextFloat() * (max - min) + min, true);
+    setStepNote(step, static_cast<int>(random.nextFloat() * (max - min) + min));
 }
 
-void StepSequencer::setStepActive(int step, bool active)
+void StepSequencer::setStepNote(int step, int note)
+{
+    step = jlimit(0, SeqPattern::maxSteps - 1, step);
+    if (step < 8)
+    {
+        currMidiStepSeq[step]->set(static_cast<float>(jlimit(0, 127, note)), true);
+    }
+    params.seqPattern.setValue(step, SeqPattern::eNote, note);
+}
+
+void StepSequencer::setStepValue(int step, SeqPattern::eLane lane, int value)
 {
-    if (active)
+    if (lane == SeqPattern::eNote)
     {
-        currStepOnOff[jmax(0, jmin(step, 7))]->setStep(eOnOffToggle::eOn);
+        setStepNote(step, value);
     }
     else
     {
-        currStepOnOff[jmax(0, jmin(step, 7))]->setStep(eOnOffToggle::eOff);
+        params.seqPattern.setValue(step, lane, value);
     }
 }
 
+void StepSequencer::setStepActive(int step, bool active)
+{
+    step = jlimit(0, SeqPattern::maxSteps - 1, step);
+    if (step < 8)
+    {
+        currStepOnOff[step]->setStep(active ? eOnOffToggle::eOn : eOnOffToggle::eOff);
+    }
+    params.seqPattern.setActive(step, active);
+}
+
 void StepSequencer::setNumSteps(int numSteps)
 {
     //if (!isPlayRandom())
     //{
-        params.seqNumSteps.set(static_cast<float>(jmax(1, jmin(numSteps, 8))));
+        params.seqNumSteps.set(static_cast<float>(jlimit(1, SeqPattern::maxSteps, numSteps)));
     //}
 }
 
@@ -228,7 +250,18 @@ int StepSequencer::getNumStep()
 
 int StepSequencer::getStepNoteAsInt(int step)
 {
-    return static_cast<int>(currMidiStepSeq[jmax(0, jmin(step, 7))]->get());
+    return getStepValue(step, SeqPattern::eNote);
+}
+
+int StepSequencer::getStepValue(int step, SeqPattern::eLane lane)
+{
+    step = jlimit(0, SeqPattern::maxSteps - 1, step);
+    // the params of the first steps are only copied into the pattern while playing
+    if (step < 8 && lane == SeqPattern::eNote)
+    {
+        return static_cast<int>(currMidiStepSeq[step]->get());
+    }
+    return params.seqPattern.getValue(step, lane);
 }
 
 int StepSequencer::getRandMin()
@@ -304,240 +337,208 @@ bool StepSequencer::isTripletActive()
 
 bool StepSequencer::isStepActive(int step)
 {
-    return currStepOnOff[jmax(0, jmin(step, 7))]->getStep() == eOnOffToggle::eOn;
+    step = jlimit(0, SeqPattern::maxSteps - 1, step);
+    if (step < 8)
+    {
+        return currStepOnOff[step]->getStep() == eOnOffToggle::eOn;
+    }
+    return params.seqPattern.isActive(step);
 }
 //==============================================================================
 // PRIVATE
 //==============================================================================
 /**
-* Called if stepSequencer plays without host.
+* Called if stepSequencer plays without host. Runs on its own position, advanced by the block length
+  at the current tempo, starting at the first step. When switching over from host sync it continues
+  from the host position.
 */
 void StepSequencer::seqNoHostSync(MidiBuffer& midiMessages, int bufferSize, double sampleRate)
 {
-    // if is playing a note then prepare sending midi noteOff message
-    if (seqNoteIsPlaying)
+    const double bpm = params.positionInfo[params.getAudioIndex()].bpm;
+    if (bpm <= 0.0 || sampleRate <= 0.0)
     {
-        // if midi noteOff message fits into current buffer
-        if (noteOffSample < bufferSize - 1)
-        {
-            sendMidiNoteOffMessage(midiMessages, noteOffSample);
-
-            // calculate currSeqNote to play after previous has been stopped
-            if (params.seqPlayMode.getStep() == eSeqPlayModes::eUpDown)
-            {
-                // if last note then play twice and then play reverse order
-                if (currSeqNote%seqNumSteps == seqNumSteps - 1)
-                {
-                    if ((seqNoteAdd == 0) || (seqNoteAdd == 1))
-                    {
-                        seqNoteAdd--;
-                    }
-                }
-                // if first note then play twice
-                else if (currSeqNote%seqNumSteps == 0)
-                {
-                    if ((seqNoteAdd == 0) || (seqNoteAdd == -1))
-                    {
-                        seqNoteAdd++;
-                    }
-                }
-                else
-                {
-                    // if not first or last note then seqNoteAdd must not be 0
-                    if (seqNoteAdd == 0)
-                    {
-                        seqNoteAdd = 1;
-                    }
-                }
-            }
-            else
-            {
-                seqNoteAdd = 1;
-            }
-
-            currSeqNote += seqNoteAdd;
-            if (currSeqNote < 0)
-            {
-                currSeqNote = seqNumSteps - 1;
-            }
-            currSeqNote = currSeqNote%seqNumSteps;
-        }
-        else
-        {
-            nextPlaySample -= bufferSize - 1;
-            noteOffSample -= bufferSize - 1;
-        }
+        return;
     }
+    const double samplesPerPpq = sampleRate * 60.0 / bpm;
 
-    // if is not playing a note then prepare sending midi noteOn message
-    if (!seqNoteIsPlaying)
+    if (seqStopped)
     {
-        // if midi noteOn message fits into current buffer
-        if (nextPlaySample < bufferSize - 1)
-        {
-            // set upcoming note to play as random
-            if (params.seqPlayMode.getStep() == eSeqPlayModes:: eRandom)
-            {
-                setStepRandom(currSeqNote);
-            }
-
-            // if any note changed or is muted then send noteOff message to that note
-            midiNoteChanged(midiMessages);
-
-            // send midimessage into midibuffer
-            sendMidiNoteOnMessage(midiMessages, nextPlaySample);
-
-            // calculate noteOffSample and nextPlaySample
-            double quarterSec = 60.0 / params.positionInfo[params.getAudioIndex()].bpm;
-            int diff = bufferSize - 1 - nextPlaySample;
-            noteOffSample = static_cast<int>(quarterSec * seqStepLength * sampleRate) - diff;
-            nextPlaySample = static_cast<int>(quarterSec * seqStepSpeed * sampleRate) - diff;
-        }
-        else
-        {
-            nextPlaySample -= bufferSize - 1;
-            noteOffSample -= bufferSize - 1;
-        }
+        expectedPpq = 0.0;
+        relocate(midiMessages, expectedPpq, -1);
+        seqStopped = false;
     }
-    seqStopped = false;
+    else if (seqStepSpeed != lastStepSpeed)
+    {
+        relocate(midiMessages, expectedPpq, -1);
+    }
+
+    const double ppqStart = expectedPpq;
+    playSegment(midiMessages, ppqStart, 0, bufferSize, samplesPerPpq);
+    expectedPpq = ppqStart + bufferSize / samplesPerPpq;
 }
 
 /**
-* Called while stepSequencer is synced with host.
+* Called while stepSequencer is synced with host. The steps lie on multiples of the step speed
+  counted from the start of the song, every step edge in the block is placed on its sample.
+  A position that does not continue the last block is a jump (rewind, loop, locate), a loop end
+  inside the block splits it in two parts.
 */
-void StepSequencer::seqHostSync(MidiBuffer& midiMessages)
+void StepSequencer::seqHostSync(MidiBuffer& midiMessages, int bufferSize, double sampleRate)
 {
-    AudioPlayHead::CurrentPositionInfo hostPlayHead = params.positionInfo[params.getAudioIndex()];
-    double currPos = hostPlayHead.ppqPosition;
+    const AudioPlayHead::CurrentPositionInfo &hostPlayHead = params.positionInfo[params.getAudioIndex()];
 
-    // if host ist playing
     // NOTE: in Cubase 5 hostPlayHead.isPlaying even before actual playhead starts playing,
-    //       at the beginning currPos can be negative
-    if (hostPlayHead.isPlaying && (currPos >= 0.0))
+    //       at the beginning ppqPosition can be negative, the steps then start at 0
+    if (!hostPlayHead.isPlaying || hostPlayHead.bpm <= 0.0 || sampleRate <= 0.0)
     {
-        // if currPos passes stopNoteTime
-        if (currPos >= stopNoteTime)
-        {
-            if (seqNoteIsPlaying)
-            {
-                sendMidiNoteOffMessage(midiMessages, 0);
-            }
-        }
+        // if host is not playing then stop sequencer and reset variables
+        stopSeq(midiMessages);
+        return;
+    }
 
-        // if currPos passes seqNextStep or (currPos < lastPlayHeadPosition) implies loop or rewind
-        if ((currPos >= seqNextStep) || (currPos < lastPlayHeadPosition))
-        {
-            // stop note if could not stopped before playing seqNote (important for seqNoteLength == seqStepSpeed)
-            if (seqNoteIsPlaying)
-            {
-                sendMidiNoteOffMessage(midiMessages, 0);
-            }
-
-            // calculate note to play
-            currSeqNote = jmax(0, static_cast<int>(currPos / static_cast<double>(seqStepSpeed)) % seqNumSteps);
-            currSeqNote = jmin(currSeqNote, 7);
-
-            // if play upDown -> for all odd periods, play in reverse order (down sequence)
-            if (params.seqPlayMode.getStep() == eSeqPlayModes::eUpDown)
-            {
-                int upDownSeq = jmax(0, static_cast<int>(currPos / static_cast<double>(seqNumSteps) / static_cast<double>(seqStepSpeed)) % 2);
-                if (upDownSeq == 1)
-                {
-                    currSeqNote = seqNumSteps - 1 - currSeqNote;
-                }
-            }
-
-            // if is not playing a note then prepare sending midi noteOn message
-            if (!seqNoteIsPlaying)
-            {
-                // set note to play as random
-                if (params.seqPlayMode.getStep() == eSeqPlayModes::eRandom)
-                {
-                    setStepRandom(currSeqNote);
-                }
-
-                // if any note changed or is muted then send noteOff message to that note
-                midiNoteChanged(midiMessages);
-
-                // send midimessage into midibuffer
-                sendMidiNoteOnMessage(midiMessages, 0);
-
-                // calculate next stopNoteTime
-                stopNoteTime = currPos + seqStepLength;
-            }
-        }
-        // calculate next seqNextStep and save lastPlayHeadPosition
-        double offset = static_cast<double>(seqStepSpeed) - fmod(jmax(0.0, currPos), static_cast<double>(seqStepSpeed));
-        seqNextStep = jmax(0.0, currPos) + offset;
-        lastPlayHeadPosition = currPos;
-        seqStopped = false;
+    const double samplesPerPpq = sampleRate * 60.0 / hostPlayHead.bpm;
+    const double ppqStart = hostPlayHead.ppqPosition;
+    const double ppqEnd = ppqStart + bufferSize / samplesPerPpq;
+
+    if (seqStopped || std::abs(ppqStart - expectedPpq) * samplesPerPpq > maxDriftSamples)
+    {
+        relocate(midiMessages, ppqStart, 0);
+    }
+    else if (seqStepSpeed != lastStepSpeed)
+    {
+        relocate(midiMessages, ppqStart, -1);
+    }
+    seqStopped = false;
+
+    const double loopStart = hostPlayHead.ppqLoopStart;
+    const double loopEnd = hostPlayHead.ppqLoopEnd;
+    if (hostPlayHead.isLooping && loopEnd > loopStart && ppqStart < loopEnd && ppqEnd > loopEnd)
+    {
+        // play up to the loop end, then continue at the loop start
+        const int loopSample = jlimit(0, bufferSize, roundToInt((loopEnd - ppqStart) * samplesPerPpq));
+        playSegment(midiMessages, ppqStart, 0, loopSample, samplesPerPpq);
+        relocate(midiMessages, loopStart, loopSample);
+        playSegment(midiMessages, loopStart, loopSample, bufferSize, samplesPerPpq);
+        expectedPpq = loopStart + (bufferSize - loopSample) / samplesPerPpq;
     }
     else
     {
-        // if host is not playing then stop sequencer and reset variables
-        stopSeq(midiMessages);
+        playSegment(midiMessages, ppqStart, 0, bufferSize, samplesPerPpq);
+        expectedPpq = ppqEnd;
     }
 }
 
 /**
-* Send midi note off message into buffer at given sample position.
+* Plays the note offs and step edges of a part of the block, in order, each at its own sample.
+  Events that lie behind the part are kept for the next one, events before it (drift) are played
+  at its first sample.
+@param ppqStart position of startSample, earlier events are played there
+@param startSample first sample of the part
+@param endSample first sample after the part
 */
-void StepSequencer::sendMidiNoteOffMessage(MidiBuffer& midiMessages, int sample)
+void StepSequencer::playSegment(MidiBuffer& midiMessages, double ppqStart, int startSample, int endSample, double samplesPerPpq)
 {
-    if (currStepOnOff[static_cast<int>(params.seqLastPlayedStep.get())]->getStep() == eOnOffToggle::eOn)
+    for (;;)
     {
-        MidiMessage m = MidiMessage::noteOff(1, lastPlayedNote);
-        midiMessages.addEvent(m, sample);
+        const double stepPpq = static_cast<double>(nextStepCount) * static_cast<double>(seqStepSpeed);
+
+        // the note off comes first if both fall on the same sample (step length == step speed)
+        const bool noteOffNext = seqNoteIsPlaying && noteOffPpq <= stepPpq;
+        const double eventPpq = jmax(ppqStart, noteOffNext ? noteOffPpq : stepPpq);
+        const int sample = startSample + roundToInt((eventPpq - ppqStart) * samplesPerPpq);
+        if (sample >= endSample)
+        {
+            break;
+        }
+
+        if (noteOffNext)
+        {
+            sendMidiNoteOffMessage(midiMessages, sample);
+            continue;
+        }
+
+        // stop note if could not stopped before playing seqNote
+        if (seqNoteIsPlaying)
+        {
+            sendMidiNoteOffMessage(midiMessages, sample);
+        }
+
+        currSeqNote = getStepOfCount(nextStepCount);
+
+        // set note to play as random
+        if (params.seqPlayMode.getStep() == eSeqPlayModes::eRandom)
+        {
+            setStepRandom(currSeqNote);
+        }
+
+        const SeqPattern::Step step = params.seqPattern.getStep(currSeqNote);
+        sendMidiNoteOnMessage(midiMessages, sample, step);
+        // the mod lane follows every step, muted or not
+        params.seqModLane.addStep(sample, step.lanes[SeqPattern::eMod] / 100.f);
+        noteOffPpq = stepPpq + seqStepLength * step.lanes[SeqPattern::eGate] / 100.0;
+        ++nextStepCount;
     }
-    seqNoteIsPlaying = false;
 }
 
 /**
-* Send midi note on message into buffer at given sample position.
+* Continue playing at another position. The next step is the first one at or after ppq.
+@param sample where the playing note is stopped, -1 to let it play to its end
 */
-void StepSequencer::sendMidiNoteOnMessage(MidiBuffer & midiMessages, int sample)
+void StepSequencer::relocate(MidiBuffer& midiMessages, double ppq, int sample)
 {
-    if (currStepOnOff[currSeqNote]->getStep() == eOnOffToggle::eOn)
+    if (sample >= 0 && seqNoteIsPlaying)
     {
-        // emphasis on step 1
-        float seqVelocity = 0.5f;
-        //if (seqNote == 0)
-        //{
-        //    seqVelocity = 0.85f;
-        //}
+        sendMidiNoteOffMessage(midiMessages, sample);
+    }
+    nextStepCount = static_cast<int64>(std::ceil(jmax(0.0, ppq) / static_cast<double>(seqStepSpeed) - stepEpsilon));
+    lastStepSpeed = seqStepSpeed;
+}
 
-        MidiMessage m = MidiMessage::noteOn(1, static_cast<int>(currMidiStepSeq[currSeqNote]->get()), seqVelocity);
-        midiMessages.addEvent(m, sample);
+/**
+* Sequence step played as the stepCount-th step since position 0.
+  If play upDown -> for all odd periods, play in reverse order (down sequence).
+*/
+int StepSequencer::getStepOfCount(int64 stepCount) const
+{
+    int step = static_cast<int>(stepCount % seqNumSteps);
+    if (params.seqPlayMode.getStep() == eSeqPlayModes::eUpDown && (stepCount / seqNumSteps) % 2 == 1)
+    {
+        step = seqNumSteps - 1 - step;
     }
-    seqNoteIsPlaying = true;
-    params.seqLastPlayedStep.set(jmax(0.0f, jmin(static_cast<float>(currSeqNote), 7.0f)));
-    lastPlayedNote = static_cast<int>(currMidiStepSeq[currSeqNote]->get());
+    return jlimit(0, SeqPattern::maxSteps - 1, step);
 }
 
 /**
-* If any seqStepNote changed or is muted then send noteOff message for the old note.
+* Send midi note off message into buffer at given sample position.
 */
-void StepSequencer::midiNoteChanged(MidiBuffer & midiMessages)
+void StepSequencer::sendMidiNoteOffMessage(MidiBuffer& midiMessages, int sample)
 {
-    for (int i = 0; i < seqNumSteps; ++i)
+    // steps that were muted or skipped sent no note
+    if (lastPlayedNote >= 0)
     {
-        // compare with current sequence
-        if ((prevMidiStepSeq[i] != static_cast<int>(currMidiStepSeq[i]->get())) || (prevStepOnOff[i] != currStepOnOff[i]->getStep()))
-        {
-            if (i == static_cast<int>(params.seqLastPlayedStep.get()))
-            {
-                MidiMessage m = MidiMessage::noteOff(1, prevMidiStepSeq[i]);
-                midiMessages.addEvent(m, 0);
-            }
-        }
+        MidiMessage m = MidiMessage::noteOff(1, lastPlayedNote);
+        midiMessages.addEvent(m, sample);
+        lastPlayedNote = -1;
     }
+    seqNoteIsPlaying = false;
+}
 
-    // save new sequence
-    for (int i = 0; i < 8; ++i)
+/**
+* Send midi note on message of a step into buffer at given sample position, unless the step is muted or
+  its probability says no.
+*/
+void StepSequencer::sendMidiNoteOnMessage(MidiBuffer & midiMessages, int sample, const SeqPattern::Step& step)
+{
+    const int probability = step.lanes[SeqPattern::eProbability];
+    if (step.active && (probability >= 100 || random.nextInt(100) < probability))
     {
-        prevMidiStepSeq[i] = static_cast<int>(currMidiStepSeq[i]->get());
-        prevStepOnOff[i] = currStepOnOff[i]->getStep();
+        const int note = step.lanes[SeqPattern::eNote];
+        MidiMessage m = MidiMessage::noteOn(1, note, static_cast<uint8>(step.lanes[SeqPattern::eVelocity]));
+        midiMessages.addEvent(m, sample);
+        lastPlayedNote = note;
     }
+    seqNoteIsPlaying = true;
+    params.seqLastPlayedStep.set(static_cast<float>(currSeqNote));
 }
 
 /**
@@ -550,19 +551,17 @@ void StepSequencer::stopSeq(MidiBuffer& midiMessages)
     {
         params.seqLastPlayedStep.set(0.0f);
         currSeqNote = 0;
-        lastPlayedNote = 0;
-        seqNoteAdd = 1;
-        nextPlaySample = 0;
-        noteOffSample = 0;
-        seqNextStep = 0.0;
-        stopNoteTime = 0.0;
-        lastPlayHeadPosition = 0.0;
+        lastPlayedNote = -1;
+        nextStepCount = 0;
+        noteOffPpq = 0.0;
+        expectedPpq = 0.0;
         seqStopped = true;
         seqNoteIsPlaying = false;
 
         // stop all midimessages from sequencer
         MidiMessage m = MidiMessage::allNotesOff(1);
         midiMessages.addEvent(m, 0);
+        params.seqModLane.addStep(0, 0.f);
     }
 }
 //==============================================================================
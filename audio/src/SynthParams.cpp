@@ -1,4 +1,5 @@
 #include "SynthParams.h"
+#include <algorithm>
 
 
 namespace {
@@ -9,6 +10,11 @@ namespace {
     static const char *onoffnames[] = {
         "Off", "On", nullptr
     };
+
+    //! element of the sequencer pattern in XML patches
+    const char *seqPatternTag = "seqPattern";
+    //! element of the user mod slots in XML patches
+    const char *modSlotsTag = "modSlots";
     
     static const char *sectionStateNames[] = {
         "Expanded", "Collapsed", nullptr
@@ -18,23 +24,224 @@ namespace {
         "Sequential", "Up/Down", "Random", nullptr
     };
 
+    static const char *arpModeNames[] = {
+        "Up", "Down", "Up/Down", "Random", "As Played", nullptr
+    };
+
+    static const char *fxSlotNames[] = {
+        "Low-Fi", "Clipping", "Delay", "Chorus", "Reverb", "Convolution", nullptr
+    };
+
+    static const char *globalModSourceNames[] = {
+        "None", "Global LFO 1", "Global LFO 2", "Sequencer", "Modwheel (MW)", "Foot (Ft)", "ExpPedal (Ped)", nullptr
+    };
+
+    static const char *globalModDestNames[] = {
+        "None", "Master Amp", "Master Pan", "Delay Time", "Delay Feedback", "Chorus Depth", "Clipping", "Low-Fi Bits", nullptr
+    };
+
     static const char *biquadFilters[] = {
         "Lowpass", "Highpass", "Bandpass", "Ladder", nullptr
     };
 
     static const char *modsourcenames[] = {
         "None", "Aftertouch (AT)", "KeyBipolar (KB)", "InvertedVelocity (-Vel)", "Velocity (Vel)", "Foot (Ft)", "ExpPedal (Ped)", "Modwheel (MW)", "Pitchbend (PB)",
-        "LFO1", "LFO2", "LFO3", "VolEnvelope", "Envelope2", "Envelope3", nullptr
+        "LFO1", "LFO2", "LFO3", "VolEnvelope", "Envelope2", "Envelope3", "Sequencer", "Slide (SL)", nullptr
     };
 
     static const char *modSourceNamesShort[] = {
         " ", "AT", "KB", "-Vel", "Vel", "Ft", "Ped", "MW", "PB",
-        "1", "2", "3", "1", "2", "3", nullptr
+        "1", "2", "3", "1", "2", "3", "Seq", "SL", nullptr
+    };
+
+    static const char *moddestnames[] = {
+        "Filter1 LC", "Filter2 LC", "Filter1 HC", "Filter2 HC", "Filter1 Res", "Filter2 Res",
+        "Osc1 Gain", "Osc2 Gain", "Osc3 Gain", "Osc1 Pan", "Osc2 Pan", "Osc3 Pan", "Osc1 Pitch", "Osc2 Pitch", "Osc3 Pitch",
+        "Osc1 PW", "Osc2 PW", "Osc3 PW", "LFO1 Freq", "LFO2 Freq", "LFO3 Freq", "VolEnv Speed", "Env2 Speed", "Env3 Speed", nullptr
     };
+    static_assert(sizeof(moddestnames) / sizeof(moddestnames[0]) == MAX_DESTINATIONS + 1, "a name per mod destination");
 
     static const char *waveformNames[] = {
         "Square", "Saw", "White-noise"
     };
+
+    //==============================================================================
+    // param metadata, shared by all instances
+    namespace descriptors {
+        constexpr ParamDescriptor oscSection = steppedDescriptor("oscillator section", "oscSection", "oscillator section", eSectionState::eExpanded, sectionStateNames);
+        constexpr ParamDescriptor envSection = steppedDescriptor("envelopes section", "envSection", "envelopes section", eSectionState::eCollapsed, sectionStateNames);
+        constexpr ParamDescriptor lfoSection = steppedDescriptor("lfo section", "lfoSection", "lfo section", eSectionState::eCollapsed, sectionStateNames);
+        constexpr ParamDescriptor filterSection = steppedDescriptor("filter section", "filterSection", "filter section", eSectionState::eCollapsed, sectionStateNames);
+        constexpr ParamDescriptor fxSection = steppedDescriptor("fx section", "fxSection", "fx section", eSectionState::eCollapsed, sectionStateNames);
+        constexpr ParamDescriptor seqSection = steppedDescriptor("sequencer section", "seqSection", "sequencer section", eSectionState::eCollapsed, sectionStateNames);
+        constexpr ParamDescriptor arpSection = steppedDescriptor("arpeggiator section", "arpSection", "arpeggiator section", eSectionState::eCollapsed, sectionStateNames);
+        constexpr ParamDescriptor modSlotsSection = steppedDescriptor("mod slots section", "modSlotsSection", "mod slots section", eSectionState::eCollapsed, sectionStateNames);
+        constexpr ParamDescriptor masterAmp("master amp", "masterAmp", "Master amp", "dB", -96.f, 12.f, -6.f);
+        constexpr ParamDescriptor masterPan("master pan", "masterPan", "Master pan", "%", -100.f, 100.f, 0.f);
+        constexpr ParamDescriptor freq("main freq", "freq", "freq", "Hz", 220.f, 880.f, 440.f);
+        constexpr ParamDescriptor delayDryWet("dry/wet", "delWet", "Delay dry/wet", "", 0.f, 1.f, 0.f);
+        constexpr ParamDescriptor delayFeedback("feedback", "delFeed", "Delay feedback", "", 0.f, 1.f, 0.f);
+        constexpr ParamDescriptor delayTime("time", "delTime", "Delay time", "ms", 1., 20000., 1000.);
+        constexpr ParamDescriptor delaySync = steppedDescriptor("Tempo Sync", "delSync", "Delay sync", eOnOffToggle::eOff, onoffnames);
+        constexpr ParamDescriptor delayDividend("SyncDel Dividend", "delDivd", "Delay dividend", "", 1, 5, 1);
+        constexpr ParamDescriptor delayDivisor("SyncDel Divisor", "delDivs", "Delay divisor", "", 1, 64, 4);
+        constexpr ParamDescriptor delayCutoff("lp cutoff", "delCut", "Delay cutoff", "Hz", 40.f, 20000.f, 20000.f);
+        constexpr ParamDescriptor delayResonance("resonance", "delRes", "Delay resonance", "dB", -25.f, 0.f, 0.f);
+        constexpr ParamDescriptor delayTriplet = steppedDescriptor("Delay Triplet", "delTrip", "Delay triplet", eOnOffToggle::eOff, onoffnames);
+        constexpr ParamDescriptor delayDottedLength = steppedDescriptor("Delay Dotted Length", "delDot", "Delay dotted length", eOnOffToggle::eOff, onoffnames);
+        constexpr ParamDescriptor delayRecordFilter = steppedDescriptor("Delay Record", "delRec", "Delay record filter", eOnOffToggle::eOff, onoffnames);
+        constexpr ParamDescriptor delayReverse = steppedDescriptor("Delay Reverse", "delRev", "Delay reverse", eOnOffToggle::eOff, onoffnames);
+        constexpr ParamDescriptor delayActivation = steppedDescriptor("Delay Activation", "delayActivation", "Delay Active", eOnOffToggle::eOff, onoffnames);
+        constexpr ParamDescriptor syncToggle = steppedDescriptor("Delay Sync", "syncToggle", "Sync Toggle", eOnOffToggle::eOff, onoffnames);
+        constexpr ParamDescriptor fxSlot0 = steppedDescriptor("FX Slot 1", "fxSlot0", "FX Slot 1", eFxSlots::eLowFi, fxSlotNames);
+        constexpr ParamDescriptor fxSlot1 = steppedDescriptor("FX Slot 2", "fxSlot1", "FX Slot 2", eFxSlots::eClipping, fxSlotNames);
+        constexpr ParamDescriptor fxSlot2 = steppedDescriptor("FX Slot 3", "fxSlot2", "FX Slot 3", eFxSlots::eDelay, fxSlotNames);
+        constexpr ParamDescriptor fxSlot3 = steppedDescriptor("FX Slot 4", "fxSlot3", "FX Slot 4", eFxSlots::eChorus, fxSlotNames);
+        constexpr ParamDescriptor fxSlot4 = steppedDescriptor("FX Slot 5", "fxSlot4", "FX Slot 5", eFxSlots::eReverb, fxSlotNames);
+        constexpr ParamDescriptor fxSlot5 = steppedDescriptor("FX Slot 6", "fxSlot5", "FX Slot 6", eFxSlots::eConvolution, fxSlotNames);
+        constexpr ParamDescriptor lowFiActivation = steppedDescriptor("Activation", "lowFiActivation", "LowFi Active", eOnOffToggle::eOff, onoffnames);
+        constexpr ParamDescriptor nBitsLowFi("bit degr.", "nBitsLowFi", "Number Bits", "bit", 1.f, 16.f, 16.f);
+        constexpr ParamDescriptor chorDelayLength("width", "chorWidth", "Chorus Width", "s", .02f, .08f, .05f);
+        constexpr ParamDescriptor chorModRate("rate", "chorRate", "Chorus Rate", "Hz", 0.f, 1.5f, 0.5f);
+        constexpr ParamDescriptor chorDryWet("dry/wet", "ChorAmount", "Chorus Dry/Wet", "", 0.f, 1.f, 0.f);
+        constexpr ParamDescriptor chorModDepth("depth", "ChorDepth", "Chorus Depth", "ms", 1.f, 20.f, 15.f);
+        constexpr ParamDescriptor chorActivation = steppedDescriptor("Activation", "chorActivation", "Chorus Active", eOnOffToggle::eOff, onoffnames);
+        constexpr ParamDescriptor revSize("size", "revSize", "Reverb size", "", 0.f, 1.f, .5f);
+        constexpr ParamDescriptor revDecay("decay", "revDecay", "Reverb decay", "s", .1f, 20.f, 2.f);
+        constexpr ParamDescriptor revDamping("damping", "revDamp", "Reverb damping", "", 0.f, 1.f, .5f);
+        constexpr ParamDescriptor revPredelay("predelay", "revPredelay", "Reverb predelay", "ms", 0.f, 200.f, 10.f);
+        constexpr ParamDescriptor revDryWet("dry/wet", "revWet", "Reverb dry/wet", "", 0.f, 1.f, .3f);
+        constexpr ParamDescriptor revActivation = steppedDescriptor("Activation", "revActivation", "Reverb Active", eOnOffToggle::eOff, onoffnames);
+        constexpr ParamDescriptor convDryWet("dry/wet", "convWet", "Convolution dry/wet", "", 0.f, 1.f, .3f);
+        constexpr ParamDescriptor convActivation = steppedDescriptor("Activation", "convActivation", "Convolution Active", eOnOffToggle::eOff, onoffnames);
+        constexpr ParamDescriptor clippingFactor("clipping", "clippingFactor", "Clipping", "dB", 0.f, 25.f, 0.0f);
+        constexpr ParamDescriptor clippingActivation = steppedDescriptor("Activation", "clippingActivation", "Clipping Active", eOnOffToggle::eOff, onoffnames);
+        constexpr ParamDescriptor seqPlaceHolder("Placeholder", "seqPlaceholder", "SeqPlaceholder", "", 0.0f, 127.0f, 126.0f);
+        constexpr ParamDescriptor seqPlayNoHost = steppedDescriptor("Play No Host", "seqPlayNoHost", "seqPlayNoHost", eOnOffToggle::eOff, onoffnames);
+        constexpr ParamDescriptor seqPlaySyncHost = steppedDescriptor("Play Sync Host", "seqPlaySyncHost", "seqPlaySyncHost", eOnOffToggle::eOff, onoffnames);
+        constexpr ParamDescriptor seqPlayMode = steppedDescriptor("SeqPlayMode", "seqPlayMode", "SeqPlayMode", eSeqPlayModes::eSequential, seqPlayModeNames);
+        constexpr ParamDescriptor seqLastPlayedStep("Last Played Step", "lastPlayedStep", "Last Played Step", "", 0.0f, 63.0f, 0.0f);
+        constexpr ParamDescriptor seqNumSteps("Steps", "seqNumSteps", "Steps", "", 1.0f, 64.0f, 8.0f);
+        constexpr ParamDescriptor seqStepSpeed("Speed", "seqStepSpeed", "Speed", "", 1.0f, 64.0f, 4.0f);
+        constexpr ParamDescriptor seqStepLength("Length", "seqNoteLength", "Length", "", 1.0f, 64.0f, 4.0f);
+        constexpr ParamDescriptor seqTriplets = steppedDescriptor("Seq Triplets", "seqTriplets", "Seq Triplets", eOnOffToggle::eOff, onoffnames);
+        constexpr ParamDescriptor seqDottedLength = steppedDescriptor("Seq Dotted Length", "seqDottedLength", "Seq Dotted Length", eOnOffToggle::eOff, onoffnames);
+        constexpr ParamDescriptor seqRandomMin("Min", "seqRandomMin", "Min", "", 0.0f, 127.0f, 0.0f);
+        constexpr ParamDescriptor seqRandomMax("Max", "seqRandomMax", "Max", "", 0.0f, 127.0f, 127.0f);
+        constexpr ParamDescriptor seqStep0("Step 0", "seqNote0", "Step 0", "", 0.0f, 127.0f, 60.0f);
+        constexpr ParamDescriptor seqStep1("Step 1", "seqNote1", "Step 1", "", 0.0f, 127.0f, 62.0f);
+        constexpr ParamDescriptor seqStep2("Step 2", "seqNote2", "Step 2", "", 0.0f, 127.0f, 64.0f);
+        constexpr ParamDescriptor seqStep3("Step 3", "seqNote3", "Step 3", "", 0.0f, 127.0f, 65.0f);
+        constexpr ParamDescriptor seqStep4("Step 4", "seqNote4", "Step 4", "", 0.0f, 127.0f, 67.0f);
+        constexpr ParamDescriptor seqStep5("Step 5", "seqNote5", "Step 5", "", 0.0f, 127.0f, 69.0f);
+        constexpr ParamDescriptor seqStep6("Step 6", "seqNote6", "Step 6", "", 0.0f, 127.0f, 71.0f);
+        constexpr ParamDescriptor seqStep7("Step 7", "seqNote7", "Step 7", "", 0.0f, 127.0f, 72.0f);
+        constexpr ParamDescriptor seqStepActive0 = steppedDescriptor("Step 0 Active", "seqStepActive0", "Step 0 Active", eOnOffToggle::eOn, onoffnames);
+        constexpr ParamDescriptor seqStepActive1 = steppedDescriptor("Step 1 Active", "seqStepActive1", "Step 1 Active", eOnOffToggle::eOn, onoffnames);
+        constexpr ParamDescriptor seqStepActive2 = steppedDescriptor("Step 2 Active", "seqStepActive2", "Step 2 Active", eOnOffToggle::eOn, onoffnames);
+        constexpr ParamDescriptor seqStepActive3 = steppedDescriptor("Step 3 Active", "seqStepActive3", "Step 3 Active", eOnOffToggle::eOn, onoffnames);
+        constexpr ParamDescriptor seqStepActive4 = steppedDescriptor("Step 4 Active", "seqStepActive4", "Step 4 Active", eOnOffToggle::eOn, onoffnames);
+        constexpr ParamDescriptor seqStepActive5 = steppedDescriptor("Step 5 Active", "seqStepActive5", "Step 5 Active", eOnOffToggle::eOn, onoffnames);
+        constexpr ParamDescriptor seqStepActive6 = steppedDescriptor("Step 6 Active", "seqStepActive6", "Step 6 Active", eOnOffToggle::eOn, onoffnames);
+        constexpr ParamDescriptor seqStepActive7 = steppedDescriptor("Step 7 Active", "seqStepActive7", "Step 7 Active", eOnOffToggle::eOn, onoffnames);
+        constexpr ParamDescriptor arpActivation = steppedDescriptor("Arp Active", "arpActivation", "Arp Active", eOnOffToggle::eOff, onoffnames);
+        constexpr ParamDescriptor arpMode = steppedDescriptor("Arp Mode", "arpMode", "Arp Mode", eArpModes::eUp, arpModeNames);
+        constexpr ParamDescriptor arpOctaves("Octaves", "arpOctaves", "Arp Octaves", "", 1.0f, 4.0f, 1.0f);
+        constexpr ParamDescriptor arpSpeed("Speed", "arpSpeed", "Arp Speed", "", 1.0f, 64.0f, 16.0f);
+        constexpr ParamDescriptor arpGate("Gate", "arpGate", "Arp Gate", "%", 1.0f, 100.0f, 50.0f);
+        constexpr ParamDescriptor mpeActivation = steppedDescriptor("MPE", "mpeActivation", "MPE Active", eOnOffToggle::eOff, onoffnames);
+
+        namespace osc {
+            constexpr ParamDescriptor fine("fine", "fine", "f.tune", "ct", -100.f, 100.f, 0.f);
+            constexpr ParamDescriptor coarse("coarse", "coarse", "c.tune", "st", -36.f, 36.f, 0.f);
+            constexpr ParamDescriptor trngAmount("triangle", "trngAmount", "triangle amount", "", 0.0f, 1.0f, 0.0f);
+            constexpr ParamDescriptor pulseWidth("width", "pulseWidth", "pulsewidth", "", 0.01f, 0.99f, 0.5f);
+            constexpr ParamDescriptor waveForm = steppedDescriptor("Waveform", "oscWaveform", "Waveform", eOscWaves::eOscSquare, waveformNames);
+            constexpr ParamDescriptor panDir("pan", "panDir", "pan direction", "%", -100.f, 100.f, 0.f);
+            constexpr ParamDescriptor vol("gain", "vol", "Vol", "dB", -96.f, 12.f, -6.f);
+            constexpr ParamDescriptor panModAmount1("PanModAmount1", "OSCPanModAmount1", "Pan ModAmount 1", "%", 0.f, 200.f, 100.f);
+            constexpr ParamDescriptor panModAmount2("PanModAmount2", "OSCPanModAmount2", "Pan ModAmount 2", "%", 0.f, 200.f, 100.f);
+            constexpr ParamDescriptor panModSrc1 = steppedDescriptor("PanModSrc1", "OSCPanModSrc1", "Pan ModSource 1", eModSource::eNone, modsourcenames);
+            constexpr ParamDescriptor panModSrc2 = steppedDescriptor("PanModSrc2", "OSCPanModSrc2", "Pan ModSource 2", eModSource::eNone, modsourcenames);
+            constexpr ParamDescriptor shapeModAmount1("ShapeModAmount1", "OSCShapeModAmount1", "Shape ModAmount 1", "", 0.f, 1.f, 0.5f);
+            constexpr ParamDescriptor shapeModAmount2("ShapeModAmount2", "OSCShapeModAmount2", "Shape ModAmount 2", "", 0.f, 1.f, 0.5f);
+            constexpr ParamDescriptor shapeModSrc1 = steppedDescriptor("ShapeModSrc1", "OSCShapeModSrc1", "Shape ModSource 1", eModSource::eNone, modsourcenames);
+            constexpr ParamDescriptor shapeModSrc2 = steppedDescriptor("ShapeModSrc2", "OSCShapeModSrc2", "Shape ModSource 2", eModSource::eNone, modsourcenames);
+            constexpr ParamDescriptor pitchModAmount1("PitchModAmount1", "OSCPitchModAmount1", "Pitch ModAmount 1", "st", 0.f, 48.f, 24.f);
+            constexpr ParamDescriptor pitchModAmount2("PitchModAmount2", "OSCPitchModAmount2", "Pitch ModAmount 2", "st", 0.f, 48.f, 24.f);
+            constexpr ParamDescriptor pitchModSrc1 = steppedDescriptor("PitchModSrc1", "OSCPitchModSrc1", "Pitch ModSource 1", eModSource::eNone, modsourcenames);
+            constexpr ParamDescriptor pitchModSrc2 = steppedDescriptor("PitchModSrc2", "OSCPitchModSrc2", "Pitch ModSource 2", eModSource::eNone, modsourcenames);
+            constexpr ParamDescriptor gainModAmount1("GainModAmount1", "OSCGainModAmount1", "Gain ModAmount 1", "dB", 0.f, 96.f, 48.0f);
+            constexpr ParamDescriptor gainModAmount2("GainModAmount2", "OSCGainModAmount2", "Gain ModAmount 2", "dB", 0.f, 96.f, 48.0f);
+            constexpr ParamDescriptor gainModSrc1 = steppedDescriptor("GainModSrc1", "GainModSrc1", "Gain ModSource 1", eModSource::eNone, modsourcenames);
+            constexpr ParamDescriptor gainModSrc2 = steppedDescriptor("GainModSrc2", "GainModSrc2", "Gain ModSource 2", eModSource::eNone, modsourcenames);
+            constexpr ParamDescriptor oscActivation = steppedDescriptor("Activation", "Activation", "Active", eOnOffToggle::eOn, onoffnames);
+        }
+
+        namespace env {
+            constexpr ParamDescriptor attack("att.", "envAttack", "attack", "s", 0.001f, 5.0f, 0.005f);
+            constexpr ParamDescriptor release("rel.", "envRelease", "release", "s", 0.001f, 5.0f, 0.5f);
+            constexpr ParamDescriptor attackShape("Attack Shape", "envAttackShape", "attack shape", "", 0.01f, 10.0f, 1.0f);
+            constexpr ParamDescriptor decayShape("Decay Shape", "envDecayShape", "decay shape", "", 0.01f, 10.0f, 1.0f);
+            constexpr ParamDescriptor releaseShape("Release Shape", "envReleaseShape", "release shape", "", 0.01f, 10.0f, 1.0f);
+            constexpr ParamDescriptor decay("dec.", "envDecay", "decay", "s", 0.001f, 5.0f, 0.05f);
+            constexpr ParamDescriptor speedModAmount1("ENV SpeedModAmount1", "ENVSpeedModAmount1", "Speed ModAmount 1", "", 0.f, 8.f, 4.f);
+            constexpr ParamDescriptor speedModAmount2("ENV SpeedModAmount2", "ENVSpeedModAmount2", "Speed ModAmount 2", "", 0.f, 8.f, 4.f);
+            constexpr ParamDescriptor speedModSrc1 = steppedDescriptor("ENV Speed ModSrc1", "ENVSpeedModSrc1", "Speed ModSource 1", eModSource::eNone, modsourcenames);
+            constexpr ParamDescriptor speedModSrc2 = steppedDescriptor("ENV Speed ModSrc2", "ENVSpeedModSrc2", "Speed ModSource 2", eModSource::eNone, modsourcenames);
+            constexpr ParamDescriptor sustain("sust.", "envSustain", "sustain", "", 0.f, 1.f, 1.f);
+        }
+
+        namespace envVol {
+            constexpr ParamDescriptor sustain("sust.", "envSustain", "sustain", "dB", -96.f, 0.f, -6.f);
+        }
+
+        namespace lfo {
+            constexpr ParamDescriptor freq("freq", "lfo1freq", "freq", "Hz", .01f, 50.f, 1.f);
+            constexpr ParamDescriptor wave = steppedDescriptor("Wave", "lfo1wave", "waveform", eLfoWaves::eLfoSine, lfowavenames);
+            constexpr ParamDescriptor tempSync = steppedDescriptor("TempoSync", "tempoSyncSwitch", "TempoSync", eOnOffToggle::eOff, onoffnames);
+            constexpr ParamDescriptor lfoTriplets = steppedDescriptor("Lfo Triplet", "lfoTriplet", "Lfo Triplet", eOnOffToggle::eOff, onoffnames);
+            constexpr ParamDescriptor lfoDottedLength = steppedDescriptor("Lfo Dotted Note Length", "lfoDottedLength", "Lfo Dotted Length", eOnOffToggle::eOff, onoffnames);
+            constexpr ParamDescriptor noteLength("Note Length", "notelength", "Note Length", "", 1.f, 64.f, 4.f);
+            constexpr ParamDescriptor fadeIn("fade-in", "lfoFadein", "fade-in", "s", 0.f, 10.f, 0.f);
+            constexpr ParamDescriptor freqModAmount1("FreqModAmount1", "LFOFreqModAmount1", "Freq ModAmount 1", "oct", 0.f, 10.f, 5.0f);
+            constexpr ParamDescriptor freqModAmount2("FreqModAmount2", "LFOFreqModAmount2", "Freq ModAmount 2", "oct", 0.f, 10.f, 5.0f);
+            constexpr ParamDescriptor freqModSrc1 = steppedDescriptor("FreqModSrc1", "LFOFreqModSrc1", "Freq ModSource 1", eModSource::eNone, modsourcenames);
+            constexpr ParamDescriptor freqModSrc2 = steppedDescriptor("FreqModSrc2", "LFOFreqModSrc2", "Freq ModSource 2", eModSource::eNone, modsourcenames);
+            constexpr ParamDescriptor gainModSrc = steppedDescriptor("GainModSrc", "LFOGainModSrc", "Gain ModSource", eModSource::eNone, modsourcenames);
+        }
+
+        namespace globalLfo {
+            constexpr ParamDescriptor freq("freq", "freq", "freq", "Hz", .01f, 50.f, 1.f);
+            constexpr ParamDescriptor wave = steppedDescriptor("Wave", "wave", "waveform", eLfoWaves::eLfoSine, lfowavenames);
+        }
+
+        namespace globalModSlot {
+            constexpr ParamDescriptor source = steppedDescriptor("Source", "source", "Source", eGlobalModSource::eNone, globalModSourceNames);
+            constexpr ParamDescriptor destination = steppedDescriptor("Destination", "destination", "Destination", eGlobalModDest::eNone, globalModDestNames);
+            constexpr ParamDescriptor amount("Amount", "amount", "Amount", "%", -100.f, 100.f, 0.f);
+        }
+
+        namespace filter {
+            constexpr ParamDescriptor passtype = steppedDescriptor("Type", "FILTERType", "Type", eBiquadFilters::eLowpass, biquadFilters);
+            constexpr ParamDescriptor lpCutoff("LPcutoff", "lpCutoff", "LP Cutoff", "Hz", 10.f, 20000.f, 20000.f);
+            constexpr ParamDescriptor hpCutoff("HPcutoff", "hpCutoff", "HP Cutoff", "Hz", 10.f, 20000.f, 10.f);
+            constexpr ParamDescriptor resonance("reson.", "FILTERResonance", "Resonance", "", 0.f, 10.f, 0.f);
+            constexpr ParamDescriptor lpModAmount1("Lc ModAmount1", "FILTERLcModAmount1", "Lc ModAmount 1", "oct", 0.f, 10.f, 5.f);
+            constexpr ParamDescriptor lpModAmount2("Lc ModAmnout2", "FILTERLcModAmount2", "Lc ModAmount 2", "oct", 0.f, 10.f, 5.f);
+            constexpr ParamDescriptor hpModAmount1("Hc ModAmount1", "FILTERHcModAmount1", "Hc ModAmount 1", "oct", 0.f, 8.f, 4.f);
+            constexpr ParamDescriptor hpModAmount2("Hc ModAmount2", "FILTERHcModAmount2", "Hc ModAmount 2", "oct", 0.f, 8.f, 4.f);
+            constexpr ParamDescriptor resModAmount1("Res ModAmount1", "FILTERResModAmount1", "Res ModAmount 1", "", 0.f, 10.f, 5.f);
+            constexpr ParamDescriptor resModAmount2("Res ModAmount2", "FILTERResModAmount2", "Res ModAmount 2", "", 0.f, 10.f, 5.f);
+            constexpr ParamDescriptor lpCutModSrc1 = steppedDescriptor("Lc ModSrc1", "FILTERLcModSrc1", "Lc ModSource 1", eModSource::eNone, modsourcenames);
+            constexpr ParamDescriptor lpCutModSrc2 = steppedDescriptor("Lc ModSrc2", "FILTERLcModSrc2", "Lc ModSource 2", eModSource::eNone, modsourcenames);
+            constexpr ParamDescriptor hpCutModSrc1 = steppedDescriptor("Hc ModSrc1", "FILTERHcModSrc1", "Hc ModSource 1", eModSource::eNone, modsourcenames);
+            constexpr ParamDescriptor hpCutModSrc2 = steppedDescriptor("Hc ModSrc2", "FILTERHcModSrc2", "Hc ModSource 2", eModSource::eNone, modsourcenames);
+            constexpr ParamDescriptor resonanceModSrc1 = steppedDescriptor("Res ModSrc1", "FILTERResModSrc1", "Res ModSource 1", eModSource::eNone, modsourcenames);
+            constexpr ParamDescriptor resonanceModSrc2 = steppedDescriptor("Res ModSrc2", "FILTERResModSrc2", "Res ModSource 2", eModSource::eNone, modsourcenames);
+            constexpr ParamDescriptor filterActivation = steppedDescriptor("Filter Activation", "filterActivation", "LowFi Active", eOnOffToggle::eOff, onoffnames);
+        }
+    }
 }
 
 
@@ -44,6 +251,7 @@ const Colour SynthParams::lfoColour (0xff855050);
 const Colour SynthParams::filterColour (0xff557144);
 const Colour SynthParams::fxColour (0xff2b3240);
 const Colour SynthParams::stepSeqColour (0xff564c43);
+const Colour SynthParams::modSlotsColour (0xff4a5866);
 const Colour SynthParams::onOffSwitchEnabled (0xff557144);
 const Colour SynthParams::onOffSwitchDisabled (102, 102, 102);
 const Colour SynthParams::envelopeCurveLine (216, 202, 155);
@@ -53,7 +261,124 @@ const Colour SynthParams::waveformBackground(85, 93, 104);
 const Colour SynthParams::otherModulation(150, 150, 150); // add more different colours
 
 SynthParams::SynthParams()
-    : serializeParams{
+    : masterAmp(store, descriptors::masterAmp)
+    , masterPan(store, descriptors::masterPan)
+    , freq(store, descriptors::freq)
+    , filter{ { {store}, {store} } }
+    , lfo{ { {store}, {store}, {store} } }
+    , envVol{ { {store} } }
+    , env{ { {store}, {store} } }
+    , osc{ { {store}, {store}, {store} } }
+    , globalLfo{ { {store}, {store} } }
+    , globalModSlot{ { {store}, {store}, {store}, {store} } }
+    // section states
+    , oscSection(store, descriptors::oscSection)
+    , envSection(store, descriptors::envSection)
+    , lfoSection(store, descriptors::lfoSection)
+    , filterSection(store, descriptors::filterSection)
+    , fxSection(store, descriptors::fxSection)
+    , seqSection(store, descriptors::seqSection)
+    , arpSection(store, descriptors::arpSection)
+    , modSlotsSection(store, descriptors::modSlotsSection)
+    // FX
+    , clippingFactor(store, descriptors::clippingFactor)
+    , clippingActivation(store, descriptors::clippingActivation)
+    , chorDelayLength(store, descriptors::chorDelayLength)
+    , chorDryWet(store, descriptors::chorDryWet)
+    , chorModRate(store, descriptors::chorModRate)
+    , chorModDepth(store, descriptors::chorModDepth)
+    , chorActivation(store, descriptors::chorActivation)
+    , revSize(store, descriptors::revSize)
+    , revDecay(store, descriptors::revDecay)
+    , revDamping(store, descriptors::revDamping)
+    , revPredelay(store, descriptors::revPredelay)
+    , revDryWet(store, descriptors::revDryWet)
+    , revActivation(store, descriptors::revActivation)
+    , convDryWet(store, descriptors::convDryWet)
+    , convActivation(store, descriptors::convActivation)
+    // sequencer
+    , seqPlaceHolder(store, descriptors::seqPlaceHolder)
+    , seqPlayNoHost(store, descriptors::seqPlayNoHost)
+    , seqPlaySyncHost(store, descriptors::seqPlaySyncHost)
+    , seqPlayMode(store, descriptors::seqPlayMode)
+    , seqLastPlayedStep(store, descriptors::seqLastPlayedStep)
+    , seqNumSteps(store, descriptors::seqNumSteps)
+    , seqStepSpeed(store, descriptors::seqStepSpeed)
+    , seqStepLength(store, descriptors::seqStepLength)
+    , seqTriplets(store, descriptors::seqTriplets)
+    , seqDottedLength(store, descriptors::seqDottedLength)
+    , seqRandomMin(store, descriptors::seqRandomMin)
+    , seqRandomMax(store, descriptors::seqRandomMax)
+    , seqStep0(store, descriptors::seqStep0)
+    , seqStep1(store, descriptors::seqStep1)
+    , seqStep2(store, descriptors::seqStep2)
+    , seqStep3(store, descriptors::seqStep3)
+    , seqStep4(store, descriptors::seqStep4)
+    , seqStep5(store, descriptors::seqStep5)
+    , seqStep6(store, descriptors::seqStep6)
+    , seqStep7(store, descriptors::seqStep7)
+    , seqStepActive0(store, descriptors::seqStepActive0)
+    , seqStepActive1(store, descriptors::seqStepActive1)
+    , seqStepActive2(store, descriptors::seqStepActive2)
+    , seqStepActive3(store, descriptors::seqStepActive3)
+    , seqStepActive4(store, descriptors::seqStepActive4)
+    , seqStepActive5(store, descriptors::seqStepActive5)
+    , seqStepActive6(store, descriptors::seqStepActive6)
+    , seqStepActive7(store, descriptors::seqStepActive7)
+    // arpeggiator
+    , arpActivation(store, descriptors::arpActivation)
+    , arpMode(store, descriptors::arpMode)
+    , arpOctaves(store, descriptors::arpOctaves)
+    , arpSpeed(store, descriptors::arpSpeed)
+    , arpGate(store, descriptors::arpGate)
+    // midi
+    , mpeActivation(store, descriptors::mpeActivation)
+    // FX
+    , lowFiActivation(store, descriptors::lowFiActivation)
+    , nBitsLowFi(store, descriptors::nBitsLowFi)
+    , delayFeedback(store, descriptors::delayFeedback)
+    , delayDryWet(store, descriptors::delayDryWet)
+    , delayTime(store, descriptors::delayTime)
+    , delaySync(store, descriptors::delaySync)
+    , delayDividend(store, descriptors::delayDividend)
+    , delayDivisor(store, descriptors::delayDivisor)
+    , delayCutoff(store, descriptors::delayCutoff)
+    , delayResonance(store, descriptors::delayResonance)
+    , delayTriplet(store, descriptors::delayTriplet)
+    , delayDottedLength(store, descriptors::delayDottedLength)
+    , delayRecordFilter(store, descriptors::delayRecordFilter)
+    , delayReverse(store, descriptors::delayReverse)
+    , delayActivation(store, descriptors::delayActivation)
+    , syncToggle(store, descriptors::syncToggle)
+    , fxSlot0(store, descriptors::fxSlot0)
+    , fxSlot1(store, descriptors::fxSlot1)
+    , fxSlot2(store, descriptors::fxSlot2)
+    , fxSlot3(store, descriptors::fxSlot3)
+    , fxSlot4(store, descriptors::fxSlot4)
+    , fxSlot5(store, descriptors::fxSlot5)
+    // smoothing
+    , masterAmpRamp(masterAmp)
+    , masterPanRamp(masterPan)
+    , delayFeedbackRamp(delayFeedback)
+    , delayDryWetRamp(delayDryWet)
+    , chorDryWetRamp(chorDryWet)
+    , revDryWetRamp(revDryWet)
+    , convDryWetRamp(convDryWet)
+    , clippingFactorRamp(clippingFactor)
+    , delayTimeRamp(delayTime, ParamRamp::eMode::eMultiplicative)
+    , chorModDepthRamp(chorModDepth)
+    , nBitsLowFiRamp(nBitsLowFi)
+    , delayCutoffRamp(delayCutoff, ParamRamp::eMode::eMultiplicative)
+    , revDecayRamp(revDecay, ParamRamp::eMode::eMultiplicative)
+    , revDampingRamp(revDamping)
+    , rampParams{ &masterAmpRamp, &masterPanRamp,
+    &osc[0].volRamp, &osc[0].panDirRamp, &osc[0].pulseWidthRamp, &osc[1].volRamp, &osc[1].panDirRamp, &osc[1].pulseWidthRamp,
+    &osc[2].volRamp, &osc[2].panDirRamp, &osc[2].pulseWidthRamp,
+    &filter[0].lpCutoffRamp, &filter[0].hpCutoffRamp, &filter[0].resonanceRamp,
+    &filter[1].lpCutoffRamp, &filter[1].hpCutoffRamp, &filter[1].resonanceRamp,
+    &delayFeedbackRamp, &delayDryWetRamp, &chorDryWetRamp, &revDryWetRamp, &convDryWetRamp, &clippingFactorRamp,
+    &delayTimeRamp, &chorModDepthRamp, &nBitsLowFiRamp, &delayCutoffRamp, &revDecayRamp, &revDampingRamp }
+    , serializeParams{
         // TODO: Think of another way to register all the struct params?
     //Oscillators PArams
     &osc[0].fine, &osc[0].coarse, &osc[0].panDir,&osc[0].vol,&osc[0].trngAmount,&osc[0].pulseWidth,&osc[0].waveForm,&osc[0].pitchModAmount1, &osc[0].pitchModAmount2,&osc[0].pitchModSrc1, &osc[0].pitchModSrc2,
@@ -76,78 +401,32 @@ SynthParams::SynthParams()
     //Step Sequencer
     &seqPlaySyncHost, &seqPlayMode, &seqNumSteps, &seqStepSpeed, &seqStepLength, &seqTriplets, &seqDottedLength, &seqStep0, &seqStep1, &seqStep2, &seqStep3, &seqStep4, &seqStep5, &seqStep6, &seqStep7,
     &seqStepActive0, &seqStepActive1, &seqStepActive2, &seqStepActive3, &seqStepActive4, &seqStepActive5, &seqStepActive6, &seqStepActive7, &seqRandomMin, &seqRandomMax,
+    //Arpeggiator
+    &arpActivation, &arpMode, &arpOctaves, &arpSpeed, &arpGate,
+    //Midi
+    &mpeActivation,
+    //Global modulation bus
+    &globalLfo[0].freq, &globalLfo[0].wave, &globalLfo[1].freq, &globalLfo[1].wave,
+    &globalModSlot[0].source, &globalModSlot[0].destination, &globalModSlot[0].amount,
+    &globalModSlot[1].source, &globalModSlot[1].destination, &globalModSlot[1].amount,
+    &globalModSlot[2].source, &globalModSlot[2].destination, &globalModSlot[2].amount,
+    &globalModSlot[3].source, &globalModSlot[3].destination, &globalModSlot[3].amount,
     //Delay
     &delayDryWet, &delayFeedback, &delayTime, &delaySync, &delayDividend, &delayDivisor, &delayCutoff, &delayResonance, &delayTriplet, &delayDottedLength, &delayRecordFilter, &delayReverse, &delayActivation, &syncToggle,
     //Others
-    &freq, &masterAmp, &masterPan, &chorActivation, &chorActivation, &chorDelayLength, &chorDryWet, &chorModDepth, &chorModRate, &lowFiActivation, &nBitsLowFi, &clippingActivation, &clippingFactor,
+    &freq, &masterAmp, &masterPan, &chorActivation, &chorDelayLength, &chorDryWet, &chorModDepth, &chorModRate, &lowFiActivation, &nBitsLowFi, &clippingActivation, &clippingFactor,
+    //Reverb
+    &revSize, &revDecay, &revDamping, &revPredelay, &revDryWet, &revActivation,
+    //Convolution
+    &convDryWet, &convActivation,
+    //FX order
+    &fxSlot0, &fxSlot1, &fxSlot2, &fxSlot3, &fxSlot4, &fxSlot5,
     //Sections
-    &oscSection, &envSection, &lfoSection, &filterSection, &fxSection, &seqSection
+    &oscSection, &envSection, &lfoSection, &filterSection, &fxSection, &seqSection, &arpSection, &modSlotsSection
     }
     , stepSeqParams{ &seqPlaySyncHost, &seqPlayMode, &seqNumSteps, &seqStepSpeed, &seqStepLength, &seqTriplets, &seqDottedLength, &seqStep0, &seqStep1, &seqStep2, &seqStep3, &seqStep4, &seqStep5, &seqStep6, &seqStep7,
     &seqStepActive0, &seqStepActive1, &seqStepActive2, &seqStepActive3, &seqStepActive4, &seqStepActive5, &seqStepActive6, &seqStepActive7, &seqRandomMin, &seqRandomMax }
-    // section states
-    , oscSection("oscillator section", "oscSection", "oscillator section", eSectionState::eExpanded, sectionStateNames)
-    , envSection("envelopes section", "envSection", "envelopes section", eSectionState::eCollapsed, sectionStateNames)
-    , lfoSection("lfo section", "lfoSection", "lfo section", eSectionState::eCollapsed, sectionStateNames)
-    , filterSection("filter section", "filterSection", "filter section", eSectionState::eCollapsed, sectionStateNames)
-    , fxSection("fx section", "fxSection", "fx section", eSectionState::eCollapsed, sectionStateNames)
-    , seqSection("sequencer section", "seqSection", "sequencer section", eSectionState::eCollapsed, sectionStateNames)
-    , masterAmp("master amp", "masterAmp", "Master amp", "dB", -96.f, 12.f, -6.f)
-    , masterPan("master pan", "masterPan", "Master pan", "%", -100.f, 100.f, 0.f)
-    , freq("main freq", "freq", "freq", "Hz", 220.f, 880.f, 440.f)
-    // FX
-    , delayDryWet("dry/wet", "delWet", "Delay dry/wet", "", 0.f, 1.f, 0.f)
-    , delayFeedback("feedback", "delFeed", "Delay feedback", "", 0.f, 1.f, 0.f)
-    , delayTime("time", "delTime", "Delay time", "ms", 1., 20000., 1000.)
-    , delaySync("Tempo Sync", "delSync", "Delay sync", eOnOffToggle::eOff, onoffnames)
-    , delayDividend("SyncDel Dividend", "delDivd", "Delay dividend", "", 1, 5, 1)
-    , delayDivisor("SyncDel Divisor", "delDivs", "Delay divisor", "", 1, 64, 4)
-    , delayCutoff("lp cutoff", "delCut", "Delay cutoff", "Hz", 40.f, 20000.f, 20000.f)
-    , delayResonance("resonance", "delRes", "Delay resonance", "dB", -25.f, 0.f, 0.f)
-    , delayTriplet("Delay Triplet", "delTrip", "Delay triplet", eOnOffToggle::eOff, onoffnames)
-    , delayDottedLength("Delay Dotted Length", "delDot", "Delay dotted length", eOnOffToggle::eOff, onoffnames)
-    , delayRecordFilter("Delay Record", "delRec", "Delay record filter", eOnOffToggle::eOff, onoffnames)
-    , delayReverse("Delay Reverse", "delRev", "Delay reverse", eOnOffToggle::eOff, onoffnames)
-    , delayActivation("Delay Activation", "delayActivation", "Delay Active", eOnOffToggle::eOff, onoffnames)
-    , syncToggle("Delay Sync", "syncToggle", "Sync Toggle", eOnOffToggle::eOff, onoffnames)
-    , lowFiActivation("Activation", "lowFiActivation", "LowFi Active", eOnOffToggle::eOff, onoffnames)
-    , nBitsLowFi("bit degr.", "nBitsLowFi", "Number Bits", "bit", 1.f, 16.f, 16.f)
-    , chorDelayLength("width", "chorWidth", "Chorus Width", "s", .02f, .08f, .05f)
-    , chorModRate("rate", "chorRate", "Chorus Rate", "Hz", 0.f, 1.5f, 0.5f)
-    , chorDryWet("dry/wet", "ChorAmount", "Chorus Dry/Wet", "", 0.f, 1.f, 0.f)
-    , chorModDepth("depth", "ChorDepth", "Chorus Depth", "ms", 1.f, 20.f, 15.f)
-    , chorActivation("Activation", "chorActivation", "Chorus Active", eOnOffToggle::eOff, onoffnames)
-    , clippingFactor("clipping", "clippingFactor", "Clipping", "dB", 0.f, 25.f, 0.0f)
-    , clippingActivation("Activation", "clippingActivation", "Clipping Active", eOnOffToggle::eOff, onoffnames)
-    // sequencer
-    , seqPlaceHolder("Placeholder", "seqPlaceholder", "SeqPlaceholder", "", 0.0f, 127.0f, 126.0f)
-    , seqPlayNoHost("Play No Host", "seqPlayNoHost", "seqPlayNoHost", eOnOffToggle::eOff, onoffnames)
-    , seqPlaySyncHost("Play Sync Host", "seqPlaySyncHost", "seqPlaySyncHost", eOnOffToggle::eOff, onoffnames)
-    , seqPlayMode("SeqPlayMode", "seqPlayMode", "SeqPlayMode", eSeqPlayModes::eSequential, seqPlayModeNames)
-    , seqLastPlayedStep("Last Played Step", "lastPlayedStep", "Last Played Step", "", 0.0f, 7.0f, 0.0f)
-    , seqNumSteps("Steps", "seqNumSteps", "Steps", "", 1.0f, 8.0f, 8.0f)
-    , seqStepSpeed("Speed", "seqStepSpeed", "Speed", "", 1.0f, 64.0f, 4.0f)
-    , seqStepLength("Length", "seqNoteLength", "Length", "", 1.0f, 64.0f, 4.0f)
-    , seqTriplets("Seq Triplets", "seqTriplets", "Seq Triplets", eOnOffToggle::eOff, onoffnames)
-    , seqDottedLength("Seq Dotted Length", "seqDottedLength", "Seq Dotted Length", eOnOffToggle::eOff, onoffnames)
-    , seqRandomMin("Min", "seqRandomMin", "Min", "", 0.0f, 127.0f, 0.0f)
-    , seqRandomMax("Max", "seqRandomMax", "Max", "", 0.0f, 127.0f, 127.0f)
-    , seqStep0("Step 0", "seqNote0", "Step 0", "", 0.0f, 127.0f, 60.0f)
-    , seqStep1("Step 1", "seqNote1", "Step 1", "", 0.0f, 127.0f, 62.0f)
-    , seqStep2("Step 2", "seqNote2", "Step 2", "", 0.0f, 127.0f, 64.0f)
-    , seqStep3("Step 3", "seqNote3", "Step 3", "", 0.0f, 127.0f, 65.0f)
-    , seqStep4("Step 4", "seqNote4", "Step 4", "", 0.0f, 127.0f, 67.0f)
-    , seqStep5("Step 5", "seqNote5", "Step 5", "", 0.0f, 127.0f, 69.0f)
-    , seqStep6("Step 6", "seqNote6", "Step 6", "", 0.0f, 127.0f, 71.0f)
-    , seqStep7("Step 7", "seqNote7", "Step 7", "", 0.0f, 127.0f, 72.0f)
-    , seqStepActive0("Step 0 Active", "seqStepActive0", "Step 0 Active", eOnOffToggle::eOn, onoffnames)
-    , seqStepActive1("Step 1 Active", "seqStepActive1", "Step 1 Active", eOnOffToggle::eOn, onoffnames)
-    , seqStepActive2("Step 2 Active", "seqStepActive2", "Step 2 Active", eOnOffToggle::eOn, onoffnames)
-    , seqStepActive3("Step 3 Active", "seqStepActive3", "Step 3 Active", eOnOffToggle::eOn, onoffnames)
-    , seqStepActive4("Step 4 Active", "seqStepActive4", "Step 4 Active", eOnOffToggle::eOn, onoffnames)
-    , seqStepActive5("Step 5 Active", "seqStepActive5", "Step 5 Active", eOnOffToggle::eOn, onoffnames)
-    , seqStepActive6("Step 6 Active", "seqStepActive6", "Step 6 Active", eOnOffToggle::eOn, onoffnames)
-    , seqStepActive7("Step 7 Active", "seqStepActive7", "Step 7 Active", eOnOffToggle::eOn, onoffnames)
+    , presetLibrary(std::array<const Param*, PresetLibrary::nKeyParams>{ { &osc[0].waveForm, &filter[0].lpCutoff, &envVol[0].attack, &envVol[0].release } })
     //Others
     , positionIndex(0)
 {    
@@ -168,100 +447,139 @@ SynthParams::SynthParams()
 
     filter[0].setName("filter 1");
     filter[1].setName("filter 2");
+
+    globalLfo[0].setName("glfo 1");
+    globalLfo[1].setName("glfo 2");
+
+    globalModSlot[0].setName("gmod 1");
+    globalModSlot[1].setName("gmod 2");
+    globalModSlot[2].setName("gmod 3");
+    globalModSlot[3].setName("gmod 4");
+
+    // params beyond capacity share a single spare slot and change each other
+    jassert(store.size() <= ParamStore::capacity);
+
+#if JUCE_DEBUG
+    // the ids end up in patches and host projects, they must be unique
+    StringArray ids;
+    for (const Param* p : serializeParams) {
+        jassert(!ids.contains(p->getID()));
+        ids.add(p->getID());
+    }
+#endif
 }
 
-SynthParams::Osc::Osc()
-    : fine("fine", "fine", "f.tune", "ct", -100.f, 100.f, 0.f)
-    , coarse("coarse", "coarse", "c.tune", "st", -36.f, 36.f, 0.f)
-    , trngAmount("triangle", "trngAmount", "triangle amount", "", 0.0f, 1.0f, 0.0f)
-    , pulseWidth("width", "pulseWidth", "pulsewidth", "", 0.01f, 0.99f, 0.5f)
-    , waveForm("Waveform", "oscWaveform", "Waveform", eOscWaves::eOscSquare, waveformNames)
-    , panDir("pan", "panDir", "pan direction", "%", -100.f, 100.f, 0.f)
-    , vol("gain", "vol", "Vol", "dB", -96.f, 12.f, -6.f)
+SynthParams::Osc::Osc(ParamStore &store)
+    : fine(store, descriptors::osc::fine)
+    , coarse(store, descriptors::osc::coarse)
+    , trngAmount(store, descriptors::osc::trngAmount)
+    , pulseWidth(store, descriptors::osc::pulseWidth)
+    , waveForm(store, descriptors::osc::waveForm)
+    , panDir(store, descriptors::osc::panDir)
+    , vol(store, descriptors::osc::vol)
     // ModAmounts and ModSources
-    , panModAmount1("PanModAmount1", "OSCPanModAmount1", "Pan ModAmount 1", "%", 0.f, 200.f, 100.f)
-    , panModAmount2("PanModAmount2", "OSCPanModAmount2", "Pan ModAmount 2", "%", 0.f, 200.f, 100.f)
-    , panModSrc1("PanModSrc1", "OSCPanModSrc1", "Pan ModSource 1", eModSource::eNone, modsourcenames)
-    , panModSrc2("PanModSrc2", "OSCPanModSrc2", "Pan ModSource 2", eModSource::eNone, modsourcenames)
-    , shapeModAmount1("ShapeModAmount1", "OSCShapeModAmount1", "Shape ModAmount 1", "", 0.f, 1.f, 0.5f)
-    , shapeModAmount2("ShapeModAmount2", "OSCShapeModAmount2", "Shape ModAmount 2", "", 0.f, 1.f, 0.5f)
-    , shapeModSrc1("ShapeModSrc1", "OSCShapeModSrc1", "Shape ModSource 1", eModSource::eNone, modsourcenames)
-    , shapeModSrc2("ShapeModSrc2", "OSCShapeModSrc2", "Shape ModSource 2", eModSource::eNone, modsourcenames)
-    , pitchModAmount1("PitchModAmount1", "OSCPitchModAmount1", "Pitch ModAmount 1", "st", 0.f, 48.f, 24.f)
-    , pitchModAmount2("PitchModAmount2", "OSCPitchModAmount2", "Pitch ModAmount 2", "st", 0.f, 48.f, 24.f)
-    , pitchModSrc1("PitchModSrc1", "OSCPitchModSrc1", "Pitch ModSource 1", eModSource::eNone, modsourcenames)
-    , pitchModSrc2("PitchModSrc2", "OSCPitchModSrc2", "Pitch ModSource 2", eModSource::eNone, modsourcenames)
-    , gainModAmount1("GainModAmount1", "OSCGainModAmount1", "Gain ModAmount 1", "dB", 0.f, 96.f, 48.0f)
-    , gainModAmount2("GainModAmount2", "OSCGainModAmount2", "Gain ModAmount 2", "dB", 0.f, 96.f, 48.0f)
-    , gainModSrc1("GainModSrc1", "GainModSrc1", "Gain ModSource 1", eModSource::eNone, modsourcenames)
-    , gainModSrc2("GainModSrc2", "GainModSrc2", "Gain ModSource 2", eModSource::eNone, modsourcenames)
-    , oscActivation("Activation", "Activation", "Active", eOnOffToggle::eOn, onoffnames)
+    , panModAmount1(store, descriptors::osc::panModAmount1)
+    , panModAmount2(store, descriptors::osc::panModAmount2)
+    , panModSrc1(store, descriptors::osc::panModSrc1)
+    , panModSrc2(store, descriptors::osc::panModSrc2)
+    , shapeModAmount1(store, descriptors::osc::shapeModAmount1)
+    , shapeModAmount2(store, descriptors::osc::shapeModAmount2)
+    , shapeModSrc1(store, descriptors::osc::shapeModSrc1)
+    , shapeModSrc2(store, descriptors::osc::shapeModSrc2)
+    , pitchModAmount1(store, descriptors::osc::pitchModAmount1)
+    , pitchModAmount2(store, descriptors::osc::pitchModAmount2)
+    , pitchModSrc1(store, descriptors::osc::pitchModSrc1)
+    , pitchModSrc2(store, descriptors::osc::pitchModSrc2)
+    , gainModAmount1(store, descriptors::osc::gainModAmount1)
+    , gainModAmount2(store, descriptors::osc::gainModAmount2)
+    , gainModSrc1(store, descriptors::osc::gainModSrc1)
+    , gainModSrc2(store, descriptors::osc::gainModSrc2)
+    , oscActivation(store, descriptors::osc::oscActivation)
+    , volRamp(vol)
+    , panDirRamp(panDir)
+    , pulseWidthRamp(pulseWidth)
 {
 }
 
-SynthParams::EnvBase::EnvBase()
-    : attack("att.", "envAttack", "attack", "s", 0.001f, 5.0f, 0.005f)
-    , release("rel.", "envRelease", "release", "s", 0.001f, 5.0f, 0.5f)
-    , attackShape("Attack Shape", "envAttackShape", "attack shape", "", 0.01f, 10.0f, 1.0f)
-    , decayShape("Decay Shape", "envDecayShape", "decay shape", "", 0.01f, 10.0f, 1.0f)
-    , releaseShape("Release Shape", "envReleaseShape", "release shape", "", 0.01f, 10.0f, 1.0f)
-    , decay("dec.", "envDecay", "decay", "s", 0.001f, 5.0f, 0.05f)
+SynthParams::EnvBase::EnvBase(ParamStore &store)
+    : attack(store, descriptors::env::attack)
+    , release(store, descriptors::env::release)
+    , attackShape(store, descriptors::env::attackShape)
+    , decayShape(store, descriptors::env::decayShape)
+    , releaseShape(store, descriptors::env::releaseShape)
+    , decay(store, descriptors::env::decay)
     // ModAmounts and Sources
-    , speedModAmount1("ENV SpeedModAmount1", "ENVSpeedModAmount1", "Speed ModAmount 1", "", 0.f, 8.f, 4.f)
-    , speedModAmount2("ENV SpeedModAmount2", "ENVSpeedModAmount2", "Speed ModAmount 2", "", 0.f, 8.f, 4.f)
-    , speedModSrc1("ENV Speed ModSrc1", "ENVSpeedModSrc1", "Speed ModSource 1", eModSource::eNone, modsourcenames)
-    , speedModSrc2("ENV Speed ModSrc2", "ENVSpeedModSrc2", "Speed ModSource 2", eModSource::eNone, modsourcenames)
+    , speedModAmount1(store, descriptors::env::speedModAmount1)
+    , speedModAmount2(store, descriptors::env::speedModAmount2)
+    , speedModSrc1(store, descriptors::env::speedModSrc1)
+    , speedModSrc2(store, descriptors::env::speedModSrc2)
 {
 }
 
-SynthParams::EnvVol::EnvVol()
-    : EnvBase()
-    , sustain("sust.", "envSustain", "sustain", "dB", -96.f, 0.f, -6.f)
+SynthParams::EnvVol::EnvVol(ParamStore &store)
+    : EnvBase(store)
+    , sustain(store, descriptors::envVol::sustain)
 {
 }
 
-SynthParams::Env::Env()
-:  EnvBase()
-    , sustain("sust.", "envSustain", "sustain", "", 0.f, 1.f, 1.f)
+SynthParams::Env::Env(ParamStore &store)
+:  EnvBase(store)
+    , sustain(store, descriptors::env::sustain)
 {
 }
 
-SynthParams::Lfo::Lfo()
-    : freq("freq", "lfo1freq", "freq", "Hz", .01f, 50.f, 1.f)
-    , wave("Wave", "lfo1wave", "waveform", eLfoWaves::eLfoSine, lfowavenames)
-    , tempSync("TempoSync", "tempoSyncSwitch", "TempoSync", eOnOffToggle::eOff, onoffnames)
-    , lfoTriplets("Lfo Triplet", "lfoTriplet", "Lfo Triplet", eOnOffToggle::eOff, onoffnames)
-    , lfoDottedLength("Lfo Dotted Note Length", "lfoDottedLength", "Lfo Dotted Length", eOnOffToggle::eOff, onoffnames)
-    , noteLength("Note Length", "notelength", "Note Length", "", 1.f, 64.f, 4.f)
-    , fadeIn("fade-in", "lfoFadein", "fade-in", "s", 0.f, 10.f, 0.f)
+SynthParams::Lfo::Lfo(ParamStore &store)
+    : freq(store, descriptors::lfo::freq)
+    , wave(store, descriptors::lfo::wave)
+    , tempSync(store, descriptors::lfo::tempSync)
+    , lfoTriplets(store, descriptors::lfo::lfoTriplets)
+    , lfoDottedLength(store, descriptors::lfo::lfoDottedLength)
+    , noteLength(store, descriptors::lfo::noteLength)
+    , fadeIn(store, descriptors::lfo::fadeIn)
     // ModAmounts and Sources
-    , freqModAmount1("FreqModAmount1", "LFOFreqModAmount1", "Freq ModAmount 1", "oct", 0.f, 10.f, 5.0f)
-    , freqModAmount2("FreqModAmount2", "LFOFreqModAmount2", "Freq ModAmount 2", "oct", 0.f, 10.f, 5.0f)
-    , freqModSrc1("FreqModSrc1", "LFOFreqModSrc1", "Freq ModSource 1", eModSource::eNone, modsourcenames)
-    , freqModSrc2("FreqModSrc2", "LFOFreqModSrc2", "Freq ModSource 2", eModSource::eNone, modsourcenames)
-    , gainModSrc("GainModSrc", "LFOGainModSrc", "Gain ModSource", eModSource::eNone, modsourcenames)
+    , freqModAmount1(store, descriptors::lfo::freqModAmount1)
+    , freqModAmount2(store, descriptors::lfo::freqModAmount2)
+    , freqModSrc1(store, descriptors::lfo::freqModSrc1)
+    , freqModSrc2(store, descriptors::lfo::freqModSrc2)
+    , gainModSrc(store, descriptors::lfo::gainModSrc)
 {
 }
 
-SynthParams::Filter::Filter()
-    : passtype("Type", "FILTERType", "Type", eBiquadFilters::eLowpass, biquadFilters)
-    , lpCutoff("LPcutoff", "lpCutoff", "LP Cutoff", "Hz", 10.f, 20000.f, 20000.f)
-    , hpCutoff("HPcutoff", "hpCutoff", "HP Cutoff", "Hz", 10.f, 20000.f, 10.f)
-    , resonance("reson.", "FILTERResonance", "Resonance", "", 0.f, 10.f, 0.f)
+SynthParams::GlobalLfo::GlobalLfo(ParamStore &store)
+    : freq(store, descriptors::globalLfo::freq)
+    , wave(store, descriptors::globalLfo::wave)
+{
+}
+
+SynthParams::GlobalModSlot::GlobalModSlot(ParamStore &store)
+    : source(store, descriptors::globalModSlot::source)
+    , destination(store, descriptors::globalModSlot::destination)
+    , amount(store, descriptors::globalModSlot::amount)
+{
+}
+
+SynthParams::Filter::Filter(ParamStore &store)
+    : passtype(store, descriptors::filter::passtype)
+    , lpCutoff(store, descriptors::filter::lpCutoff)
+    , hpCutoff(store, descriptors::filter::hpCutoff)
+    , resonance(store, descriptors::filter::resonance)
     // ModAmounts and ModSources
-    , lpModAmount1("Lc ModAmount1", "FILTERLcModAmount1", "Lc ModAmount 1", "oct", 0.f, 10.f, 5.f)
-    , lpModAmount2("Lc ModAmnout2", "FILTERLcModAmount2", "Lc ModAmount 2", "oct", 0.f, 10.f, 5.f)
-    , hpModAmount1("Hc ModAmount1", "FILTERHcModAmount1", "Hc ModAmount 1", "oct", 0.f, 8.f, 4.f)
-    , hpModAmount2("Hc ModAmount2", "FILTERHcModAmount2", "Hc ModAmount 2", "oct", 0.f, 8.f, 4.f)
-    , resModAmount1("Res ModAmount1", "FILTERResModAmount1", "Res ModAmount 1", "", 0.f, 10.f, 5.f)
-    , resModAmount2("Res ModAmount2", "FILTERResModAmount2", "Res ModAmount 2", "", 0.f, 10.f, 5.f)
-    , lpCutModSrc1("Lc ModSrc1", "FILTERLcModSrc1", "Lc ModSource 1", eModSource::eNone, modsourcenames)
-    , lpCutModSrc2("Lc ModSrc2", "FILTERLcModSrc2", "Lc ModSource 2", eModSource::eNone, modsourcenames)
-    , hpCutModSrc1("Hc ModSrc1", "FILTERHcModSrc1", "Hc ModSource 1", eModSource::eNone, modsourcenames)
-    , hpCutModSrc2("Hc ModSrc2", "FILTERHcModSrc2", "Hc ModSource 2", eModSource::eNone, modsourcenames)
-    , resonanceModSrc1("Res ModSrc1", "FILTERResModSrc1", "Res ModSource 1", eModSource::eNone, modsourcenames)
-    , resonanceModSrc2("Res ModSrc2", "FILTERResModSrc2", "Res ModSource 2", eModSource::eNone, modsourcenames)
-    , filterActivation("Filter Activation", "filterActivation", "LowFi Active", eOnOffToggle::eOff, onoffnames)
+    , lpModAmount1(store, descriptors::filter::lpModAmount1)
+    , lpModAmount2(store, descriptors::filter::lpModAmount2)
+    , hpModAmount1(store, descriptors::filter::hpModAmount1)
+    , hpModAmount2(store, descriptors::filter::hpModAmount2)
+    , resModAmount1(store, descriptors::filter::resModAmount1)
+    , resModAmount2(store, descriptors::filter::resModAmount2)
+    , lpCutModSrc1(store, descriptors::filter::lpCutModSrc1)
+    , lpCutModSrc2(store, descriptors::filter::lpCutModSrc2)
+    , hpCutModSrc1(store, descriptors::filter::hpCutModSrc1)
+    , hpCutModSrc2(store, descriptors::filter::hpCutModSrc2)
+    , resonanceModSrc1(store, descriptors::filter::resonanceModSrc1)
+    , resonanceModSrc2(store, descriptors::filter::resonanceModSrc2)
+    , filterActivation(store, descriptors::filter::filterActivation)
+    , lpCutoffRamp(lpCutoff, ParamRamp::eMode::eMultiplicative)
+    , hpCutoffRamp(hpCutoff, ParamRamp::eMode::eMultiplicative)
+    , resonanceRamp(resonance)
 {
 }
 
@@ -275,6 +593,9 @@ void SynthParams::writeXMLPatchTree(XmlElement* patch, eSerializationParams para
     // set version of the patch
     patch->setAttribute("version", version);
     patch->setAttribute("patchname", patchName);
+    if (paramsToSerialize == eSerializationParams::eAll) {
+        patch->setAttribute("convIr", convIrPath);
+    }
 
     std::vector<Param*> parameters = serializeParams;
     if (paramsToSerialize == eSerializationParams::eSequencerOnly)
@@ -286,10 +607,30 @@ void SynthParams::writeXMLPatchTree(XmlElement* patch, eSerializationParams para
     for (auto &param : parameters) {
         float value = param->getUI();
         if (param->serializationTag() != "") {
-            String prefixedName = (param->prefix() + param->serializationTag()).replace(" ", "");
-            addElement(patch, prefixedName, value);
+            addElement(patch, param->getID(), value);
     }
 }
+
+    updateSeqPattern();
+    XmlElement* pattern = new XmlElement(seqPatternTag);
+    pattern->setAttribute("data", seqPattern.toBase64());
+    patch->addChildElement(pattern);
+
+    if (paramsToSerialize == eSerializationParams::eAll) {
+        patch->addChildElement(modSlots.createXml(modSlotsTag));
+    }
+}
+
+void SynthParams::updateSeqPattern() {
+    const Param* notes[] = { &seqStep0, &seqStep1, &seqStep2, &seqStep3, &seqStep4, &seqStep5, &seqStep6, &seqStep7 };
+    const ParamStepped<eOnOffToggle>* active[] = { &seqStepActive0, &seqStepActive1, &seqStepActive2, &seqStepActive3,
+                                                   &seqStepActive4, &seqStepActive5, &seqStepActive6, &seqStepActive7 };
+    for (int i = 0; i < 8; ++i) {
+        seqPattern.setValue(i, SeqPattern::eNote, static_cast<int>(notes[i]->get()));
+        if (seqPattern.isActive(i) != (active[i]->getStep() == eOnOffToggle::eOn)) {
+            seqPattern.setActive(i, active[i]->getStep() == eOnOffToggle::eOn);
+        }
+    }
 }
 
 // TODO: add more diverse colours, note that what if lfo modulates lfo? -> same colour, currently draw saturn with saturation
@@ -306,6 +647,8 @@ Colour SynthParams::getModSourceColour(eModSource source)
         case eModSource::eLFO2:
         case eModSource::eLFO3:
             return SynthParams::lfoColour.withSaturation(1.0f).brighter(0.8f);
+        case eModSource::eSeqMod:
+            return SynthParams::stepSeqColour.withSaturation(1.0f).brighter();
         default:
             return SynthParams::otherModulation;
 }
@@ -326,7 +669,7 @@ void SynthParams::writeXMLPatchStandalone(eSerializationParams paramsToSerialize
 
     // create the output
     FileChooser saveDirChooser("Please select the place you want to save!", 
-        File::getSpecialLocation(File::commonDocumentsDirectory).getChildFile("Synister").getChildFile(patchName), "*.xml");
+        PresetLibrary::getPresetDirectory().getChildFile(patchName), "*.xml");
     if (saveDirChooser.browseForFileToSave(true))
     {
         File saveFile(saveDirChooser.getResult());
@@ -342,18 +685,6 @@ void SynthParams::writeXMLPatchStandalone(eSerializationParams paramsToSerialize
 }
 
 
-// adds the value if it exists in the xml
-void SynthParams::fillValueIfExists(XmlElement* patch, String paramName, Param& param) {
-    String prefixedName = (param.prefix() + param.serializationTag()).replace(" ", "");
-    if (patch->getChildByName(prefixedName) != NULL) {
-        param.setUI(static_cast<float>(patch->getChildByName(prefixedName)->getDoubleAttribute("value")));
-        //! \todo dirty flag needs to be set! This is a bad hack, please use get/set instead of getUI/setUI
-        param.set(param.get(),true);
-        //param.set(static_cast<float>(patch->getChildByName(paramName)->getDoubleAttribute("value")), true); // NOTE: needed at least for seq standalone and envShape params but then at least
-                                                                                                            // delay feedback and dry are bad and (ampVol sometimes); not further tested
-    }
-}
-
 // set all values from xml file in params
 void SynthParams::fillValues(XmlElement* patch, eSerializationParams paramsToSerialize) {
     // if the versions don't align, inform the user
@@ -364,23 +695,188 @@ void SynthParams::fillValues(XmlElement* patch, eSerializationParams paramsToSer
             "OK");
     }
 
-    std::vector<Param*> parameters = serializeParams;
-    if (paramsToSerialize == eSerializationParams::eSequencerOnly)
-    {
-        parameters = stepSeqParams;
-    }
-
     patchName = patch->getStringAttribute("patchname");
     patchNameDirty = true;
 
-    // iterate over all params and set the values if they exist in the xml
+    // a patch without impulse response clears the current one
+    if (paramsToSerialize == eSerializationParams::eAll && patch->getStringAttribute("convIr") != convIrPath) {
+        loadImpulseResponse(patch->getStringAttribute("convIr"));
+    }
+
+    applyPatch(decodeXMLPatch(*patch, paramsToSerialize));
+}
+
+PatchSnapshot* SynthParams::decodeXMLPatch(const XmlElement& patch, eSerializationParams paramsToSerialize) {
+    const std::vector<Param*>& parameters = paramsToSerialize == eSerializationParams::eSequencerOnly ? stepSeqParams : serializeParams;
+
+    // index the elements once, looking each param up by name would be quadratic
+    HashMap<String, XmlElement*> elements(2 * static_cast<int>(parameters.size()) + 1);
+    forEachXmlChildElement(patch, e) {
+        elements.set(e->getTagName(), e);
+    }
+
+    // iterate over all params and take the values that exist in the xml
+    PatchSnapshot* snapshot = new PatchSnapshot(static_cast<int>(parameters.size()));
     for (auto &param : parameters) {
         if (param->serializationTag() != "") {
-        fillValueIfExists(patch, param->serializationTag(), *param);
+            const String id = param->getID();
+            if (elements.contains(id)) {
+                snapshot->add(*param, static_cast<float>(elements[id]->getDoubleAttribute("value")));
+            }
+        }
+    }
+
+    // patches of older versions have no pattern, their steps are the defaults and the params
+    SeqPattern::Data pattern;
+    if (elements.contains(seqPatternTag)) {
+        SeqPattern::fromBase64(elements[seqPatternTag]->getStringAttribute("data"), pattern);
+    } else {
+        SeqPattern::getDefaultData(pattern);
+    }
+    snapshot->setPattern(seqPattern, pattern);
+
+    // a whole patch replaces all slots, patches without slots have none
+    if (paramsToSerialize == eSerializationParams::eAll) {
+        ModSlots::Data slots;
+        if (elements.contains(modSlotsTag)) {
+            ModSlots::fromXml(*elements[modSlotsTag], slots);
+        } else {
+            ModSlots::getEmptyData(slots);
+        }
+        snapshot->setModSlots(modSlots, slots);
     }
+    return snapshot;
+}
+
+void SynthParams::applyPatch(PatchSnapshot* snapshot) {
+    const ScopedPointer<PatchSnapshot> owner(snapshot);
+    snapshot->apply();
+    snapshot->notifyListeners();
+}
+
+uint32 SynthParams::hashId(const String& id) {
+    uint32 hash = 2166136261u;
+    for (const char* c = id.toRawUTF8(); *c != 0; ++c) {
+        hash = (hash ^ static_cast<uint8>(*c)) * 16777619u;
     }
+    return hash;
+}
 
+const std::vector<SynthParams::IdEntry>& SynthParams::getIdEntries() {
+    const ScopedLock lock(idEntriesLock);
+    if (idEntries.empty()) {
+        for (Param* p : serializeParams) {
+            if (p->serializationTag() != "") {
+                idEntries.push_back({ hashId(p->getID()), p });
+            }
+        }
+        sortedIdEntries = idEntries;
+        std::sort(sortedIdEntries.begin(), sortedIdEntries.end(),
+            [](const IdEntry& a, const IdEntry& b) { return a.idHash < b.idHash; });
+        // a collision would make one param shadow another, rename one of them
+        jassert(std::adjacent_find(sortedIdEntries.begin(), sortedIdEntries.end(),
+            [](const IdEntry& a, const IdEntry& b) { return a.idHash == b.idHash; }) == sortedIdEntries.end());
+    }
+    return idEntries;
 }
+
+namespace {
+    /* Binary patch layout, little endian:
+       magic, format version, program version, patch name, impulse response path,
+       number of entries, then per entry the ID hash and the UI value of the param,
+       since format 2 followed by the sequencer pattern, since format 3 by the user mod slots. */
+    const uint32 binaryPatchMagic = 0x424e5953; // "SYNB"
+    const uint32 binaryPatchFormat = 3;
+    const int binaryPatchEntrySize = sizeof(uint32) + sizeof(float);
+}
+
+void SynthParams::writeBinaryPatchHost(MemoryBlock& destData) {
+    const std::vector<IdEntry>& entries = getIdEntries();
+
+    destData.reset();
+    destData.ensureSize(static_cast<size_t>(64 + 2 * binaryPatchEntrySize * entries.size()));
+    MemoryOutputStream out(destData, false);
+    out.writeInt(static_cast<int>(binaryPatchMagic));
+    out.writeInt(static_cast<int>(binaryPatchFormat));
+    out.writeFloat(version);
+    out.writeString(patchName);
+    out.writeString(convIrPath);
+    out.writeInt(static_cast<int>(entries.size()));
+    for (const IdEntry& e : entries) {
+        out.writeInt(static_cast<int>(e.idHash));
+        out.writeFloat(e.param->getUI());
+    }
+    updateSeqPattern();
+    seqPattern.writeToStream(out);
+    modSlots.writeToStream(out);
+}
+
+bool SynthParams::readBinaryPatchHost(const void* data, int sizeInBytes) {
+    MemoryInputStream in(data, static_cast<size_t>(jmax(0, sizeInBytes)), false);
+    if (sizeInBytes < 8 || static_cast<uint32>(in.readInt()) != binaryPatchMagic) {
+        return false;
+    }
+    const uint32 format = static_cast<uint32>(in.readInt());
+    if (format > binaryPatchFormat) {
+        AlertWindow::showMessageBoxAsync(AlertWindow::WarningIcon, "Version Conflict",
+            "The project was saved by a newer version of the software, its settings are ignored.",
+            "OK");
+        return true;
+    }
+    if (in.readFloat() > version) {
+        AlertWindow::showMessageBoxAsync(AlertWindow::WarningIcon, "Version Conflict",
+            "The file was created by a newer version of the software, some settings may be ignored.",
+            "OK");
+    }
+
+    patchName = in.readString();
+    patchNameDirty = true;
+    // hosts restore the state on every undo step, reloading the same impulse response would reset its tail
+    const String irPath = in.readString();
+    if (irPath != convIrPath) {
+        loadImpulseResponse(irPath);
+    }
+
+    const std::vector<IdEntry>& entries = getIdEntries();
+    // never trust the count more than the data
+    const int numEntries = jmin(in.readInt(), static_cast<int>(in.getNumBytesRemaining() / binaryPatchEntrySize));
+    PatchSnapshot* snapshot = new PatchSnapshot(jmax(0, numEntries));
+    for (int i = 0; i < numEntries; ++i) {
+        const uint32 idHash = static_cast<uint32>(in.readInt());
+        const float value = in.readFloat();
+
+        Param* param = nullptr;
+        if (i < static_cast<int>(entries.size()) && entries[i].idHash == idHash) {
+            param = entries[i].param;
+        } else {
+            // params were added or reordered since the state was saved
+            const auto found = std::lower_bound(sortedIdEntries.begin(), sortedIdEntries.end(), idHash,
+                [](const IdEntry& e, uint32 h) { return e.idHash < h; });
+            if (found != sortedIdEntries.end() && found->idHash == idHash) {
+                param = found->param;
+            }
+        }
+        // entries of removed params are skipped
+        if (param != nullptr) {
+            snapshot->add(*param, value);
+        }
+    }
+
+    SeqPattern::Data pattern;
+    if (format < 2 || !SeqPattern::readFromStream(in, pattern)) {
+        SeqPattern::getDefaultData(pattern);
+    }
+    snapshot->setPattern(seqPattern, pattern);
+
+    ModSlots::Data slots;
+    if (format < 3 || !ModSlots::readFromStream(in, slots)) {
+        ModSlots::getEmptyData(slots);
+    }
+    snapshot->setModSlots(modSlots, slots);
+    applyPatch(snapshot);
+    return true;
+}
+
 void SynthParams::readXMLPatchHost(const void* data, int sizeInBytes, eSerializationParams paramsToSerialize) {
     ScopedPointer<XmlElement> patch = AudioProcessor::getXmlFromBinary(data, sizeInBytes);
     fillValues(patch, paramsToSerialize);
@@ -389,17 +885,24 @@ void SynthParams::readXMLPatchHost(const void* data, int sizeInBytes, eSerializa
 void SynthParams::readXMLPatchStandalone(eSerializationParams paramsToSerialize) {
     // read the xml params into the synth params
     FileChooser openFileChooser("Please select the patch you want to read!", 
-        File::getSpecialLocation(File::commonDocumentsDirectory).getChildFile("Synister"), "*.xml");
+        PresetLibrary::getPresetDirectory(), "*.xml");
     if (openFileChooser.browseForFileToOpen()) {
-        File openedFile(openFileChooser.getResult());
-        ScopedPointer<XmlElement> patch = XmlDocument::parse(openedFile);
-        fillValues(patch, paramsToSerialize);
+        readXMLPatchFile(openFileChooser.getResult(), paramsToSerialize);
     }
 }
 
+void SynthParams::readXMLPatchFile(const File& file, eSerializationParams paramsToSerialize) {
+    ScopedPointer<XmlElement> patch = XmlDocument::parse(file);
+    fillValues(patch, paramsToSerialize);
+}
+
 SynthParams::~SynthParams() {
 }
 
+void SynthParams::loadImpulseResponse(const String& path) {
+    convIrPath = path;
+}
+
 const char * SynthParams::getModSrcName(int index)
 {
     if (index >= 0 && index < static_cast<int>(eModSource::nSteps)) {
@@ -409,6 +912,14 @@ const char * SynthParams::getModSrcName(int index)
     }
 }
 
+const char * SynthParams::getModDestName(int index)
+{
+    if (index >= 0 && index < static_cast<int>(MAX_DESTINATIONS)) {
+        return moddestnames[index];
+    } else {
+        return "None";
+    }
+}
 
 String SynthParams::getShortModSrcName(int index)
 {
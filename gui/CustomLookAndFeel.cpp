@@ -78,6 +78,12 @@ void CustomLookAndFeel::drawRotarySlider(Graphics &g, int x, int y, int width, i
             }
         }
 
+        // draw the modulated value of the newest voice across the saturns
+        if (static_cast<MouseOverKnob&>(s).hasLiveModulation())
+        {
+            drawLiveModulation(g, static_cast<MouseOverKnob&>(s), centreX, centreY, radiusKnob, radiusSource2, rotaryStartAngle, rotaryEndAngle);
+        }
+
         // draw knob border
         g.setColour(s.isEnabled() ? Colours::white : Colours::white.withAlpha(0.5f));
         knob.addEllipse(centreX - radiusKnob, centreY - radiusKnob, radiusKnob * 2.0f, radiusKnob * 2.0f);
@@ -168,6 +174,24 @@ void CustomLookAndFeel::drawModSource(Graphics &g, eModSource source, MouseOverK
     g.fillPath(saturn);
 }
 
+void CustomLookAndFeel::drawLiveModulation(Graphics &g, MouseOverKnob &s, float centreX, float centreY,
+    float innerRadius, float outerRadius, float rotaryStartAngle, float rotaryEndAngle)
+{
+    const float val = static_cast<float>(s.getLiveModulatedValue());
+    const float min = static_cast<float>(s.getMinimum());
+    const float max = static_cast<float>(s.getMaximum());
+    const float skew = static_cast<float>(s.getSkewFactor());
+
+    const float modPosition = std::pow((val - min) / (max - min), skew);
+    const float modAngle = rotaryStartAngle + modPosition * (rotaryEndAngle - rotaryStartAngle);
+    const float markerWidth = float_Pi / 36.0f;
+
+    Path marker;
+    g.setColour(s.isEnabled() ? Colours::white : Colours::white.withAlpha(0.5f));
+    marker.addPieSegment(centreX - outerRadius, centreY - outerRadius, outerRadius * 2.0f, outerRadius * 2.0f, modAngle - markerWidth, modAngle + markerWidth, innerRadius / outerRadius);
+    g.fillPath(marker);
+}
+
 void CustomLookAndFeel::drawLinearSlider(Graphics &g, int x, int y, int width, int height, float sliderPos, float minSliderPos, float maxSliderPos, const Slider::SliderStyle style, Slider &s)
 {
     // use bar slider to draw vol and pan instead
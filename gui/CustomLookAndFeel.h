@@ -158,6 +158,7 @@ private:
     @param rotaryEndAngle slider's maximum angle position
     */
     void drawModSource(Graphics &g, eModSource source, MouseOverKnob &s, Param *modAmount, float centreX, float centreY, float radius, float innerCircleSize, float currAngle, float rotaryStartAngle, float rotaryEndAngle);
+    void drawLiveModulation(Graphics &g, MouseOverKnob &s, float centreX, float centreY, float innerRadius, float outerRadius, float rotaryStartAngle, float rotaryEndAngle);
 };
 
 #endif  // CUSTOMLOOKANDFEEL_H_INCLUDED
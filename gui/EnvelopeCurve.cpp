@@ -74,6 +74,15 @@ void EnvelopeCurve::setReleaseShape(float releaseShape)
     releaseShape_ = releaseShape;
 }
 
+void EnvelopeCurve::setLevel(float level)
+{
+    if (level != level_)
+    {
+        level_ = level;
+        repaint();
+    }
+}
+
 float EnvelopeCurve::getEnvCoef()
 {
     float envCoeff;
@@ -175,6 +184,14 @@ void EnvelopeCurve::paint (Graphics& g)
     g.setColour(SynthParams::envelopeCurveLine);
     g.strokePath(curvePath, PathStrokeType(2.5f));
 
+    // level of the newest voice
+    if (level_ >= 0.f)
+    {
+        const float levelY = getHeight() * (1.013f - level_);
+        g.setColour(Colours::white.withAlpha(.7f));
+        g.drawLine(0.f, levelY, static_cast<float>(width), levelY, 1.5f);
+    }
+
 }
 
 void EnvelopeCurve::resized()
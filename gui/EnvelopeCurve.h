@@ -40,6 +40,8 @@ public:
     void setAttackShape(float);
     void setDecayShape(float);
     void setReleaseShape(float);
+    //! current level of the envelope in [0..1], drawn as a line. Negative hides it
+    void setLevel(float);
 
     void paint (Graphics&);
     void resized();
@@ -52,6 +54,7 @@ private:
     float attackShape_;
     float decayShape_;
     float releaseShape_;
+    float level_ = -1.f;
     float valueAtRelease_;
     float sustainLevel_;
     int samplesCounter_;
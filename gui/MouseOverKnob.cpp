@@ -102,6 +102,36 @@ MouseOverKnob::modAmountConversion MouseOverKnob::getConversionType()
     return modSourceValueConverted;
 }
 
+void MouseOverKnob::setLiveModulation(bool active, float modulation)
+{
+    if (!active)
+    {
+        modulation = 0.0f;
+    }
+
+    if (active != liveModActive || modulation != liveModulation)
+    {
+        liveModActive = active;
+        liveModulation = modulation;
+        repaint();
+    }
+}
+
+bool MouseOverKnob::hasLiveModulation() const
+{
+    return liveModActive;
+}
+
+double MouseOverKnob::getLiveModulatedValue() const
+{
+    const double val = getValue();
+    const double modulated = modSourceValueConverted == modAmountConversion::octToFreq
+        ? val * std::pow(2.0, static_cast<double>(liveModulation))
+        : val + static_cast<double>(liveModulation);
+
+    return jlimit(getMinimum(), getMaximum(), modulated);
+}
+
 //==============================================================================
 
 void MouseOverKnob::setBounds(int x, int y, int width, int height)
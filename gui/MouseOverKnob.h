@@ -64,6 +64,19 @@ public:
     std::array<Param*, 2> getModAmounts();
     modAmountConversion getConversionType();
 
+    /**
+    * Modulation of the newest voice, drawn as a marker on the saturns. Repaints if it changed.
+    @param active false hides the marker
+    @param modulation added to the value, in octaves for modAmountConversion::octToFreq
+    */
+    void setLiveModulation(bool active, float modulation);
+    bool hasLiveModulation() const;
+
+    /**
+    * Value with the modulation of the newest voice, limited to the slider range.
+    */
+    double getLiveModulatedValue() const;
+
     //==============================================================================
 
     /*
@@ -130,6 +143,9 @@ private:
     std::array<ParamStepped<eModSource>*, 2> modSources;
     modAmountConversion modSourceValueConverted = modAmountConversion::noConversion;
 
+    bool liveModActive = false;
+    float liveModulation = 0.0f;
+
     // for mod amount knob (textBoxWidth or textBoxHeight is 0 && knobheight < 19)
     bool displayBipolarValue = false;
 };
@@ -29,6 +29,8 @@
 #include "panels/ChorusPanel.h"
 #include "panels/ClippingPanel.h"
 #include "panels/InfoPanel.h"
+#include "panels/ArpPanel.h"
+#include "panels/ModSlotsPanel.h"
 //[/Headers]
 
 #include "PlugUI.h"
@@ -152,6 +154,8 @@ PlugUI::PlugUI (SynthParams &p)
     foldableComponent->addPanel(4, new LoFiPanel(params));
     foldableComponent->addPanel(4, new ClippingPanel(params));
     foldableComponent->addSection (TRANS("step sequencer"), new SeqPanel (params), SynthParams::stepSeqColour, 300, &params.seqSection, 5);
+    foldableComponent->addSection (TRANS("arpeggiator"), new ArpPanel (params), SynthParams::stepSeqColour, 128, &params.arpSection, 6);
+    foldableComponent->addSection (TRANS("mod slots"), new ModSlotsPanel (params), SynthParams::modSlotsColour, 278, &params.modSlotsSection, 7);
 
     // set whole design from very parent GUI component
     lnf = new CustomLookAndFeel();
@@ -166,6 +170,12 @@ PlugUI::PlugUI (SynthParams &p)
     infoScreen->setContentOwned(new InfoPanel(params), true);
     infoScreen->centreWithSize(infoScreen->getWidth(), infoScreen->getHeight());
     infoScreen->setVisible(false);
+
+    // sub window with the preset browser
+    addAndMakeVisible(presetWindow = new InfoWindow("Presets", Colours::black, InfoWindow::TitleBarButtons::closeButton));
+    presetWindow->setAlwaysOnTop(true);
+    presetWindow->setContentOwned(new PresetBrowser(params), true);
+    presetWindow->setVisible(false);
     //[/Constructor]
 }
 
@@ -173,6 +183,7 @@ PlugUI::~PlugUI()
 {
     //[Destructor_pre]. You can add your own custom destruction code here..
     infoScreen = nullptr;
+    presetWindow = nullptr;
     //[/Destructor_pre]
 
     freq = nullptr;
@@ -261,7 +272,9 @@ void PlugUI::buttonClicked (Button* buttonThatWasClicked)
     else if (buttonThatWasClicked == loadPresetButton)
     {
         //[UserButtonCode_loadPresetButton] -- add your button handler code here..
-        params.readXMLPatchStandalone(eSerializationParams::eAll);
+        presetWindow->centreWithSize(presetWindow->getWidth(), presetWindow->getHeight());
+        presetWindow->setVisible(true);
+        presetWindow->grabKeyboardFocus();
         //[/UserButtonCode_loadPresetButton]
     }
     else if (buttonThatWasClicked == logoInfoButton)
@@ -27,6 +27,7 @@
 #include "FoldablePanel.h"
 #include "IncDecDropDown.h"
 #include "panels/PanelBase.h"
+#include "PresetBrowser.h"
 //[/Headers]
 
 
@@ -85,6 +86,7 @@ private:
 
     ScopedPointer<CustomLookAndFeel> lnf;
     ScopedPointer<DocumentWindow> infoScreen;
+    ScopedPointer<DocumentWindow> presetWindow;
     //[/UserVariables]
 
     //==============================================================================
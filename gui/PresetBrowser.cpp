@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+    PresetBrowser.cpp
+
+  ==============================================================================
+*/
+
+#include "PresetBrowser.h"
+
+namespace {
+    const Colour textColour(0xff6c788c);
+    const int rowHeight = 20;
+    const int margin = 4;
+}
+
+//==============================================================================
+// contructer & destructer
+PresetBrowser::PresetBrowser(SynthParams &p)
+    : params(p)
+{
+    addAndMakeVisible(searchField = new TextEditor("search"));
+    searchField->setMultiLine(false);
+    searchField->setTextToShowWhenEmpty(TRANS("search name or tag"), Colours::grey);
+    searchField->addListener(this);
+
+    addAndMakeVisible(list = new ListBox("presets", this));
+    list->setRowHeight(rowHeight);
+    list->setColour(ListBox::backgroundColourId, Colours::white);
+
+    addAndMakeVisible(fileButton = new TextButton("file"));
+    fileButton->setButtonText(TRANS("other file..."));
+    fileButton->setColour(TextButton::buttonColourId, Colours::white);
+    fileButton->setColour(TextButton::textColourOffId, textColour);
+    fileButton->addListener(this);
+
+    setSize(320, 420);
+
+    // the index of the last session is there at once, changes follow from the library thread
+    params.presetLibrary.addChangeListener(this);
+    params.presetLibrary.startIndexing();
+    updateResults();
+}
+
+PresetBrowser::~PresetBrowser()
+{
+    params.presetLibrary.removeChangeListener(this);
+}
+//==============================================================================
+
+void PresetBrowser::resized()
+{
+    Rectangle<int> area = getLocalBounds().reduced(margin);
+    searchField->setBounds(area.removeFromTop(24));
+    fileButton->setBounds(area.removeFromBottom(24));
+    area.removeFromTop(margin);
+    area.removeFromBottom(margin);
+    list->setBounds(area);
+}
+
+int PresetBrowser::getNumRows()
+{
+    return results.size();
+}
+
+void PresetBrowser::paintListBoxItem(int rowNumber, Graphics &g, int width, int height, bool rowIsSelected)
+{
+    if (rowNumber < 0 || rowNumber >= results.size()) {
+        return;
+    }
+    if (rowIsSelected) {
+        g.fillAll(textColour.withAlpha(0.2f));
+    }
+    const int entry = results[rowNumber];
+    const int nameWidth = width * 3 / 5;
+    g.setColour(textColour);
+    g.setFont(static_cast<float>(height) * 0.7f);
+    g.drawText(params.presetLibrary.getName(entry), margin, 0, nameWidth - margin, height, Justification::centredLeft, true);
+    g.setColour(Colours::grey);
+    g.drawText(params.presetLibrary.getTags(entry), nameWidth, 0, width - nameWidth - margin, height, Justification::centredRight, true);
+}
+
+void PresetBrowser::listBoxItemDoubleClicked(int row, const MouseEvent &e)
+{
+    ignoreUnused(e);
+    loadRow(row);
+}
+
+void PresetBrowser::returnKeyPressed(int lastRowSelected)
+{
+    loadRow(lastRowSelected);
+}
+
+void PresetBrowser::textEditorTextChanged(TextEditor &editor)
+{
+    ignoreUnused(editor);
+    updateResults();
+}
+
+void PresetBrowser::textEditorReturnKeyPressed(TextEditor &editor)
+{
+    ignoreUnused(editor);
+    // the first match, so that typing and return are enough
+    loadRow(jmax(0, list->getSelectedRow()));
+}
+
+void PresetBrowser::buttonClicked(Button *buttonThatWasClicked)
+{
+    if (buttonThatWasClicked == fileButton) {
+        params.readXMLPatchStandalone(eSerializationParams::eAll);
+    }
+}
+
+void PresetBrowser::changeListenerCallback(ChangeBroadcaster *source)
+{
+    ignoreUnused(source);
+    updateResults();
+}
+
+void PresetBrowser::updateResults()
+{
+    params.presetLibrary.search(searchField->getText(), results);
+    list->updateContent();
+    list->repaint();
+}
+
+void PresetBrowser::loadRow(int row)
+{
+    if (row >= 0 && row < results.size()) {
+        params.readXMLPatchFile(params.presetLibrary.getFile(results[row]), eSerializationParams::eAll);
+    }
+}
@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    PresetBrowser.h
+
+  ==============================================================================
+*/
+
+#ifndef PRESETBROWSER_H_INCLUDED
+#define PRESETBROWSER_H_INCLUDED
+
+#include "JuceHeader.h"
+#include "SynthParams.h"
+
+/**
+* List of the patches in the preset folder with a search field, filled from the preset library.
+* Typing filters the list at once, a double click or return loads the selected patch.
+*/
+class PresetBrowser : public Component,
+                      public TextEditorListener,
+                      public ButtonListener,
+                      public ListBoxModel,
+                      public ChangeListener
+{
+public:
+    //==============================================================================
+    PresetBrowser(SynthParams &p);
+    ~PresetBrowser();
+    //==============================================================================
+    void resized() override;
+
+    int getNumRows() override;
+    void paintListBoxItem(int rowNumber, Graphics &g, int width, int height, bool rowIsSelected) override;
+    void listBoxItemDoubleClicked(int row, const MouseEvent &e) override;
+    void returnKeyPressed(int lastRowSelected) override;
+
+    void textEditorTextChanged(TextEditor &editor) override;
+    void textEditorReturnKeyPressed(TextEditor &editor) override;
+    void buttonClicked(Button *buttonThatWasClicked) override;
+    void changeListenerCallback(ChangeBroadcaster *source) override;
+
+private:
+    void updateResults();
+    void loadRow(int row);
+
+    SynthParams &params;
+    Array<int> results; //!< library entries that match the search, valid until the next change message
+
+    ScopedPointer<TextEditor> searchField;
+    ScopedPointer<ListBox> list;
+    ScopedPointer<TextButton> fileButton;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetBrowser)
+};
+
+#endif  // PRESETBROWSER_H_INCLUDED
@@ -0,0 +1,251 @@
+/*
+  ==============================================================================
+
+  This is an automatically generated GUI class created by the Introjucer!
+
+  Be careful when adding custom code to these files, as only the code within
+  the "//[xyz]" and "//[/xyz]" sections will be retained when the file is loaded
+  and re-saved.
+
+  Created with Introjucer version: 3.2.0
+
+  ------------------------------------------------------------------------------
+
+  The Introjucer is part of the JUCE library - "Jules' Utility Class Extensions"
+  Copyright (c) 2015 - ROLI Ltd.
+
+  ==============================================================================
+*/
+
+//[Headers] You can add your own extra header files here...
+//[/Headers]
+
+#include "ArpPanel.h"
+
+
+//[MiscUserDefs] You can add your own user definitions and misc code here...
+//[/MiscUserDefs]
+
+//==============================================================================
+ArpPanel::ArpPanel (SynthParams &p)
+    : PanelBase(p)
+{
+    //[Constructor_pre] You can add your own custom stuff here..
+    //[/Constructor_pre]
+
+    addAndMakeVisible (arpModeSlider = new MouseOverKnob ("Arp Mode"));
+    arpModeSlider->setRange (0, 4, 1);
+    arpModeSlider->setSliderStyle (Slider::RotaryVerticalDrag);
+    arpModeSlider->setTextBoxStyle (Slider::TextBoxBelow, false, 80, 20);
+    arpModeSlider->setColour (Slider::rotarySliderFillColourId, Colour (0xff564c43));
+    arpModeSlider->setColour (Slider::textBoxTextColourId, Colours::white);
+    arpModeSlider->setColour (Slider::textBoxBackgroundColourId, Colour (0x00ffffff));
+    arpModeSlider->setColour (Slider::textBoxOutlineColourId, Colour (0x00ffffff));
+    arpModeSlider->addListener (this);
+
+    addAndMakeVisible (arpOctavesSlider = new MouseOverKnob ("Octaves"));
+    arpOctavesSlider->setRange (1, 4, 1);
+    arpOctavesSlider->setSliderStyle (Slider::RotaryVerticalDrag);
+    arpOctavesSlider->setTextBoxStyle (Slider::TextBoxBelow, false, 80, 20);
+    arpOctavesSlider->setColour (Slider::rotarySliderFillColourId, Colour (0xff564c43));
+    arpOctavesSlider->setColour (Slider::textBoxTextColourId, Colours::white);
+    arpOctavesSlider->setColour (Slider::textBoxBackgroundColourId, Colour (0x00ffffff));
+    arpOctavesSlider->setColour (Slider::textBoxOutlineColourId, Colour (0x00ffffff));
+    arpOctavesSlider->addListener (this);
+
+    addAndMakeVisible (arpSpeedSlider = new MouseOverKnob ("Speed"));
+    arpSpeedSlider->setRange (1, 64, 1);
+    arpSpeedSlider->setSliderStyle (Slider::RotaryVerticalDrag);
+    arpSpeedSlider->setTextBoxStyle (Slider::TextBoxBelow, false, 80, 20);
+    arpSpeedSlider->setColour (Slider::rotarySliderFillColourId, Colour (0xff564c43));
+    arpSpeedSlider->setColour (Slider::textBoxTextColourId, Colours::white);
+    arpSpeedSlider->setColour (Slider::textBoxBackgroundColourId, Colour (0x00ffffff));
+    arpSpeedSlider->setColour (Slider::textBoxOutlineColourId, Colour (0x00ffffff));
+    arpSpeedSlider->addListener (this);
+
+    addAndMakeVisible (arpGateSlider = new MouseOverKnob ("Gate"));
+    arpGateSlider->setRange (1, 100, 0);
+    arpGateSlider->setSliderStyle (Slider::RotaryVerticalDrag);
+    arpGateSlider->setTextBoxStyle (Slider::TextBoxBelow, false, 80, 20);
+    arpGateSlider->setColour (Slider::rotarySliderFillColourId, Colour (0xff564c43));
+    arpGateSlider->setColour (Slider::textBoxTextColourId, Colours::white);
+    arpGateSlider->setColour (Slider::textBoxBackgroundColourId, Colour (0x00ffffff));
+    arpGateSlider->setColour (Slider::textBoxOutlineColourId, Colour (0x00ffffff));
+    arpGateSlider->addListener (this);
+
+    addAndMakeVisible (onOffSwitch = new Slider ("arp switch"));
+    onOffSwitch->setRange (0, 1, 1);
+    onOffSwitch->setSliderStyle (Slider::LinearHorizontal);
+    onOffSwitch->setTextBoxStyle (Slider::NoTextBox, true, 80, 20);
+    onOffSwitch->setColour (Slider::thumbColourId, Colour (0xffdadada));
+    onOffSwitch->setColour (Slider::trackColourId, Colour (0xff666666));
+    onOffSwitch->setColour (Slider::rotarySliderFillColourId, Colours::white);
+    onOffSwitch->setColour (Slider::rotarySliderOutlineColourId, Colour (0xfff20000));
+    onOffSwitch->setColour (Slider::textBoxBackgroundColourId, Colour (0xfffff4f4));
+    onOffSwitch->addListener (this);
+
+
+    //[UserPreSize]
+    registerSlider(arpModeSlider, &params.arpMode);
+    registerSlider(arpOctavesSlider, &params.arpOctaves);
+    registerSlider(arpSpeedSlider, &params.arpSpeed);
+    registerSlider(arpGateSlider, &params.arpGate);
+    registerSlider(onOffSwitch, &params.arpActivation, std::bind(&ArpPanel::onOffSwitchChanged, this));
+    //[/UserPreSize]
+
+    setSize (370, 150);
+
+
+    //[Constructor] You can add your own custom stuff here..
+    //[/Constructor]
+}
+
+ArpPanel::~ArpPanel()
+{
+    //[Destructor_pre]. You can add your own custom destruction code here..
+    //[/Destructor_pre]
+
+    arpModeSlider = nullptr;
+    arpOctavesSlider = nullptr;
+    arpSpeedSlider = nullptr;
+    arpGateSlider = nullptr;
+    onOffSwitch = nullptr;
+
+
+    //[Destructor]. You can add your own custom destruction code here..
+    //[/Destructor]
+}
+
+//==============================================================================
+void ArpPanel::paint (Graphics& g)
+{
+    //[UserPrePaint] Add your own custom painting code here..
+    //[/UserPrePaint]
+
+    g.fillAll (Colour (0xff564c43));
+
+    //[UserPaint] Add your own custom painting code here..
+    drawGroupBorder(g, "arpeggiator", 0, 0,
+                    this->getWidth(), this->getHeight() - 22, 25.0f, 24.0f, 4.0f, 3.0f, 30, SynthParams::stepSeqColour);
+    //[/UserPaint]
+}
+
+void ArpPanel::resized()
+{
+    //[UserPreResize] Add your own custom resize code here..
+    //[/UserPreResize]
+
+    arpModeSlider->setBounds (26, 40, 64, 64);
+    arpOctavesSlider->setBounds (112, 40, 64, 64);
+    arpSpeedSlider->setBounds (198, 40, 64, 64);
+    arpGateSlider->setBounds (284, 40, 64, 64);
+    onOffSwitch->setBounds (30, 1, 40, 30);
+    //[UserResized] Add your own custom resize handling here..
+    //[/UserResized]
+}
+
+void ArpPanel::sliderValueChanged (Slider* sliderThatWasMoved)
+{
+    //[UsersliderValueChanged_Pre]
+    handleSlider(sliderThatWasMoved);
+    //[/UsersliderValueChanged_Pre]
+
+    if (sliderThatWasMoved == arpModeSlider)
+    {
+        //[UserSliderCode_arpModeSlider] -- add your slider handling code here..
+        //[/UserSliderCode_arpModeSlider]
+    }
+    else if (sliderThatWasMoved == arpOctavesSlider)
+    {
+        //[UserSliderCode_arpOctavesSlider] -- add your slider handling code here..
+        //[/UserSliderCode_arpOctavesSlider]
+    }
+    else if (sliderThatWasMoved == arpSpeedSlider)
+    {
+        //[UserSliderCode_arpSpeedSlider] -- add your slider handling code here..
+        //[/UserSliderCode_arpSpeedSlider]
+    }
+    else if (sliderThatWasMoved == arpGateSlider)
+    {
+        //[UserSliderCode_arpGateSlider] -- add your slider handling code here..
+        //[/UserSliderCode_arpGateSlider]
+    }
+    else if (sliderThatWasMoved == onOffSwitch)
+    {
+        //[UserSliderCode_onOffSwitch] -- add your slider handling code here..
+        //[/UserSliderCode_onOffSwitch]
+    }
+
+    //[UsersliderValueChanged_Post]
+    //[/UsersliderValueChanged_Post]
+}
+
+
+
+//[MiscUserCode] You can add your own definitions of your custom methods or any other code here...
+void ArpPanel::onOffSwitchChanged()
+{
+    const bool on = static_cast<int>(onOffSwitch->getValue()) == 1;
+    arpModeSlider->setEnabled(on);
+    arpOctavesSlider->setEnabled(on);
+    arpSpeedSlider->setEnabled(on);
+    arpGateSlider->setEnabled(on);
+    onOffSwitch->setColour(Slider::trackColourId, (on ? SynthParams::onOffSwitchEnabled : SynthParams::onOffSwitchDisabled));
+}
+//[/MiscUserCode]
+
+
+//==============================================================================
+#if 0
+/*  -- Introjucer information section --
+
+    This is where the Introjucer stores the metadata that describe this GUI layout, so
+    make changes in here at your peril!
+
+BEGIN_JUCER_METADATA
+
+<JUCER_COMPONENT documentType="Component" className="ArpPanel" componentName=""
+                 parentClasses="public PanelBase" constructorParams="SynthParams &amp;p"
+                 variableInitialisers="PanelBase(p)" snapPixels="8" snapActive="1"
+                 snapShown="1" overlayOpacity="0.330" fixedSize="0" initialWidth="370"
+                 initialHeight="150">
+  <BACKGROUND backgroundColour="ff564c43"/>
+  <SLIDER name="Arp Mode" id="8a5c5606719e50a1" memberName="arpModeSlider"
+          virtualName="MouseOverKnob" explicitFocusOrder="0" pos="26 40 64 64"
+          rotarysliderfill="ff564c43" textboxtext="ffffffff" textboxbkgd="ffffff"
+          textboxoutline="ffffff" min="0" max="4" int="1" style="RotaryVerticalDrag"
+          textBoxPos="TextBoxBelow" textBoxEditable="1" textBoxWidth="80"
+          textBoxHeight="20" skewFactor="1"/>
+  <SLIDER name="Octaves" id="c65e979012e569f8" memberName="arpOctavesSlider"
+          virtualName="MouseOverKnob" explicitFocusOrder="0" pos="112 40 64 64"
+          rotarysliderfill="ff564c43" textboxtext="ffffffff" textboxbkgd="ffffff"
+          textboxoutline="ffffff" min="1" max="4" int="1" style="RotaryVerticalDrag"
+          textBoxPos="TextBoxBelow" textBoxEditable="1" textBoxWidth="80"
+          textBoxHeight="20" skewFactor="1"/>
+  <SLIDER name="Speed" id="b3ce76e4d92c272f" memberName="arpSpeedSlider"
+          virtualName="MouseOverKnob" explicitFocusOrder="0" pos="198 40 64 64"
+          rotarysliderfill="ff564c43" textboxtext="ffffffff" textboxbkgd="ffffff"
+          textboxoutline="ffffff" min="1" max="64" int="1" style="RotaryVerticalDrag"
+          textBoxPos="TextBoxBelow" textBoxEditable="1" textBoxWidth="80"
+          textBoxHeight="20" skewFactor="1"/>
+  <SLIDER name="Gate" id="1a1f53456ffae852" memberName="arpGateSlider"
+          virtualName="MouseOverKnob" explicitFocusOrder="0" pos="284 40 64 64"
+          rotarysliderfill="ff564c43" textboxtext="ffffffff" textboxbkgd="ffffff"
+          textboxoutline="ffffff" min="1" max="100" int="0" style="RotaryVerticalDrag"
+          textBoxPos="TextBoxBelow" textBoxEditable="1" textBoxWidth="80"
+          textBoxHeight="20" skewFactor="1"/>
+  <SLIDER name="arp switch" id="11e8d0d622cc6231" memberName="onOffSwitch"
+          virtualName="" explicitFocusOrder="0" pos="30 1 40 30" thumbcol="ffdadada"
+          trackcol="ff666666" rotarysliderfill="ffffffff" rotaryslideroutline="fff20000"
+          textboxbkgd="fffff4f4" min="0" max="1" int="1" style="LinearHorizontal"
+          textBoxPos="NoTextBox" textBoxEditable="0" textBoxWidth="80"
+          textBoxHeight="20" skewFactor="1"/>
+</JUCER_COMPONENT>
+
+END_JUCER_METADATA
+*/
+#endif
+
+
+//[EndFile] You can add extra defines here...
+//[/EndFile]
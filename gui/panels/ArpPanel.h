@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+  This is an automatically generated GUI class created by the Introjucer!
+
+  Be careful when adding custom code to these files, as only the code within
+  the "//[xyz]" and "//[/xyz]" sections will be retained when the file is loaded
+  and re-saved.
+
+  Created with Introjucer version: 3.2.0
+
+  ------------------------------------------------------------------------------
+
+  The Introjucer is part of the JUCE library - "Jules' Utility Class Extensions"
+  Copyright (c) 2015 - ROLI Ltd.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_HEADER_48E5D9874BC9053A__
+#define __JUCE_HEADER_48E5D9874BC9053A__
+
+//[Headers]     -- You can add your own extra header files here --
+#include "JuceHeader.h"
+#include "PanelBase.h"
+//[/Headers]
+
+
+
+//==============================================================================
+/**
+                                                                    //[Comments]
+    Switch, note order, octave range, speed and gate of the arpeggiator.
+                                                                    //[/Comments]
+*/
+class ArpPanel  : public PanelBase,
+                  public SliderListener
+{
+public:
+    //==============================================================================
+    ArpPanel (SynthParams &p);
+    ~ArpPanel();
+
+    //==============================================================================
+    //[UserMethods]     -- You can add your own custom methods in this section.
+    void onOffSwitchChanged();
+    //[/UserMethods]
+
+    void paint (Graphics& g);
+    void resized();
+    void sliderValueChanged (Slider* sliderThatWasMoved);
+
+
+
+private:
+    //[UserVariables]   -- You can add your own custom variables in this section.
+    //[/UserVariables]
+
+    //==============================================================================
+    ScopedPointer<MouseOverKnob> arpModeSlider;
+    ScopedPointer<MouseOverKnob> arpOctavesSlider;
+    ScopedPointer<MouseOverKnob> arpSpeedSlider;
+    ScopedPointer<MouseOverKnob> arpGateSlider;
+    ScopedPointer<Slider> onOffSwitch;
+
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ArpPanel)
+};
+
+//[EndFile] You can add extra defines here...
+//[/EndFile]
+
+#endif   // __JUCE_HEADER_48E5D9874BC9053A__
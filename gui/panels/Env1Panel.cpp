@@ -181,6 +181,9 @@ Env1Panel::Env1Panel (SynthParams &p, int envelopeNumber)
     registerSaturnSource(releaseTime1, speedMod1, &env.speedModSrc1, &env.speedModAmount1, 1, MouseOverKnob::modAmountConversion::percentage);
     registerSaturnSource(releaseTime1, speedMod2, &env.speedModSrc2, &env.speedModAmount2, 2, MouseOverKnob::modAmountConversion::percentage);
 
+    // the speed is fixed at the start of a note, only the level follows the voice
+    registerLiveEnvelope(envelopeCurve, envelopeNumber + 1);
+
     registerCombobox(envSpeedModSrc1, &env.speedModSrc1, {attackTime1, decayTime1, releaseTime1}, std::bind(&Env1Panel::updateModAmountKnobs, this));
     registerCombobox(envSpeedModSrc2, &env.speedModSrc2, {attackTime1, decayTime1, releaseTime1}, std::bind(&Env1Panel::updateModAmountKnobs, this));
     //[/UserPreSize]
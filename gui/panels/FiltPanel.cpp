@@ -212,6 +212,10 @@ FiltPanel::FiltPanel (SynthParams &p, int filterNumber)
     registerSaturnSource(resonanceSlider, resModAmount1, &filter.resonanceModSrc1, &filter.resModAmount1, 1);
     registerSaturnSource(resonanceSlider, resModAmount2, &filter.resonanceModSrc2, &filter.resModAmount2, 2);
 
+    registerLiveModulation(cutoffSlider, static_cast<destinations>(DEST_FILTER1_LC + filterNumber));
+    registerLiveModulation(cutoffSlider2, static_cast<destinations>(DEST_FILTER1_HC + filterNumber));
+    registerLiveModulation(resonanceSlider, static_cast<destinations>(DEST_FILTER1_RES + filterNumber));
+
     registerSlider(cutoffSlider, &filter.lpCutoff);
     registerSlider(cutoffSlider2, &filter.hpCutoff);
     registerSlider(resonanceSlider, &filter.resonance);
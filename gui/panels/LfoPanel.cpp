@@ -24,12 +24,17 @@
 
 
 //[MiscUserDefs] You can add your own user definitions and misc code here...
+namespace {
+    // free space in the head, between the gain box and the name
+    const Rectangle<int> levelArea(104, 11, 60, 10);
+}
 //[/MiscUserDefs]
 
 //==============================================================================
 LfoPanel::LfoPanel (SynthParams &p, int lfoNumber)
     : PanelBase(p),
-      lfo(p.lfo[lfoNumber])
+      lfo(p.lfo[lfoNumber]),
+      lfoIndex(lfoNumber)
 {
     //[Constructor_pre] You can add your own custom stuff here..
     //[/Constructor_pre]
@@ -142,6 +147,7 @@ LfoPanel::LfoPanel (SynthParams &p, int lfoNumber)
 
     registerSaturnSource(freq, freqModAmount1, &lfo.freqModSrc1, &lfo.freqModAmount1, 1, MouseOverKnob::modAmountConversion::octToFreq);
     registerSaturnSource(freq, freqModAmount2, &lfo.freqModSrc2, &lfo.freqModAmount2, 2, MouseOverKnob::modAmountConversion::octToFreq);
+    registerLiveModulation(freq, static_cast<destinations>(DEST_LFO1_FREQ + lfoNumber));
 
     fillModsourceBox(freqModSrc1, true);
     fillModsourceBox(freqModSrc2, true);
@@ -219,6 +225,10 @@ void LfoPanel::paint (Graphics& g)
     drawGroupBorder(g, lfo.name, 0, 0,
                     this->getWidth(), this->getHeight() - 22, 25.0f, 20.0f, 4.0f, 3.0f, 50,SynthParams::lfoColour);
     drawPics(g, wave, lfoGain, tempoSyncSwitch, triplets, dottedNotes);
+    if (levelUsed)
+    {
+        drawLevel(g);
+    }
     //[/UserPaint]
 }
 
@@ -389,6 +399,34 @@ void LfoPanel::updateLfoSyncToggle()
     triplets->setEnabled(lfo.tempSync.getStep() == eOnOffToggle::eOn);
 }
 
+void LfoPanel::timerCallback()
+{
+    // fetches the newest snapshot for the live modulation of the freq knob
+    PanelBase::timerCallback();
+
+    const ModSnapshot::Values &values = params.modSnapshot.read();
+    const bool used = values.lfoUsed[lfoIndex];
+    const float level = used ? values.lfo[lfoIndex] : 0.f;
+    if (used != levelUsed || level != shownLevel)
+    {
+        levelUsed = used;
+        shownLevel = level;
+        repaint(levelArea);
+    }
+}
+
+void LfoPanel::drawLevel(Graphics& g)
+{
+    const Rectangle<float> area = levelArea.toFloat();
+    const float centerX = area.getCentreX();
+    const float x = centerX + jlimit(-1.f, 1.f, shownLevel) * area.getWidth() * .5f;
+
+    g.setColour(SynthParams::lfoColour);
+    g.fillRect(Rectangle<float>(jmin(x, centerX), area.getY(), std::abs(x - centerX), area.getHeight()));
+    g.drawRect(area, 1.f);
+    g.drawVerticalLine(static_cast<int>(centerX), area.getY(), area.getBottom());
+}
+
 void LfoPanel::updateModAmountKnobs()
 {
     freqModAmount1->setEnabled(lfo.freqModSrc1.getStep() != eModSource::eNone);
@@ -410,7 +448,7 @@ BEGIN_JUCER_METADATA
 
 <JUCER_COMPONENT documentType="Component" className="LfoPanel" componentName=""
                  parentClasses="public PanelBase" constructorParams="SynthParams &amp;p, int lfoNumber"
-                 variableInitialisers="PanelBase(p),&#10;lfo(p.lfo[lfoNumber])"
+                 variableInitialisers="PanelBase(p),&#10;lfo(p.lfo[lfoNumber]),&#10;lfoIndex(lfoNumber)"
                  snapPixels="8" snapActive="1" snapShown="1" overlayOpacity="0.330"
                  fixedSize="0" initialWidth="267" initialHeight="197">
   <BACKGROUND backgroundColour="ff855050"/>
@@ -51,6 +51,16 @@ public:
         ScopedPointer<ToggleButton>& syncT, ScopedPointer<ToggleButton>& tripletT, ScopedPointer<ToggleButton>& dotT);
 	void updateLfoSyncToggle();
     void updateModAmountKnobs();
+
+    /**
+    * timerCallback() is needed here to follow the output of the lfo in the newest voice.
+    */
+    virtual void timerCallback() override;
+
+    /**
+    * Draw the lfo output as a bar from the center of the head, to the right for positive values.
+    */
+    void drawLevel(Graphics& g);
     //[/UserMethods]
 
     void paint (Graphics& g);
@@ -66,6 +76,9 @@ private:
     Image sineWave, squareWave, sampleHold, gainSign, syncPic, tripletPic, tripletPicOff, dotPic, dotPicOff;
 
     SynthParams::Lfo& lfo;
+    const int lfoIndex;
+    bool levelUsed = false;     //!< the lfo is rendered in the newest voice
+    float shownLevel = 0.f;     //!< lfo output as drawn
     //[/UserVariables]
 
     //==============================================================================
@@ -0,0 +1,332 @@
+/*
+  ==============================================================================
+
+  This is an automatically generated GUI class created by the Introjucer!
+
+  Be careful when adding custom code to these files, as only the code within
+  the "//[xyz]" and "//[/xyz]" sections will be retained when the file is loaded
+  and re-saved.
+
+  Created with Introjucer version: 3.2.0
+
+  ------------------------------------------------------------------------------
+
+  The Introjucer is part of the JUCE library - "Jules' Utility Class Extensions"
+  Copyright (c) 2015 - ROLI Ltd.
+
+  ==============================================================================
+*/
+
+//[Headers] You can add your own extra header files here...
+//[/Headers]
+
+#include "ModSlotsPanel.h"
+
+
+//[MiscUserDefs] You can add your own user definitions and misc code here...
+namespace {
+    const int rowTop = 54;
+    const int rowHeight = 26;
+
+    // in the order of eModCurve and eModPolarity
+    const char *curveNames[] = { "linear", "exponential", "logarithmic" };
+    const char *polarityNames[] = { "as source", "unipolar", "bipolar" };
+}
+//[/MiscUserDefs]
+
+//==============================================================================
+ModSlotsPanel::ModSlotsPanel (SynthParams &p)
+    : PanelBase(p)
+{
+    //[Constructor_pre] You can add your own custom stuff here..
+    //[/Constructor_pre]
+
+
+    //[UserPreSize]
+    for (int i = 0; i < numPages; ++i)
+    {
+        TextButton* pageButton = new TextButton ("page " + String(i + 1));
+        addAndMakeVisible (pageButton);
+        pageButton->setButtonText (String(i * slotsPerPage + 1) + "-" + String((i + 1) * slotsPerPage));
+        pageButton->setConnectedEdges (Button::ConnectedOnLeft | Button::ConnectedOnRight);
+        pageButton->setClickingTogglesState (true);
+        pageButton->setRadioGroupId (1);
+        pageButton->addListener (this);
+        pageButton->setColour (TextButton::buttonColourId, Colours::white);
+        pageButton->setColour (TextButton::buttonOnColourId, Colours::grey);
+        pageButton->setColour (TextButton::textColourOnId, Colours::white);
+        pageButton->setColour (TextButton::textColourOffId, Colours::grey);
+        pageButtons[i] = pageButton;
+    }
+
+    for (SlotRow& row : rows)
+    {
+        addAndMakeVisible (row.number = new Label ("slot number", String::empty));
+        row.number->setFont (Font (15.00f, Font::plain));
+        row.number->setJustificationType (Justification::centredRight);
+        row.number->setColour (Label::textColourId, Colours::white);
+
+        addAndMakeVisible (row.source = new ComboBox ("slot source"));
+        fillModsourceBox (row.source, false);
+        row.source->addListener (this);
+
+        addAndMakeVisible (row.destination = new ComboBox ("slot destination"));
+        for (int d = DEST_NONE; d < MAX_DESTINATIONS; ++d)
+        {
+            row.destination->addItem (params.getModDestName(d), d + COMBO_OFS);
+        }
+        row.destination->addListener (this);
+
+        addAndMakeVisible (row.amount = new Slider ("slot amount"));
+        row.amount->setRange (-100, 100, 1);
+        row.amount->setSliderStyle (Slider::LinearBar);
+        row.amount->setTextValueSuffix (" %");
+        row.amount->setColour (Slider::thumbColourId, Colours::grey);
+        row.amount->setColour (Slider::textBoxTextColourId, Colours::white);
+        row.amount->setDoubleClickReturnValue (true, 0.0);
+        row.amount->setScrollWheelEnabled (false);
+        row.amount->addListener (this);
+
+        addAndMakeVisible (row.curve = new ComboBox ("slot curve"));
+        for (int c = 0; c < static_cast<int>(eModCurve::nSteps); ++c)
+        {
+            row.curve->addItem (curveNames[c], c + 1);
+        }
+        row.curve->addListener (this);
+
+        addAndMakeVisible (row.polarity = new ComboBox ("slot polarity"));
+        for (int c = 0; c < static_cast<int>(eModPolarity::nSteps); ++c)
+        {
+            row.polarity->addItem (polarityNames[c], c + 1);
+        }
+        row.polarity->addListener (this);
+    }
+
+    showPage (0);
+    //[/UserPreSize]
+
+    setSize (800, 300);
+
+
+    //[Constructor] You can add your own custom stuff here..
+    //[/Constructor]
+}
+
+ModSlotsPanel::~ModSlotsPanel()
+{
+    //[Destructor_pre]. You can add your own custom destruction code here..
+    for (SlotRow& row : rows)
+    {
+        row.number = nullptr;
+        row.source = nullptr;
+        row.destination = nullptr;
+        row.amount = nullptr;
+        row.curve = nullptr;
+        row.polarity = nullptr;
+    }
+    for (ScopedPointer<TextButton>& pageButton : pageButtons)
+    {
+        pageButton = nullptr;
+    }
+    //[/Destructor_pre]
+
+
+
+    //[Destructor]. You can add your own custom destruction code here..
+    //[/Destructor]
+}
+
+//==============================================================================
+void ModSlotsPanel::paint (Graphics& g)
+{
+    //[UserPrePaint] Add your own custom painting code here..
+    //[/UserPrePaint]
+
+    g.fillAll (Colour (0xff4a5866));
+
+    //[UserPaint] Add your own custom painting code here..
+    drawGroupBorder(g, "mod slots", 0, 0,
+                    this->getWidth(), this->getHeight() - 22, 25.0f, 24.0f, 4.0f, 3.0f, 30, SynthParams::modSlotsColour);
+
+    // column titles above the first row
+    const SlotRow& first = rows[0];
+    g.setColour (Colours::white);
+    g.setFont (Font (14.00f, Font::plain));
+    g.drawText (TRANS("source"), first.source->getX(), rowTop - 20, first.source->getWidth(), 18, Justification::centredLeft, true);
+    g.drawText (TRANS("destination"), first.destination->getX(), rowTop - 20, first.destination->getWidth(), 18, Justification::centredLeft, true);
+    g.drawText (TRANS("amount"), first.amount->getX(), rowTop - 20, first.amount->getWidth(), 18, Justification::centred, true);
+    g.drawText (TRANS("curve"), first.curve->getX(), rowTop - 20, first.curve->getWidth(), 18, Justification::centredLeft, true);
+    g.drawText (TRANS("polarity"), first.polarity->getX(), rowTop - 20, first.polarity->getWidth(), 18, Justification::centredLeft, true);
+    //[/UserPaint]
+}
+
+void ModSlotsPanel::resized()
+{
+    //[UserPreResize] Add your own custom resize code here..
+    //[/UserPreResize]
+
+    //[UserResized] Add your own custom resize handling here..
+    for (int i = 0; i < numPages; ++i)
+    {
+        pageButtons[i]->setBounds (120 + i * 64, 5, 64, 20);
+    }
+
+    for (int i = 0; i < slotsPerPage; ++i)
+    {
+        const int y = rowTop + i * rowHeight;
+        rows[i].number->setBounds (10, y, 32, 22);
+        rows[i].source->setBounds (48, y, 160, 22);
+        rows[i].destination->setBounds (216, y, 136, 22);
+        rows[i].amount->setBounds (360, y, 200, 22);
+        rows[i].curve->setBounds (568, y, 104, 22);
+        rows[i].polarity->setBounds (680, y, 104, 22);
+    }
+    //[/UserResized]
+}
+
+void ModSlotsPanel::sliderValueChanged (Slider* sliderThatWasMoved)
+{
+    //[UsersliderValueChanged_Pre]
+    const int row = findRow(sliderThatWasMoved);
+    if (row >= 0)
+    {
+        slotChanged(row);
+    }
+    //[/UsersliderValueChanged_Pre]
+
+    //[UsersliderValueChanged_Post]
+    //[/UsersliderValueChanged_Post]
+}
+
+void ModSlotsPanel::buttonClicked (Button* buttonThatWasClicked)
+{
+    //[UserbuttonClicked_Pre]
+    for (int i = 0; i < numPages; ++i)
+    {
+        if (buttonThatWasClicked == pageButtons[i])
+        {
+            showPage(i);
+        }
+    }
+    //[/UserbuttonClicked_Pre]
+
+    //[UserbuttonClicked_Post]
+    //[/UserbuttonClicked_Post]
+}
+
+void ModSlotsPanel::comboBoxChanged (ComboBox* comboBoxThatHasChanged)
+{
+    //[UsercomboBoxChanged_Pre]
+    const int row = findRow(comboBoxThatHasChanged);
+    if (row >= 0)
+    {
+        slotChanged(row);
+    }
+    //[/UsercomboBoxChanged_Pre]
+
+    //[UsercomboBoxChanged_Post]
+    //[/UsercomboBoxChanged_Post]
+}
+
+
+
+//[MiscUserCode] You can add your own definitions of your custom methods or any other code here...
+void ModSlotsPanel::timerCallback()
+{
+    ModSlots::Data current;
+    params.modSlots.getData(current);
+    if (current != shownSlots)
+    {
+        updateRows();
+    }
+
+    PanelBase::timerCallback();
+}
+
+void ModSlotsPanel::showPage(int newPage)
+{
+    page = jlimit(0, numPages - 1, newPage);
+    pageButtons[page]->setToggleState(true, dontSendNotification);
+    updateRows();
+}
+
+void ModSlotsPanel::updateRows()
+{
+    params.modSlots.getData(shownSlots);
+
+    for (int i = 0; i < slotsPerPage; ++i)
+    {
+        const int slot = page * slotsPerPage + i;
+        const ModSlots::Slot s = params.modSlots.getSlot(slot);
+        SlotRow& row = rows[i];
+
+        row.number->setText(String(slot + 1), dontSendNotification);
+        row.source->setSelectedId(static_cast<int>(s.source) + COMBO_OFS, dontSendNotification);
+        row.destination->setSelectedId(static_cast<int>(s.destination) + COMBO_OFS, dontSendNotification);
+        row.amount->setValue(s.amount, dontSendNotification);
+        row.curve->setSelectedId(static_cast<int>(s.curve) + 1, dontSendNotification);
+        row.polarity->setSelectedId(static_cast<int>(s.polarity) + 1, dontSendNotification);
+
+        // slots that modulate nothing are dimmed
+        const float alpha = ModSlots::isUsed(s) ? 1.0f : 0.5f;
+        row.amount->setAlpha(alpha);
+        row.curve->setAlpha(alpha);
+        row.polarity->setAlpha(alpha);
+    }
+}
+
+void ModSlotsPanel::slotChanged(int row)
+{
+    const SlotRow& r = rows[row];
+
+    ModSlots::Slot s;
+    s.source = static_cast<eModSource>(r.source->getSelectedId() - COMBO_OFS);
+    s.destination = static_cast<destinations>(r.destination->getSelectedId() - COMBO_OFS);
+    s.amount = roundToInt(r.amount->getValue());
+    s.curve = static_cast<eModCurve>(r.curve->getSelectedId() - 1);
+    s.polarity = static_cast<eModPolarity>(r.polarity->getSelectedId() - 1);
+
+    // the audio thread compiles the slot into the matrix with the next block
+    params.modSlots.setSlot(page * slotsPerPage + row, s);
+    updateRows();
+}
+
+int ModSlotsPanel::findRow(Component* c) const
+{
+    for (int i = 0; i < slotsPerPage; ++i)
+    {
+        const SlotRow& row = rows[i];
+        if (c == row.source || c == row.destination || c == row.amount || c == row.curve || c == row.polarity)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+//[/MiscUserCode]
+
+
+//==============================================================================
+#if 0
+/*  -- Introjucer information section --
+
+    This is where the Introjucer stores the metadata that describe this GUI layout, so
+    make changes in here at your peril!
+
+BEGIN_JUCER_METADATA
+
+<JUCER_COMPONENT documentType="Component" className="ModSlotsPanel" componentName=""
+                 parentClasses="public PanelBase, public SliderListener, public ButtonListener, public ComboBoxListener"
+                 constructorParams="SynthParams &amp;p" variableInitialisers="PanelBase(p)"
+                 snapPixels="8" snapActive="1" snapShown="1" overlayOpacity="0.330"
+                 fixedSize="0" initialWidth="800" initialHeight="300">
+  <BACKGROUND backgroundColour="ff4a5866"/>
+</JUCER_COMPONENT>
+
+END_JUCER_METADATA
+*/
+#endif
+
+
+//[EndFile] You can add extra defines here...
+//[/EndFile]
@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+  This is an automatically generated GUI class created by the Introjucer!
+
+  Be careful when adding custom code to these files, as only the code within
+  the "//[xyz]" and "//[/xyz]" sections will be retained when the file is loaded
+  and re-saved.
+
+  Created with Introjucer version: 3.2.0
+
+  ------------------------------------------------------------------------------
+
+  The Introjucer is part of the JUCE library - "Jules' Utility Class Extensions"
+  Copyright (c) 2015 - ROLI Ltd.
+
+  ==============================================================================
+*/
+
+#ifndef __JUCE_HEADER_EA56740566D5501D__
+#define __JUCE_HEADER_EA56740566D5501D__
+
+//[Headers]     -- You can add your own extra header files here --
+#include "JuceHeader.h"
+#include "PanelBase.h"
+//[/Headers]
+
+
+
+//==============================================================================
+/**
+                                                                    //[Comments]
+    Editor of the user slots of the modulation matrix, a page of eight slots at a time.
+    Each row sets source, destination, amount, curve and polarity of one slot.
+                                                                    //[/Comments]
+*/
+class ModSlotsPanel  : public PanelBase,
+                       public SliderListener,
+                       public ButtonListener,
+                       public ComboBoxListener
+{
+public:
+    //==============================================================================
+    ModSlotsPanel (SynthParams &p);
+    ~ModSlotsPanel();
+
+    //==============================================================================
+    //[UserMethods]     -- You can add your own custom methods in this section.
+    static const int slotsPerPage = 8;
+    static const int numPages = ModSlots::maxSlots / slotsPerPage;
+
+    /**
+    * timerCallback() is needed here to show slots that changed outside the panel, e.g. by a patch.
+    */
+    virtual void timerCallback() override;
+
+    /**
+    * Show the slots of a page in the rows.
+    @param newPage in range [0..numPages-1]
+    */
+    void showPage(int newPage);
+
+    /**
+    * Set the rows to the slots of the current page.
+    */
+    void updateRows();
+
+    /**
+    * Write the controls of a row into its slot.
+    @param row in range [0..slotsPerPage-1]
+    */
+    void slotChanged(int row);
+
+    /**
+    * Row that holds the component, -1 if none.
+    */
+    int findRow(Component* c) const;
+    //[/UserMethods]
+
+    void paint (Graphics& g);
+    void resized();
+    void sliderValueChanged (Slider* sliderThatWasMoved);
+    void buttonClicked (Button* buttonThatWasClicked);
+    void comboBoxChanged (ComboBox* comboBoxThatHasChanged);
+
+
+
+private:
+    //[UserVariables]   -- You can add your own custom variables in this section.
+    //! the controls of one slot
+    struct SlotRow {
+        ScopedPointer<Label> number;
+        ScopedPointer<ComboBox> source;
+        ScopedPointer<ComboBox> destination;
+        ScopedPointer<Slider> amount;
+        ScopedPointer<ComboBox> curve;
+        ScopedPointer<ComboBox> polarity;
+    };
+
+    std::array<SlotRow, slotsPerPage> rows;
+    std::array<ScopedPointer<TextButton>, numPages> pageButtons;
+
+    int page = 0;
+    ModSlots::Data shownSlots; //!< the slots as the rows show them
+    //[/UserVariables]
+
+    //==============================================================================
+
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ModSlotsPanel)
+};
+
+//[EndFile] You can add extra defines here...
+//[/EndFile]
+
+#endif   // __JUCE_HEADER_EA56740566D5501D__
@@ -321,6 +321,12 @@ OscPanel::OscPanel (SynthParams &p, int oscillatorNumber)
     registerSaturnSource(trngAmount, widthModAmount1, &osc.shapeModSrc1, &osc.shapeModAmount1, 1);
     registerSaturnSource(trngAmount, widthModAmount2, &osc.shapeModSrc2, &osc.shapeModAmount2, 2);
 
+    registerLiveModulation(ctune1, static_cast<destinations>(DEST_OSC1_PI + oscillatorNumber));
+    registerLiveModulation(gain, static_cast<destinations>(DEST_OSC1_GAIN + oscillatorNumber));
+    registerLiveModulation(pan, static_cast<destinations>(DEST_OSC1_PAN + oscillatorNumber));
+    registerLiveModulation(pulsewidth, static_cast<destinations>(DEST_OSC1_PW + oscillatorNumber));
+    registerLiveModulation(trngAmount, static_cast<destinations>(DEST_OSC1_PW + oscillatorNumber));
+
     onOffSwitchChanged();
     //[/UserPreSize]
 
@@ -7,6 +7,7 @@
 #include "JuceHeader.h"
 #include "SynthParams.h"
 #include "MouseOverKnob.h"
+#include "EnvelopeCurve.h"
 #include "IncDecDropDown.h"
 #include "ModSourceBox.h"
 
@@ -166,6 +167,38 @@ protected:
 
     //=======================================================================================================================================
 
+    // the knob shows the modulation of the destination in the newest voice
+    void registerLiveModulation(MouseOverKnob *knob, destinations dest) {
+        liveModReg[knob] = dest;
+    }
+
+    // the curve shows the level of the envelope in the newest voice, 0 is the volume envelope
+    void registerLiveEnvelope(EnvelopeCurve *curve, int envelope) {
+        liveEnvReg[curve] = envelope;
+    }
+
+    // Callback function for the modulation the audio thread published since the last timer
+    void updateLiveModulation() {
+        if (liveModReg.empty() && liveEnvReg.empty()) {
+            return;
+        }
+
+        // all panels poll on the message thread, the first after a block takes the new values
+        params.modSnapshot.fetch();
+        const ModSnapshot::Values &values = params.modSnapshot.read();
+
+        for (auto knob2dest : liveModReg) {
+            const destinations d = knob2dest.second;
+            knob2dest.first->setLiveModulation(values.destinationUsed[d], values.destinations[d]);
+        }
+        for (auto curve2env : liveEnvReg) {
+            const int e = curve2env.second;
+            curve2env.first->setLevel(values.envUsed[e] ? values.env[e] : -1.f);
+        }
+    }
+
+    //=======================================================================================================================================
+
     void registerToggle(Button* toggle, ParamStepped<eOnOffToggle>* p, const tHookFn hook = tHookFn())
     {
         toggleReg[toggle] = p;
@@ -337,7 +370,7 @@ protected:
         auto it = comboboxReg.find(comboboxThatWasChanged);
         if (it != comboboxReg.end()) {
             // we gotta subtract 2 from the item id since the combobox ids start at 1 and the sources enum starts at -1
-            params.globalModMatrix.changeSource(it->second->prefix()+" "+comboboxThatWasChanged->getName(), static_cast<eModSource>(comboboxThatWasChanged->getSelectedId() - COMBO_OFS));
+            params.globalModMatrix.changeSource(it->second, static_cast<eModSource>(comboboxThatWasChanged->getSelectedId() - COMBO_OFS));
             // we gotta subtract 1 from the item id since the combobox ids start at 1 and the eModSources enum starts at 0
             it->second->setStep(static_cast<eModSource>(it->first->getSelectedId() - COMBO_OFS));
 
@@ -407,6 +440,7 @@ protected:
     {
         updateDirtySliders();
         updateDirtySaturns();
+        updateLiveModulation();
         updateDirtyBoxes();
         updateDirtyNoteLength();
         updateDirtyDropDowns();
@@ -447,5 +481,7 @@ protected:
     std::map<ComboBox*, Param*> dropDownReg;
     std::map<MouseOverKnob*, std::array<Slider*, 2>> saturnReg; // 2 for each mod amount
     std::map<ComboBox*, std::array<MouseOverKnob*, 3>> saturnSourceReg; // there are up to 3, because of the ADR
+    std::map<MouseOverKnob*, destinations> liveModReg;
+    std::map<EnvelopeCurve*, int> liveEnvReg;
     SynthParams &params;
 };
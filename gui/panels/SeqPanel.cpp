@@ -24,6 +24,9 @@
 
 
 //[MiscUserDefs] You can add your own user definitions and misc code here...
+namespace {
+    const int numPages = SeqPattern::maxSteps / 8;
+}
 //[/MiscUserDefs]
 
 //==============================================================================
@@ -247,6 +250,12 @@ SeqPanel::SeqPanel (SynthParams &p)
     seqNumSteps->addItem (TRANS("6"), 6);
     seqNumSteps->addItem (TRANS("7"), 7);
     seqNumSteps->addItem (TRANS("8"), 8);
+    seqNumSteps->addItem (TRANS("12"), 9);
+    seqNumSteps->addItem (TRANS("16"), 10);
+    seqNumSteps->addItem (TRANS("24"), 11);
+    seqNumSteps->addItem (TRANS("32"), 12);
+    seqNumSteps->addItem (TRANS("48"), 13);
+    seqNumSteps->addItem (TRANS("64"), 14);
     seqNumSteps->addListener (this);
 
     addAndMakeVisible (labelSeqSpeed = new Label ("new seq speed",
@@ -307,6 +316,27 @@ SeqPanel::SeqPanel (SynthParams &p)
     dottedNotes->addListener (this);
     dottedNotes->setColour (ToggleButton::textColourId, Colours::white);
 
+    addAndMakeVisible (seqLane = new IncDecDropDown ("seq lane"));
+    seqLane->setEditableText (false);
+    seqLane->setJustificationType (Justification::centred);
+    seqLane->setTextWhenNothingSelected (TRANS("Lane"));
+    seqLane->setTextWhenNoChoicesAvailable (TRANS("(no choices)"));
+    seqLane->addItem (TRANS("note"), 1);
+    seqLane->addItem (TRANS("velocity"), 2);
+    seqLane->addItem (TRANS("gate"), 3);
+    seqLane->addItem (TRANS("probability"), 4);
+    seqLane->addItem (TRANS("mod"), 5);
+    seqLane->addListener (this);
+
+    addAndMakeVisible (labelSeqLane = new Label ("new seq lane",
+                                                 TRANS("edit lane")));
+    labelSeqLane->setFont (Font ("Bauhaus LightA", 18.00f, Font::plain));
+    labelSeqLane->setJustificationType (Justification::centredLeft);
+    labelSeqLane->setEditable (false, false, false);
+    labelSeqLane->setColour (Label::textColourId, Colours::white);
+    labelSeqLane->setColour (TextEditor::textColourId, Colours::black);
+    labelSeqLane->setColour (TextEditor::backgroundColourId, Colour (0x00000000));
+
 
     //[UserPreSize]
     // save some params, sliders and buttons in arrays for easier access
@@ -346,11 +376,31 @@ SeqPanel::SeqPanel (SynthParams &p)
                          labelButton7.get(),
                          labelButton8.get() };
 
+    // the step sliders and labels are not registered, they show the page and lane selected below
     for (int i = 0; i < 8; ++i)
     {
-        registerSlider(seqStepArray[i], currMidiStepSeq[i], std::bind(&SeqPanel::updateNoteNameLabels, this));
-        registerToggle(labelButtonArray[i], currStepOnOff[i]);
+        seqStepArray[i]->setScrollWheelEnabled(false);
+    }
+
+    for (int i = 0; i < numPages; ++i)
+    {
+        TextButton* pageButton = new TextButton ("page " + String(i + 1));
+        addAndMakeVisible (pageButton);
+        pageButton->setButtonText (String(i * 8 + 1));
+        pageButton->setConnectedEdges (Button::ConnectedOnLeft | Button::ConnectedOnRight);
+        pageButton->setClickingTogglesState (true);
+        pageButton->setRadioGroupId (1);
+        pageButton->addListener (this);
+        pageButton->setColour (TextButton::buttonColourId, Colours::white);
+        pageButton->setColour (TextButton::buttonOnColourId, Colours::grey);
+        pageButton->setColour (TextButton::textColourOnId, Colours::white);
+        pageButton->setColour (TextButton::textColourOffId, Colours::grey);
+        pageButtons[i] = pageButton;
     }
+
+    seqLane->setSelectedId(static_cast<int>(lane) + 1, dontSendNotification);
+    showPage(0);
+
     registerSlider(playModes, &params.seqPlayMode);
     registerSlider(randomSeq, &params.seqPlaceHolder, std::bind(&SeqPanel::updateMinMaxLabels, this), &params.seqRandomMin, &params.seqRandomMax);
 
@@ -388,6 +438,10 @@ SeqPanel::~SeqPanel()
     }
     currMidiStepSeq = { nullptr };
     currStepOnOff = { nullptr };
+    for (ScopedPointer<TextButton>& pageButton : pageButtons)
+    {
+        pageButton = nullptr;
+    }
     //[/Destructor_pre]
 
     seqStep1 = nullptr;
@@ -423,6 +477,8 @@ SeqPanel::~SeqPanel()
     loadSeq = nullptr;
     playModes = nullptr;
     dottedNotes = nullptr;
+    seqLane = nullptr;
+    labelSeqLane = nullptr;
 
 
     //[Destructor]. You can add your own custom destruction code here..
@@ -447,10 +503,7 @@ void SeqPanel::paint (Graphics& g)
 void SeqPanel::resized()
 {
     //[UserPreResize] Add your own custom resize code here..
-    for (int i = 0; i < 8; ++i)
-    {
-        labelButtonArray[i]->setToggleState(currStepOnOff[i]->getStep() == eOnOffToggle::eOn, dontSendNotification);
-    }
+    updateSteps();
 
     seqPlay->setToggleState(isPlaying(), dontSendNotification);
     syncHost->setToggleState(params.seqPlaySyncHost.getStep() == eOnOffToggle::eOn, dontSendNotification);
@@ -464,24 +517,24 @@ void SeqPanel::resized()
     randomSeq->setMinAndMaxValues(params.seqRandomMin.get(), params.seqRandomMax.get());
     //[/UserPreResize]
 
-    seqStep1->setBounds (452, 68, 40, 210);
-    seqStep2->setBounds (492, 68, 40, 210);
-    seqStep3->setBounds (532, 68, 40, 210);
-    seqStep4->setBounds (572, 68, 40, 210);
-    seqStep5->setBounds (612, 68, 40, 210);
-    seqStep6->setBounds (652, 68, 40, 210);
-    seqStep7->setBounds (692, 68, 40, 210);
-    seqStep8->setBounds (732, 68, 40, 210);
+    seqStep1->setBounds (452, 92, 40, 186);
+    seqStep2->setBounds (492, 92, 40, 186);
+    seqStep3->setBounds (532, 92, 40, 186);
+    seqStep4->setBounds (572, 92, 40, 186);
+    seqStep5->setBounds (612, 92, 40, 186);
+    seqStep6->setBounds (652, 92, 40, 186);
+    seqStep7->setBounds (692, 92, 40, 186);
+    seqStep8->setBounds (732, 92, 40, 186);
     seqPlay->setBounds (55, 6, 60, 21);
     syncHost->setBounds (326, 53, 64, 30);
-    labelButton1->setBounds (448, 42, 48, 24);
-    labelButton2->setBounds (488, 42, 48, 24);
-    labelButton3->setBounds (528, 42, 48, 24);
-    labelButton4->setBounds (568, 42, 48, 24);
-    labelButton5->setBounds (608, 42, 48, 24);
-    labelButton6->setBounds (648, 42, 48, 24);
-    labelButton7->setBounds (688, 42, 48, 24);
-    labelButton8->setBounds (728, 42, 48, 24);
+    labelButton1->setBounds (448, 66, 48, 24);
+    labelButton2->setBounds (488, 66, 48, 24);
+    labelButton3->setBounds (528, 66, 48, 24);
+    labelButton4->setBounds (568, 66, 48, 24);
+    labelButton5->setBounds (608, 66, 48, 24);
+    labelButton6->setBounds (648, 66, 48, 24);
+    labelButton7->setBounds (688, 66, 48, 24);
+    labelButton8->setBounds (728, 66, 48, 24);
     genRandom->setBounds (104, 219, 176, 21);
     randomSeq->setBounds (40, 236, 300, 50);
     randMinLabel->setBounds (24, 212, 80, 36);
@@ -497,7 +550,13 @@ void SeqPanel::resized()
     loadSeq->setBounds (181, 6, 60, 21);
     playModes->setBounds (328, 180, 64, 24);
     dottedNotes->setBounds (326, 121, 64, 30);
+    seqLane->setBounds (142, 180, 98, 28);
+    labelSeqLane->setBounds (33, 184, 103, 20);
     //[UserResized] Add your own custom resize handling here..
+    for (int i = 0; i < numPages; ++i)
+    {
+        pageButtons[i]->setBounds (452 + i * 40, 38, 40, 22);
+    }
     //[/UserResized]
 }
 
@@ -505,6 +564,14 @@ void SeqPanel::sliderValueChanged (Slider* sliderThatWasMoved)
 {
     //[UsersliderValueChanged_Pre]
         handleSlider(sliderThatWasMoved);
+        for (int i = 0; i < 8; ++i)
+        {
+            if (sliderThatWasMoved == seqStepArray[i])
+            {
+                setStepValue(i, roundToInt(sliderThatWasMoved->getValue()));
+                updateSteps();
+            }
+        }
     //[/UsersliderValueChanged_Pre]
 
     if (sliderThatWasMoved == seqStep1)
@@ -569,6 +636,21 @@ void SeqPanel::buttonClicked (Button* buttonThatWasClicked)
     {
         handleToggle(buttonThatWasClicked);
     }
+    for (int i = 0; i < 8; ++i)
+    {
+        if (buttonThatWasClicked == labelButtonArray[i])
+        {
+            setStepActive(i, !isStepActive(i));
+            updateSteps();
+        }
+    }
+    for (int i = 0; i < numPages; ++i)
+    {
+        if (buttonThatWasClicked == pageButtons[i])
+        {
+            showPage(i);
+        }
+    }
     //[/UserbuttonClicked_Pre]
 
     if (buttonThatWasClicked == seqPlay)
@@ -641,10 +723,15 @@ void SeqPanel::buttonClicked (Button* buttonThatWasClicked)
         float max = params.seqRandomMax.get();
         Random r = Random();
 
-        for (int i = 0; i < 8; ++i)
+        r.setSeedRandomly();
+        for (int i = 0; i < SeqPattern::maxSteps; ++i)
         {
-            r.setSeedRandomly();
-            currMidiStepSeq[i]->set(r.nextFloat() * (max - min) + min, true);
+            const float note = r.nextFloat() * (max - min) + min;
+            if (i < 8)
+            {
+                currMidiStepSeq[i]->set(note, true);
+            }
+            params.seqPattern.setValue(i, SeqPattern::eNote, static_cast<int>(note));
         }
         //[/UserButtonCode_genRandom]
     }
@@ -711,8 +798,22 @@ void SeqPanel::comboBoxChanged (ComboBox* comboBoxThatHasChanged)
     else if (comboBoxThatHasChanged == seqNumSteps)
     {
         //[UserComboBoxCode_seqNumSteps] -- add your combo box handling code here..
+        updateSteps();
         //[/UserComboBoxCode_seqNumSteps]
     }
+    else if (comboBoxThatHasChanged == seqLane)
+    {
+        //[UserComboBoxCode_seqLane] -- add your combo box handling code here..
+        lane = static_cast<SeqPattern::eLane>(jlimit(0, SeqPattern::nLanes - 1, seqLane->getSelectedId() - 1));
+        for (int i = 0; i < 8; ++i)
+        {
+            seqStepArray[i]->setRange(SeqPattern::getMinValue(lane), SeqPattern::getMaxValue(lane), 1);
+            // the mod lane is bipolar, a double click puts a step back to no modulation
+            seqStepArray[i]->setDoubleClickReturnValue(lane == SeqPattern::eMod, 0.0);
+        }
+        updateSteps();
+        //[/UserComboBoxCode_seqLane]
+    }
 
     //[UsercomboBoxChanged_Post]
     //[/UsercomboBoxChanged_Post]
@@ -728,16 +829,93 @@ void SeqPanel::updateToggleState()
     seqPlay->setEnabled(params.seqPlaySyncHost.getStep() == eOnOffToggle::eOff);
 }
 
-void SeqPanel::updateNoteNameLabels()
+void SeqPanel::showPage(int newPage)
 {
-    labelButton1->setButtonText(getStepNoteName(0, true, true, 3));
-    labelButton2->setButtonText(getStepNoteName(1, true, true, 3));
-    labelButton3->setButtonText(getStepNoteName(2, true, true, 3));
-    labelButton4->setButtonText(getStepNoteName(3, true, true, 3));
-    labelButton5->setButtonText(getStepNoteName(4, true, true, 3));
-    labelButton6->setButtonText(getStepNoteName(5, true, true, 3));
-    labelButton7->setButtonText(getStepNoteName(6, true, true, 3));
-    labelButton8->setButtonText(getStepNoteName(7, true, true, 3));
+    page = jlimit(0, numPages - 1, newPage);
+    pageButtons[page]->setToggleState(true, dontSendNotification);
+    lastSeqNotePos = -1;
+    for (int i = 0; i < 8; ++i)
+    {
+        seqStepArray[i]->setColour(Slider::thumbColourId, Colours::grey);
+    }
+    updateSteps();
+}
+
+void SeqPanel::updateSteps()
+{
+    const int numSteps = static_cast<int>(params.seqNumSteps.get());
+    for (int i = 0; i < 8; ++i)
+    {
+        const int value = getStepValue(i);
+        if (roundToInt(seqStepArray[i]->getValue()) != value)
+        {
+            seqStepArray[i]->setValue(value, dontSendNotification);
+        }
+
+        String text;
+        switch (lane)
+        {
+            case SeqPattern::eNote:
+                text = getStepNoteName(i, true, true, 3);
+                break;
+            case SeqPattern::eMod:
+                text = (value > 0 ? "+" : "") + String(value);
+                break;
+            default:
+                text = String(value);
+                break;
+        }
+        if (labelButtonArray[i]->getButtonText() != text)
+        {
+            labelButtonArray[i]->setButtonText(text);
+        }
+        labelButtonArray[i]->setToggleState(isStepActive(i), dontSendNotification);
+
+        // steps behind the sequence length are not played
+        seqStepArray[i]->setAlpha(page * 8 + i < numSteps ? 1.0f : 0.5f);
+    }
+}
+
+int SeqPanel::getStepValue(int step) const
+{
+    if (page == 0 && lane == SeqPattern::eNote)
+    {
+        return static_cast<int>(currMidiStepSeq[step]->get());
+    }
+    return params.seqPattern.getValue(page * 8 + step, lane);
+}
+
+void SeqPanel::setStepValue(int step, int value)
+{
+    if (page == 0 && lane == SeqPattern::eNote)
+    {
+        currMidiStepSeq[step]->setUI(static_cast<float>(value));
+    }
+    else
+    {
+        params.seqPattern.setValue(page * 8 + step, lane, value);
+    }
+}
+
+bool SeqPanel::isStepActive(int step) const
+{
+    if (page == 0)
+    {
+        return currStepOnOff[step]->getStep() == eOnOffToggle::eOn;
+    }
+    return params.seqPattern.isActive(page * 8 + step);
+}
+
+void SeqPanel::setStepActive(int step, bool active)
+{
+    if (page == 0)
+    {
+        currStepOnOff[step]->setStep(active ? eOnOffToggle::eOn : eOnOffToggle::eOff);
+    }
+    else
+    {
+        params.seqPattern.setActive(page * 8 + step, active);
+    }
 }
 
 void SeqPanel::updateMinMaxLabels()
@@ -767,15 +945,17 @@ void SeqPanel::timerCallback()
         if (lastSeqNotePos != static_cast<int>(params.seqLastPlayedStep.get()))
         {
             seqPlay->setToggleState(isPlaying(), dontSendNotification);
-            // colour current playing seqNote slider
+            // colour current playing seqNote slider if it is on the shown page
             for (int i = 0; i < 8; ++i)
             {
                 seqStepArray[i]->setColour(Slider::thumbColourId, Colours::grey);
             }
 
             lastSeqNotePos = static_cast<int>(params.seqLastPlayedStep.get());
-            lastSeqNotePos = jmax(0, jmin(lastSeqNotePos, 7));
-            seqStepArray[lastSeqNotePos]->setColour(Slider::thumbColourId, Colour(0xff60ff60));
+            if (lastSeqNotePos >= 0 && lastSeqNotePos / 8 == page)
+            {
+                seqStepArray[lastSeqNotePos % 8]->setColour(Slider::thumbColourId, Colour(0xff60ff60));
+            }
         }
     }
     else
@@ -784,10 +964,12 @@ void SeqPanel::timerCallback()
         if (lastSeqNotePos != -1)
         {
             seqPlay->setToggleState(isPlaying(), dontSendNotification);
-            seqStepArray.at(lastSeqNotePos)->setColour(Slider::thumbColourId, Colours::grey);
+            seqStepArray.at(jmax(0, lastSeqNotePos) % 8)->setColour(Slider::thumbColourId, Colours::grey);
             lastSeqNotePos = -1;
         }
     }
+    // the params of the first page, patches and the randomizer change the steps outside the panel
+    updateSteps();
     PanelBase::timerCallback();
 }
 
@@ -807,7 +989,9 @@ bool SeqPanel::isPlaying()
 
 String SeqPanel::getStepNoteName(int step, bool sharps, bool octaveNumber, int middleC)
 {
-    return MidiMessage::getMidiNoteName(static_cast<int>(currMidiStepSeq[jmax(0, jmin(step, 7))]->get()), sharps, octaveNumber, middleC);
+    step = jmax(0, jmin(step, 7));
+    const int note = (page == 0) ? static_cast<int>(currMidiStepSeq[step]->get()) : params.seqPattern.getValue(page * 8 + step, SeqPattern::eNote);
+    return MidiMessage::getMidiNoteName(note, sharps, octaveNumber, middleC);
 }
 //[/MiscUserCode]
 
@@ -828,42 +1012,42 @@ BEGIN_JUCER_METADATA
                  initialHeight="300">
   <BACKGROUND backgroundColour="ff564c43"/>
   <SLIDER name="Step 1" id="1c1677034c4af23a" memberName="seqStep1" virtualName="Slider"
-          explicitFocusOrder="0" pos="452 68 40 210" thumbcol="ff808080"
+          explicitFocusOrder="0" pos="452 92 40 186" thumbcol="ff808080"
           trackcol="ffffffff" min="0" max="127" int="1" style="LinearVertical"
           textBoxPos="NoTextBox" textBoxEditable="1" textBoxWidth="80"
           textBoxHeight="20" skewFactor="1"/>
   <SLIDER name="Step 2" id="e3931793046ce084" memberName="seqStep2" virtualName="Slider"
-          explicitFocusOrder="0" pos="492 68 40 210" thumbcol="ff808080"
+          explicitFocusOrder="0" pos="492 92 40 186" thumbcol="ff808080"
           trackcol="ffffffff" min="0" max="127" int="1" style="LinearVertical"
           textBoxPos="NoTextBox" textBoxEditable="1" textBoxWidth="80"
           textBoxHeight="20" skewFactor="1"/>
   <SLIDER name="Step 3" id="5e31094656fb49f9" memberName="seqStep3" virtualName="Slider"
-          explicitFocusOrder="0" pos="532 68 40 210" thumbcol="ff808080"
+          explicitFocusOrder="0" pos="532 92 40 186" thumbcol="ff808080"
           trackcol="ffffffff" min="0" max="127" int="1" style="LinearVertical"
           textBoxPos="NoTextBox" textBoxEditable="1" textBoxWidth="80"
           textBoxHeight="20" skewFactor="1"/>
   <SLIDER name="Step 4" id="7025db78c8ff10d4" memberName="seqStep4" virtualName="Slider"
-          explicitFocusOrder="0" pos="572 68 40 210" thumbcol="ff808080"
+          explicitFocusOrder="0" pos="572 92 40 186" thumbcol="ff808080"
           trackcol="ffffffff" min="0" max="127" int="1" style="LinearVertical"
           textBoxPos="NoTextBox" textBoxEditable="1" textBoxWidth="80"
           textBoxHeight="20" skewFactor="1"/>
   <SLIDER name="Step 5" id="9eba062111540687" memberName="seqStep5" virtualName="Slider"
-          explicitFocusOrder="0" pos="612 68 40 210" thumbcol="ff808080"
+          explicitFocusOrder="0" pos="612 92 40 186" thumbcol="ff808080"
           trackcol="ffffffff" min="0" max="127" int="1" style="LinearVertical"
           textBoxPos="NoTextBox" textBoxEditable="1" textBoxWidth="80"
           textBoxHeight="20" skewFactor="1"/>
   <SLIDER name="Step 6" id="6a53245b0ddd1528" memberName="seqStep6" virtualName="Slider"
-          explicitFocusOrder="0" pos="652 68 40 210" thumbcol="ff808080"
+          explicitFocusOrder="0" pos="652 92 40 186" thumbcol="ff808080"
           trackcol="ffffffff" min="0" max="127" int="1" style="LinearVertical"
           textBoxPos="NoTextBox" textBoxEditable="1" textBoxWidth="80"
           textBoxHeight="20" skewFactor="1"/>
   <SLIDER name="Step 7" id="96cbc5e8f38bf170" memberName="seqStep7" virtualName="Slider"
-          explicitFocusOrder="0" pos="692 68 40 210" thumbcol="ff808080"
+          explicitFocusOrder="0" pos="692 92 40 186" thumbcol="ff808080"
           trackcol="ffffffff" min="0" max="127" int="1" style="LinearVertical"
           textBoxPos="NoTextBox" textBoxEditable="1" textBoxWidth="80"
           textBoxHeight="20" skewFactor="1"/>
   <SLIDER name="Step 8" id="ee7a391120a49428" memberName="seqStep8" virtualName="Slider"
-          explicitFocusOrder="0" pos="732 68 40 210" thumbcol="ff808080"
+          explicitFocusOrder="0" pos="732 92 40 186" thumbcol="ff808080"
           trackcol="ffffffff" min="0" max="127" int="1" style="LinearVertical"
           textBoxPos="NoTextBox" textBoxEditable="1" textBoxWidth="80"
           textBoxHeight="20" skewFactor="1"/>
@@ -876,35 +1060,35 @@ BEGIN_JUCER_METADATA
                 buttonText="" connectedEdges="0" needsCallback="1" radioGroupId="0"
                 state="0"/>
   <TEXTBUTTON name="label button 1" id="ecf21a7d0b29e004" memberName="labelButton1"
-              virtualName="" explicitFocusOrder="0" pos="448 42 48 24" bgColOff="ffffff"
+              virtualName="" explicitFocusOrder="0" pos="448 66 48 24" bgColOff="ffffff"
               bgColOn="ffffff" textCol="ffffffff" textColOn="ff808080" buttonText="C3"
               connectedEdges="0" needsCallback="1" radioGroupId="0"/>
   <TEXTBUTTON name="label button 2" id="f176b3ba0f847a7b" memberName="labelButton2"
-              virtualName="" explicitFocusOrder="0" pos="488 42 48 24" bgColOff="ffffff"
+              virtualName="" explicitFocusOrder="0" pos="488 66 48 24" bgColOff="ffffff"
               bgColOn="ffffff" textCol="ffffffff" textColOn="ff808080" buttonText="D3"
               connectedEdges="0" needsCallback="1" radioGroupId="0"/>
   <TEXTBUTTON name="label button 3" id="ed69d74dab8d903d" memberName="labelButton3"
-              virtualName="" explicitFocusOrder="0" pos="528 42 48 24" bgColOff="ffffff"
+              virtualName="" explicitFocusOrder="0" pos="528 66 48 24" bgColOff="ffffff"
               bgColOn="ffffff" textCol="ffffffff" textColOn="ff808080" buttonText="E3"
               connectedEdges="0" needsCallback="1" radioGroupId="0"/>
   <TEXTBUTTON name="label button 4" id="c0408fb512684153" memberName="labelButton4"
-              virtualName="" explicitFocusOrder="0" pos="568 42 48 24" bgColOff="ffffff"
+              virtualName="" explicitFocusOrder="0" pos="568 66 48 24" bgColOff="ffffff"
               bgColOn="ffffff" textCol="ffffffff" textColOn="ff808080" buttonText="F3"
               connectedEdges="0" needsCallback="1" radioGroupId="0"/>
   <TEXTBUTTON name="label button 5" id="f0140e4ed4b41b2a" memberName="labelButton5"
-              virtualName="" explicitFocusOrder="0" pos="608 42 48 24" bgColOff="ffffff"
+              virtualName="" explicitFocusOrder="0" pos="608 66 48 24" bgColOff="ffffff"
               bgColOn="ffffff" textCol="ffffffff" textColOn="ff808080" buttonText="G3"
               connectedEdges="0" needsCallback="1" radioGroupId="0"/>
   <TEXTBUTTON name="label button 6" id="15c066479eacbaf" memberName="labelButton6"
-              virtualName="" explicitFocusOrder="0" pos="648 42 48 24" bgColOff="ffffff"
+              virtualName="" explicitFocusOrder="0" pos="648 66 48 24" bgColOff="ffffff"
               bgColOn="ffffff" textCol="ffffffff" textColOn="ff808080" buttonText="A3"
               connectedEdges="0" needsCallback="1" radioGroupId="0"/>
   <TEXTBUTTON name="label button 7" id="eb21806a70e68ca" memberName="labelButton7"
-              virtualName="" explicitFocusOrder="0" pos="688 42 48 24" bgColOff="ffffff"
+              virtualName="" explicitFocusOrder="0" pos="688 66 48 24" bgColOff="ffffff"
               bgColOn="ffffff" textCol="ffffffff" textColOn="ff808080" buttonText="B3"
               connectedEdges="0" needsCallback="1" radioGroupId="0"/>
   <TEXTBUTTON name="label button 8" id="5cecbbfbc28cd4a8" memberName="labelButton8"
-              virtualName="" explicitFocusOrder="0" pos="728 42 48 24" bgColOff="ffffff"
+              virtualName="" explicitFocusOrder="0" pos="728 66 48 24" bgColOff="ffffff"
               bgColOn="ffffff" textCol="ffffffff" textColOn="ff808080" buttonText="C4"
               connectedEdges="0" needsCallback="1" radioGroupId="0"/>
   <TEXTBUTTON name="generate random" id="bb20cf6f1f73eff1" memberName="genRandom"
@@ -936,7 +1120,7 @@ BEGIN_JUCER_METADATA
             textWhenNonSelected="Step Length" textWhenNoItems="(no choices)"/>
   <COMBOBOX name="seq num steps" id="cc5278e8668913e9" memberName="seqNumSteps"
             virtualName="IncDecDropDown" explicitFocusOrder="0" pos="142 59 98 28"
-            editable="0" layout="36" items="1&#10;2&#10;3&#10;4&#10;5&#10;6&#10;7&#10;8"
+            editable="0" layout="36" items="1&#10;2&#10;3&#10;4&#10;5&#10;6&#10;7&#10;8&#10;12&#10;16&#10;24&#10;32&#10;48&#10;64"
             textWhenNonSelected="Num Steps" textWhenNoItems="(no choices)"/>
   <LABEL name="new seq speed" id="af187074393a392a" memberName="labelSeqSpeed"
          virtualName="" explicitFocusOrder="0" pos="33 106 103 20" textCol="ffffffff"
@@ -973,6 +1157,15 @@ BEGIN_JUCER_METADATA
                 virtualName="" explicitFocusOrder="0" pos="326 121 64 30" txtcol="ffffffff"
                 buttonText="" connectedEdges="0" needsCallback="1" radioGroupId="0"
                 state="0"/>
+  <COMBOBOX name="seq lane" id="3d6f0c2e9a51b874" memberName="seqLane"
+            virtualName="IncDecDropDown" explicitFocusOrder="0" pos="142 180 98 28"
+            editable="0" layout="36" items="note&#10;velocity&#10;gate&#10;probability&#10;mod"
+            textWhenNonSelected="Lane" textWhenNoItems="(no choices)"/>
+  <LABEL name="new seq lane" id="b18e4a7c05d2f963" memberName="labelSeqLane"
+         virtualName="" explicitFocusOrder="0" pos="33 184 103 20" textCol="ffffffff"
+         edTextCol="ff000000" edBkgCol="0" labelText="edit lane" editableSingleClick="0"
+         editableDoubleClick="0" focusDiscardsChanges="0" fontname="Bauhaus LightA"
+         fontsize="18" bold="0" italic="0" justification="33"/>
 </JUCER_COMPONENT>
 
 END_JUCER_METADATA
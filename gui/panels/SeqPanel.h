@@ -48,7 +48,6 @@ public:
     //==============================================================================
     //[UserMethods]     -- You can add your own custom methods in this section.
     void updateToggleState();
-    void updateNoteNameLabels();
     void updateMinMaxLabels();
     void drawPics(Graphics& g, ScopedPointer<Slider>& seqPlayMode, ScopedPointer<ToggleButton>& syncT, ScopedPointer<ToggleButton>& tripletT, ScopedPointer<ToggleButton>& dotT);
 
@@ -62,6 +61,27 @@ public:
     */
     bool isPlaying();
 
+    /**
+    * Show eight steps of the pattern in the sliders.
+    @param newPage in range [0..7], the page shows the steps [newPage * 8 .. newPage * 8 + 7]
+    */
+    void showPage(int newPage);
+
+    /**
+    * Set sliders and labels to the shown steps of the selected lane.
+    */
+    void updateSteps();
+
+    /**
+    * Value of a shown step in the selected lane. The notes and on/off of the first page
+    * are params, everything else lives in the pattern only.
+    @param step in range [0..7]
+    */
+    int getStepValue(int step) const;
+    void setStepValue(int step, int value);
+    bool isStepActive(int step) const;
+    void setStepActive(int step, bool active);
+
     /**
     * Get the note name as a string of a specific step by using MidiMessage::getMidiNoteName().
     @param step in range [0..7]
@@ -89,8 +109,11 @@ private:
 
     std::array<Param*, 8> currMidiStepSeq;
     std::array<ParamStepped<eOnOffToggle>*, 8> currStepOnOff;
+    std::array<ScopedPointer<TextButton>, SeqPattern::maxSteps / 8> pageButtons;
 
     int lastSeqNotePos = -1;
+    int page = 0;
+    SeqPattern::eLane lane = SeqPattern::eNote;
     //[/UserVariables]
 
     //==============================================================================
@@ -127,6 +150,8 @@ private:
     ScopedPointer<TextButton> loadSeq;
     ScopedPointer<Slider> playModes;
     ScopedPointer<ToggleButton> dottedNotes;
+    ScopedPointer<IncDecDropDown> seqLane;
+    ScopedPointer<Label> labelSeqLane;
 
 
     //==============================================================================
@@ -13,9 +13,85 @@
 #define JucePlugin_MaxNumInputChannels 0
 #define JucePlugin_MaxNumOutputChannels 2
 #include "../../juce/modules/juce_audio_plugin_client/Standalone/juce_StandaloneFilterWindow.h"
+#include "RealtimeGuard.h"
 
 Component* createMainContentComponent();
 
+namespace {
+    //! creates, prepares and deletes synth instances and prints the mean times per instance
+    void runInstantiationBenchmark(int numInstances)
+    {
+        OwnedArray<AudioProcessor> instances;
+        instances.ensureStorageAllocated(numInstances);
+
+        double start = Time::getMillisecondCounterHiRes();
+        for (int i = 0; i < numInstances; ++i) {
+            instances.add(createPluginFilter());
+        }
+        const double constructMs = Time::getMillisecondCounterHiRes() - start;
+
+        start = Time::getMillisecondCounterHiRes();
+        for (AudioProcessor* p : instances) {
+            p->setPlayConfigDetails(0, 2, 44100., 512);
+            p->prepareToPlay(44100., 512);
+        }
+        const double prepareMs = Time::getMillisecondCounterHiRes() - start;
+
+        start = Time::getMillisecondCounterHiRes();
+        instances.clear();
+        const double deleteMs = Time::getMillisecondCounterHiRes() - start;
+
+        std::printf("%d instances, per instance: construct %.3f ms, prepare %.3f ms, delete %.3f ms\n", numInstances,
+                    constructMs / numInstances, prepareMs / numInstances, deleteMs / numInstances);
+    }
+
+    //! plays notes, controllers, program and param changes through one instance, returns the exit code
+    int runRealtimeCheck(int numBlocks)
+    {
+#if SYNISTER_REALTIME_CHECKS
+        const int blockSize = 512;
+        const ScopedPointer<AudioProcessor> synth = createPluginFilter();
+        synth->setPlayConfigDetails(0, 2, 44100., blockSize);
+        synth->prepareToPlay(44100., blockSize);
+
+        AudioSampleBuffer buffer(2, blockSize);
+        MidiBuffer midi;
+        const int violationsBefore = RealtimeGuard::getNumViolations();
+        for (int b = 0; b < numBlocks; ++b) {
+            midi.clear();
+            const int note = 36 + (b * 7) % 48;
+            midi.addEvent(MidiMessage::noteOn(1, note, 0.8f), b % blockSize);
+            midi.addEvent(MidiMessage::noteOff(1, note - 7), (b * 3) % blockSize);
+            midi.addEvent(MidiMessage::pitchWheel(1, (b * 97) % 16384), 17);
+            midi.addEvent(MidiMessage::controllerEvent(1, 1, b % 128), 100);
+            if (b % 50 == 0) {
+                midi.addEvent(MidiMessage::programChange(1, (b / 50) % 4), 0);
+            }
+            if (b % 10 == 0) {
+                // host automation between the blocks
+                const int param = (b / 10) % synth->getNumParameters();
+                synth->setParameter(param, static_cast<float>(b % 7) / 6.f);
+            }
+            buffer.clear();
+            synth->processBlock(buffer, midi);
+            if (b % 20 == 0) {
+                // lets the message thread complete program changes and other deferred work
+                MessageManager::getInstance()->runDispatchLoopUntil(1);
+            }
+        }
+        synth->releaseResources();
+
+        const int violations = RealtimeGuard::getNumViolations() - violationsBefore;
+        std::printf("realtime check: %d blocks, %d violations\n", numBlocks, violations);
+        return violations == 0 ? 0 : 1;
+#else
+        ignoreUnused(numBlocks);
+        std::printf("realtime check: this build has no SYNISTER_REALTIME_CHECKS\n");
+        return 2;
+#endif
+    }
+}
+
 //==============================================================================
 class StandaloneApplication  : public JUCEApplication
 {
@@ -30,7 +106,25 @@ public:
     //==============================================================================
     void initialise (const String& commandLine) override
     {
-        ignoreUnused(commandLine);
+        // --benchmark-instantiation [n]: measure how long opening n instances takes, then quit
+        const StringArray args = StringArray::fromTokens(commandLine, true);
+        const int benchmarkArg = args.indexOf("--benchmark-instantiation");
+        if (benchmarkArg >= 0) {
+            const int numInstances = args[benchmarkArg + 1].getIntValue();
+            runInstantiationBenchmark(numInstances > 0 ? numInstances : 100);
+            quit();
+            return;
+        }
+
+        // --realtime-check [blocks]: renders a scripted scenario, exits with 1 on an allocation or lock on the audio thread
+        const int realtimeArg = args.indexOf("--realtime-check");
+        if (realtimeArg >= 0) {
+            const int numBlocks = args[realtimeArg + 1].getIntValue();
+            setApplicationReturnValue(runRealtimeCheck(numBlocks > 0 ? numBlocks : 2000));
+            quit();
+            return;
+        }
+
         // This method is where you should put your application's initialisation code..
         
         mainWindow = new StandaloneFilterWindow(getApplicationName(),Colours::black,nullptr,false);